@@ -29,6 +29,7 @@ macro(run_conan)
             assimp/5.0.1
             glfw/3.3.2
             imgui/1.76
+            zstd/1.4.5
             OPTIONS
             ${CONAN_EXTRA_OPTIONS}
             BASIC_SETUP
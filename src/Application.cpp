@@ -37,10 +37,156 @@ void DestroyDebugUtilsMessengerEXT(VkInstance instance,
   }
 }
 
+namespace {
+
+// Vertex input for `format`. Binding 0 holds the vertices and binding 1 the
+// parts, one per instance; split streams take bindings 0 and 1 and move the
+// parts to SPLIT_PART_BINDING. With positionOnly, only location 0 and the
+// parts are described, and split streams leave binding 1 out altogether.
+void describeVertexInput(
+    VertexFormat format, bool positionOnly,
+    std::vector<VkVertexInputBindingDescription>& bindings,
+    std::vector<VkVertexInputAttributeDescription>& attributes) {
+  bindings.clear();
+  attributes.clear();
+  uint32_t partBinding = 1;
+  switch (format) {
+    case VertexFormat::Full: {
+      bindings.push_back(Vertex::getBindingDescription());
+      const auto vertex = Vertex::getAttributeDescriptions();
+      attributes.assign(vertex.begin(), vertex.end());
+      break;
+    }
+    case VertexFormat::Compact: {
+      bindings.push_back(CompactVertex::getBindingDescription());
+      const auto vertex = CompactVertex::getAttributeDescriptions();
+      attributes.assign(vertex.begin(), vertex.end());
+      break;
+    }
+    case VertexFormat::Split: {
+      bindings.push_back(VertexPosition::getBindingDescription());
+      const auto position = VertexPosition::getAttributeDescriptions();
+      attributes.assign(position.begin(), position.end());
+      if (!positionOnly) {
+        bindings.push_back(VertexAttributes::getBindingDescription());
+        const auto rest = VertexAttributes::getAttributeDescriptions();
+        attributes.insert(attributes.end(), rest.begin(), rest.end());
+      }
+      partBinding = SPLIT_PART_BINDING;
+      break;
+    }
+  }
+  if (positionOnly) {
+    attributes.erase(
+        std::remove_if(attributes.begin(), attributes.end(),
+                       [](const VkVertexInputAttributeDescription& a) {
+                         return a.location != 0;
+                       }),
+        attributes.end());
+  }
+
+  bindings.push_back(MeshPart::getBindingDescription(partBinding));
+  const auto part = MeshPart::getAttributeDescriptions(partBinding);
+  attributes.insert(attributes.end(), part.begin(), part.end());
+}
+
+bool hasDeviceExtension(VkPhysicalDevice device, const std::string& name) {
+  uint32_t extensionCount = 0;
+  vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount,
+                                       nullptr);
+  std::vector<VkExtensionProperties> extensions(extensionCount);
+  vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount,
+                                       extensions.data());
+  return std::any_of(extensions.begin(), extensions.end(),
+                     [&name](const VkExtensionProperties& extension) {
+                       return name == extension.extensionName;
+                     });
+}
+
+// Whether `device` can hold the texture table: a partially bound,
+// update-after-bind array of MAX_BINDLESS_TEXTURES combined image samplers,
+// indexed per fragment. The instance does not enable
+// VK_KHR_get_physical_device_properties2, so the queries below need a
+// device of Vulkan 1.1 or later.
+bool supportsTextureTable(VkPhysicalDevice device) {
+  VkPhysicalDeviceProperties deviceProperties{};
+  vkGetPhysicalDeviceProperties(device, &deviceProperties);
+  if (deviceProperties.apiVersion < VK_API_VERSION_1_1 ||
+      !hasDeviceExtension(device, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME)) {
+    return false;
+  }
+  VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures{};
+  indexingFeatures.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+  VkPhysicalDeviceFeatures2 features{};
+  features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+  features.pNext = &indexingFeatures;
+  vkGetPhysicalDeviceFeatures2(device, &features);
+
+  VkPhysicalDeviceDescriptorIndexingProperties indexingProperties{};
+  indexingProperties.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+  VkPhysicalDeviceProperties2 properties{};
+  properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+  properties.pNext = &indexingProperties;
+  vkGetPhysicalDeviceProperties2(device, &properties);
+
+  const uint32_t limit = std::min(
+      {indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers,
+       indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+       indexingProperties.maxDescriptorSetUpdateAfterBindSamplers,
+       indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages});
+  return indexingFeatures.shaderSampledImageArrayNonUniformIndexing &&
+         indexingFeatures.descriptorBindingSampledImageUpdateAfterBind &&
+         indexingFeatures.descriptorBindingPartiallyBound &&
+         limit > MAX_BINDLESS_TEXTURES;
+}
+
+// Offset alignment of the streams in a staging buffer, enough for any of
+// their element types.
+constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+VkDeviceSize vertexBufferSize(const MeshView& mesh, VertexFormat format) {
+  if (format == VertexFormat::Compact) {
+    return sizeof(CompactVertex) * mesh.vertexCount;
+  }
+  if (format == VertexFormat::Split) {
+    return splitVerticesSize(mesh.vertexCount);
+  }
+  return sizeof(Vertex) * mesh.vertexCount;
+}
+
+// An upper bound on what uploading `mesh` stages, whatever the vertex format:
+// none is larger than Vertex, plus the padding between split streams.
+VkDeviceSize meshStagingSize(const MeshView& mesh) {
+  const std::array<VkDeviceSize, 4> streams{
+      VkDeviceSize{sizeof(Vertex)} * mesh.vertexCount + STAGING_ALIGNMENT,
+      VkDeviceSize{mesh.indexSize} * mesh.indexCount,
+      VkDeviceSize{sizeof(MeshPart)} * std::max(mesh.partCount, 1u),
+      VkDeviceSize{sizeof(Meshlet)} * mesh.meshletCount};
+  VkDeviceSize size{0};
+  for (VkDeviceSize stream : streams) {
+    size += stream + STAGING_ALIGNMENT;
+  }
+  return size;
+}
+
+// Whether a cached texture was cooked the way isAtlasCandidate() asks for:
+// as a tile exactly if it is small enough.
+bool isCookedForAtlas(const TextureView& texture) {
+  if (texture.contentWidth != 0) {
+    return isAtlasCandidate(texture.contentWidth, texture.contentHeight);
+  }
+  return !isAtlasCandidate(texture.width, texture.height);
+}
+
+}  // namespace
+
 void Application::run() {
   initWindow();
   initVulkan();
   initImGui();
+  watchAssets();
   mainLoop();
   cleanup();
 }
@@ -108,31 +254,125 @@ void Application::initWindow() {
 }
 
 void Application::initVulkan() {
-  createInstance();
-  setupDebugMessenger();
-  createSurface();
-  pickPhysicalDevice();
-  createLogicalDevice();
-  createSwapChain();
-  createImageViews();
-  createRenderPass();
-  createDescriptorSetLayout();
-  createGraphicsPipeline();
-  createCommandPool();
-  createColorResources();
-  createDepthResources();
-  createFramebuffers();
-  createTextureImage();
-  createTextureImageView();
-  createTextureSampler();
-  loadModel();
-  createVertexBuffer();
-  createIndexBuffer();
-  createUniformBuffers();
-  createDescriptorPool();
-  createDescriptorSets();
-  createCommandBuffers();
-  createSyncObjects();
+  if (assetPack_.open(ASSET_PACK_PATH)) {
+    std::cout << "loading assets from " << ASSET_PACK_PATH << '\n';
+  }
+
+  // File I/O and decoding overlap with instance and device creation; each
+  // upload starts as soon as both its data and the device are there.
+  TaskGraph tasks;
+  const auto model = tasks.add("load model", [this]() { loadModel(); });
+  const auto texture = tasks.add(
+      "load textures", [this]() { textureBatch_ = loadTextures(); });
+  const auto virtualTexture = tasks.add("load virtual texture",
+                                        [this]() { loadVirtualTexture(); });
+  const auto device = tasks.add("create device", [this]() {
+    createInstance();
+    setupDebugMessenger();
+    createSurface();
+    pickPhysicalDevice();
+    createLogicalDevice();
+    createCommandPool();
+  });
+  // The fragment shader depends on whether the device has the texture table.
+  const auto shaders = tasks.add(
+      "read shaders",
+      [this]() {
+        readShaders(vertShaderCode_, fragShaderCode_, cullShaderCode_,
+                    depthShaderCode_);
+      },
+      {device});
+  // chooseSwapExtent() asks GLFW for the framebuffer size, which only the
+  // main thread may do.
+  const auto swapChain = tasks.add(
+      "create swap chain",
+      [this]() {
+        createSwapChain();
+        createImageViews();
+        createRenderPass();
+        createDescriptorSetLayout();
+        createColorResources();
+        createDepthResources();
+        createFramebuffers();
+        createUniformBuffers();
+      },
+      {device}, true);
+  const auto pipeline =
+      tasks.add("create pipeline", [this]() { createGraphicsPipeline(); },
+                {swapChain, shaders});
+  const auto textureUpload = tasks.add(
+      "upload textures",
+      [this]() {
+        createTextureArrays(textureBatch_, textureArrays_);
+        createTextureAtlas(textureBatch_, textureAtlas_);
+        createTextureImageViews(textureArrays_, textureBatch_.views.size(),
+                                textureImageViews_);
+        createTextureSampler();
+      },
+      {device, texture});
+  const auto virtualTextureUpload = tasks.add(
+      "upload virtual texture",
+      [this]() {
+        createVirtualTexture();
+        // Other uploads may be using the command pool.
+        std::lock_guard<std::mutex> lock(singleTimeCommandsMutex_);
+        createVirtualTextureFrames();
+      },
+      {device, virtualTexture, swapChain});
+  const auto meshUpload = tasks.add(
+      "upload mesh",
+      [this]() {
+        StagingBuffer staging = createStagingBuffer(meshStagingSize(mesh_));
+        createVertexBuffer(mesh_, staging, vertexBuffer_, vertexBufferMemory_);
+        createIndexBuffer(mesh_, staging, indexBuffer_, indexBufferMemory_);
+        createPartBuffer(mesh_, staging, partBuffer_, partBufferMemory_);
+        meshletCulling_ = meshletCulling_ && canCullMeshlets(mesh_);
+        createMeshletBuffer(mesh_, staging, meshletBuffer_,
+                            meshletBufferMemory_);
+        submitStaging(staging);
+        destroyStagingBuffer(staging);
+        releaseGeometry();
+      },
+      {device, model});
+  const auto cull = tasks.add(
+      "create cull pipeline",
+      [this]() {
+        createCullPipeline();
+        createDrawBuffers();
+      },
+      {meshUpload, shaders, swapChain});
+  const auto descriptors = tasks.add(
+      "create descriptors",
+      [this]() {
+        createDescriptorPool();
+        createDescriptorSets();
+      },
+      {swapChain, textureUpload, virtualTextureUpload, cull});
+  tasks.add(
+      "record commands",
+      [this]() {
+        createCommandBuffers();
+        createSyncObjects();
+      },
+      {pipeline, meshUpload, descriptors});
+
+  tasks.run();
+  std::cout << "startup:\n";
+  tasks.printTimings(std::cout);
+  // Reported here rather than by the uploads, which also run for hot
+  // reloads, on worker threads.
+  std::cout << "vertex buffer: "
+            << vertexBufferSize(mesh_, options_.vertexFormat) << " bytes\n"
+            << "index buffer: "
+            << VkDeviceSize{mesh_.indexSize} * mesh_.indexCount
+            << " bytes in " << mesh_.rangeCount << " draws\n"
+            << "meshlets: " << mesh_.meshletCount << '\n';
+  if (textureAtlas_.tileCount != 0) {
+    std::cout << "packed " << textureAtlas_.tileCount << " textures into a "
+              << textureAtlas_.width << "x" << textureAtlas_.height
+              << " atlas\n";
+  }
+  std::cout << "memory after startup: " << queryMemoryUsage() << '\n';
 }
 
 void Application::initImGui() {
@@ -226,11 +466,14 @@ void Application::initImGui() {
   ImGui_ImplVulkan_Init(&init_info, imguiRenderPass_);
 
   // Upload Fonts
-  VkCommandBuffer command_buffer = beginSingleTimeCommands();
-  ImGui_ImplVulkan_CreateFontsTexture(command_buffer);
-  endSingleTimeCommands(command_buffer);
-  err = vkDeviceWaitIdle(device_);
-  check_vk_result(err);
+  {
+    std::unique_lock<std::mutex> lock(singleTimeCommandsMutex_);
+    VkCommandBuffer command_buffer = beginSingleTimeCommands();
+    ImGui_ImplVulkan_CreateFontsTexture(command_buffer);
+    endSingleTimeCommands(command_buffer, lock);
+    err = vkDeviceWaitIdle(device_);
+    check_vk_result(err);
+  }
   ImGui_ImplVulkan_DestroyFontUploadObjects();
 
   createImGuiCommandPool(&imGuiCommandPool_,
@@ -264,28 +507,44 @@ void Application::initImGui() {
 void Application::mainLoop() {
   while (glfwWindowShouldClose(window_) == 0) {
     glfwPollEvents();
+    pollAssetChanges();
+    streamTextureMips();
     drawImGui();
     drawFrame();
   }
 
+  // Uploads still in progress are finished; a reload is thrown away.
+  if (mipStreamJob_.valid()) {
+    mipStreamJob_.get();
+  }
+  if (reloadJob_.valid()) {
+    AssetReload reload = reloadJob_.get();
+    destroyReload(reload);
+  }
   vkDeviceWaitIdle(device_);
+  releaseQueue_.releaseAll();
+  std::cout << "memory at exit: " << queryMemoryUsage() << '\n';
 }
 
 void Application::drawImGui() {
-  std::future<void> drawImGuiFuture = std::async(std::launch::async, [&]() {
-    ImGui_ImplVulkan_NewFrame();
-    ImGui_ImplGlfw_NewFrame();
-    ImGui::NewFrame();
-    {
-      ImGui::Begin("Model Controller");
+  // Runs on the main thread: the GLFW backend reads input here, and the draw
+  // data has to be complete before frameRenderImGui() records it anyway.
+  ImGui_ImplVulkan_NewFrame();
+  ImGui_ImplGlfw_NewFrame();
+  ImGui::NewFrame();
+  {
+    ImGui::Begin("Model Controller");
 
-      ImGui::SliderFloat("Zoom", &ZOOMDEGREES, 0.0f, 180.0f, "%.0f");
+    ImGui::SliderFloat("Zoom", &ZOOMDEGREES, 0.0f, 180.0f, "%.0f");
 
-      ImGui::Text("%.0f FPS", ImGui::GetIO().Framerate);
-      ImGui::End();
-    }
-    ImGui::Render();
-  });
+    const MeshLod lod = mesh_.lod(activeLod_);
+    ImGui::Text("LOD %u / %u: %u triangles", activeLod_,
+                std::max(mesh_.lodCount, 1u) - 1, lod.indexCount / 3);
+
+    ImGui::Text("%.0f FPS", ImGui::GetIO().Framerate);
+    ImGui::End();
+  }
+  ImGui::Render();
 }
 
 void Application::createImGuiCommandPool(VkCommandPool* commandPool,
@@ -384,6 +643,7 @@ void Application::cleanupSwapChain() {
                        commandBuffers_.data());
 
   vkDestroyPipeline(device_, graphicsPipeline_, nullptr);
+  vkDestroyPipeline(device_, depthPipeline_, nullptr);
   vkDestroyPipelineLayout(device_, pipelineLayout_, nullptr);
 
   vkDestroyRenderPass(device_, imguiRenderPass_, nullptr);
@@ -400,6 +660,13 @@ void Application::cleanupSwapChain() {
     vkFreeMemory(device_, uniformBuffersMemory_[i], nullptr);
   }
 
+  for (size_t i = 0; i < drawBuffers_.size(); i++) {
+    vkDestroyBuffer(device_, drawBuffers_[i], nullptr);
+    vkFreeMemory(device_, drawBuffersMemory_[i], nullptr);
+  }
+
+  destroyVirtualTextureFrames();
+
   vkDestroyDescriptorPool(device_, imguiDescriptorPool_, nullptr);
   vkDestroyDescriptorPool(device_, descriptorPool_, nullptr);
   vkDestroyCommandPool(device_, imGuiCommandPool_, nullptr);
@@ -409,16 +676,26 @@ void Application::cleanup() {
   cleanupSwapChain();
 
   vkDestroySampler(device_, textureSampler_, nullptr);
-  vkDestroyImageView(device_, textureImageView_, nullptr);
-
-  vkDestroyImage(device_, textureImage_, nullptr);
-  vkFreeMemory(device_, textureImageMemory_, nullptr);
+  destroyTextureImageViews(textureImageViews_);
+  destroyTextureArrays(textureArrays_);
+  destroyTextureAtlas(textureAtlas_);
+  destroyVirtualTexture();
 
   vkDestroyDescriptorSetLayout(device_, descriptorSetLayout_, nullptr);
 
+  vkDestroyPipeline(device_, cullPipeline_, nullptr);
+  vkDestroyPipelineLayout(device_, cullPipelineLayout_, nullptr);
+  vkDestroyDescriptorSetLayout(device_, cullDescriptorSetLayout_, nullptr);
+
+  vkDestroyBuffer(device_, meshletBuffer_, nullptr);
+  vkFreeMemory(device_, meshletBufferMemory_, nullptr);
+
   vkDestroyBuffer(device_, indexBuffer_, nullptr);
   vkFreeMemory(device_, indexBufferMemory_, nullptr);
 
+  vkDestroyBuffer(device_, partBuffer_, nullptr);
+  vkFreeMemory(device_, partBufferMemory_, nullptr);
+
   vkDestroyBuffer(device_, vertexBuffer_, nullptr);
   vkFreeMemory(device_, vertexBufferMemory_, nullptr);
 
@@ -453,21 +730,29 @@ void Application::recreateSwapChain() {
     glfwWaitEvents();
   }
 
-  vkDeviceWaitIdle(device_);
-
-  cleanupSwapChain();
-
-  createSwapChain();
-  createImageViews();
-  createRenderPass();
-  createGraphicsPipeline();
-  createColorResources();
-  createDepthResources();
-  createFramebuffers();
-  createUniformBuffers();
-  createDescriptorPool();
-  createDescriptorSets();
-  createCommandBuffers();
+  {
+    // A reload may be uploading on another thread.
+    std::lock_guard<std::mutex> lock(singleTimeCommandsMutex_);
+    vkDeviceWaitIdle(device_);
+    releaseQueue_.releaseAll();
+
+    cleanupSwapChain();
+    ++swapChainGeneration_;
+
+    createSwapChain();
+    createImageViews();
+    createRenderPass();
+    createGraphicsPipeline();
+    createColorResources();
+    createDepthResources();
+    createFramebuffers();
+    createUniformBuffers();
+    createVirtualTextureFrames();
+    createDrawBuffers();
+    createDescriptorPool();
+    createDescriptorSets();
+    createCommandBuffers();
+  }
   initImGui();
 }
 
@@ -586,11 +871,64 @@ void Application::createLogicalDevice() {
     queueCreateInfos.push_back(queueCreateInfo);
   }
 
+  // Meshlet culling draws the compacted list with one multi-draw, whose
+  // commands select the part through firstInstance, and runs its compute pass
+  // on the graphics queue.
+  VkPhysicalDeviceFeatures supportedFeatures{};
+  vkGetPhysicalDeviceFeatures(physicalDevice_, &supportedFeatures);
+  uint32_t queueFamilyCount = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice_, &queueFamilyCount,
+                                           nullptr);
+  std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+  vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice_, &queueFamilyCount,
+                                           queueFamilies.data());
+  meshletCulling_ =
+      options_.meshletCulling && supportedFeatures.multiDrawIndirect &&
+      supportedFeatures.drawIndirectFirstInstance &&
+      (queueFamilies[indices.graphicsFamily.value()].queueFlags &
+       VK_QUEUE_COMPUTE_BIT) != 0;
+  if (options_.meshletCulling && !meshletCulling_) {
+    std::cerr << "meshlet culling is not supported, drawing all meshlets\n";
+  }
+
   VkPhysicalDeviceFeatures deviceFeatures{};
   deviceFeatures.samplerAnisotropy = VK_TRUE;
+  deviceFeatures.multiDrawIndirect = meshletCulling_ ? VK_TRUE : VK_FALSE;
+  deviceFeatures.drawIndirectFirstInstance =
+      meshletCulling_ ? VK_TRUE : VK_FALSE;
+  // Without it no BC format is supported and textures fall back to RGBA8.
+  deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+  // The virtual texture's feedback is written by the fragment shader.
+  if (options_.virtualTexture && !supportedFeatures.fragmentStoresAndAtomics) {
+    throw std::runtime_error(
+        "failed to enable virtual texturing: no fragment shader stores!");
+  }
+  deviceFeatures.fragmentStoresAndAtomics =
+      options_.virtualTexture ? VK_TRUE : VK_FALSE;
+  deviceFeatures.shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+
+  // The texture table, see supportsTextureTable(). The virtual texture does
+  // not sample it.
+  textureTable_ =
+      !options_.virtualTexture && supportsTextureTable(physicalDevice_);
+  if (!options_.virtualTexture && !textureTable_) {
+    std::cerr << "descriptor indexing is not supported, binding at most "
+              << MAX_FIXED_TEXTURES << " textures\n";
+  }
+  VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures{};
+  indexingFeatures.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+  indexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+  indexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+  indexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+  std::vector<const char*> extensions = deviceExtensions;
+  if (textureTable_) {
+    extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+  }
 
   VkDeviceCreateInfo createInfo{};
   createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+  createInfo.pNext = textureTable_ ? &indexingFeatures : nullptr;
 
   createInfo.queueCreateInfoCount =
       static_cast<uint32_t>(queueCreateInfos.size());
@@ -598,9 +936,8 @@ void Application::createLogicalDevice() {
 
   createInfo.pEnabledFeatures = &deviceFeatures;
 
-  createInfo.enabledExtensionCount =
-      static_cast<uint32_t>(deviceExtensions.size());
-  createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+  createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+  createInfo.ppEnabledExtensionNames = extensions.data();
 
   if (enableValidationLayers) {
     createInfo.enabledLayerCount =
@@ -773,18 +1110,58 @@ void Application::createDescriptorSetLayout() {
   uboLayoutBinding.pImmutableSamplers = nullptr;
   uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
+  // The texture table.
   VkDescriptorSetLayoutBinding samplerLayoutBinding{};
   samplerLayoutBinding.binding = 1;
-  samplerLayoutBinding.descriptorCount = 1;
+  samplerLayoutBinding.descriptorCount = textureSlotCount();
   samplerLayoutBinding.descriptorType =
       VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
   samplerLayoutBinding.pImmutableSamplers = nullptr;
   samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
-  std::array<VkDescriptorSetLayoutBinding, 2> bindings = {uboLayoutBinding,
-                                                          samplerLayoutBinding};
+  std::vector<VkDescriptorSetLayoutBinding> bindings = {uboLayoutBinding,
+                                                        samplerLayoutBinding};
+  // Virtual texturing adds the page atlas, the page table and the feedback
+  // buffer, and reads the feedback stamp from the uniform buffer.
+  if (options_.virtualTexture) {
+    bindings[0].stageFlags |= VK_SHADER_STAGE_FRAGMENT_BIT;
+    const VkDescriptorType types[] = {
+        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER};
+    for (VkDescriptorType type : types) {
+      VkDescriptorSetLayoutBinding binding{};
+      binding.binding = static_cast<uint32_t>(bindings.size());
+      binding.descriptorCount = 1;
+      binding.descriptorType = type;
+      binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+      bindings.push_back(binding);
+    }
+  }
+  // The texture coordinate transforms, see TextureAtlas.
+  VkDescriptorSetLayoutBinding transformLayoutBinding{};
+  transformLayoutBinding.binding = TEXTURE_TRANSFORM_BINDING;
+  transformLayoutBinding.descriptorCount = 1;
+  transformLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  transformLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+  bindings.push_back(transformLayoutBinding);
+  // Only the textures there are get written into the table, and streaming
+  // rewrites them without re-recording the commands that use it.
+  std::vector<VkDescriptorBindingFlags> bindingFlags(bindings.size(), 0);
+  bindingFlags[1] = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                    VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+  VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{};
+  flagsInfo.sType =
+      VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+  flagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+  flagsInfo.pBindingFlags = bindingFlags.data();
+
   VkDescriptorSetLayoutCreateInfo layoutInfo{};
   layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  if (textureTable_) {
+    layoutInfo.pNext = &flagsInfo;
+    layoutInfo.flags =
+        VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+  }
   layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
   layoutInfo.pBindings = bindings.data();
 
@@ -794,12 +1171,65 @@ void Application::createDescriptorSetLayout() {
   }
 }
 
-void Application::createGraphicsPipeline() {
-  auto vertShaderCode = readFile("../../src/vert.spv");
-  auto fragShaderCode = readFile("../../src/frag.spv");
+void Application::readShaders(std::vector<char>& vertCode,
+                              std::vector<char>& fragCode,
+                              std::vector<char>& cullCode,
+                              std::vector<char>& depthCode) {
+  const bool compact = options_.vertexFormat == VertexFormat::Compact;
+  vertCode = readAsset(compact ? VERT_COMPACT_SHADER_NAME : VERT_SHADER_NAME);
+  fragCode = readAsset(fragShaderName());
+  // Whether the device supports culling is not known yet, so this follows
+  // the request.
+  if (options_.meshletCulling) {
+    cullCode = readAsset(CULL_SHADER_NAME);
+  }
+  if (options_.depthPrepass) {
+    depthCode =
+        readAsset(compact ? DEPTH_COMPACT_SHADER_NAME : DEPTH_SHADER_NAME);
+  }
+}
+
+const std::string& Application::fragShaderName() const {
+  if (options_.virtualTexture) {
+    return FRAG_VIRTUAL_SHADER_NAME;
+  }
+  return textureTable_ ? FRAG_TABLE_SHADER_NAME : FRAG_SHADER_NAME;
+}
+
+uint32_t Application::textureSlotCount() const {
+  return textureTable_ ? MAX_BINDLESS_TEXTURES : MAX_FIXED_TEXTURES;
+}
 
-  VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
-  VkShaderModule fragShaderModule = createShaderModule(fragShaderCode);
+void Application::createGraphicsPipeline() {
+  createGraphicsPipeline(vertShaderCode_, fragShaderCode_, depthShaderCode_,
+                         pipelineLayout_, graphicsPipeline_, depthPipeline_);
+}
+
+// Whatever is created is in the out-parameters even if this throws, for the
+// caller to destroy; the shader modules never outlive the call.
+void Application::createGraphicsPipeline(const std::vector<char>& vertCode,
+                                         const std::vector<char>& fragCode,
+                                         const std::vector<char>& depthCode,
+                                         VkPipelineLayout& layout,
+                                         VkPipeline& pipeline,
+                                         VkPipeline& depthPipeline) {
+  VkShaderModule vertShaderModule = createShaderModule(vertCode);
+  VkShaderModule fragShaderModule{};
+  VkShaderModule depthShaderModule{};
+  const auto destroyShaderModules = [&]() {
+    vkDestroyShaderModule(device_, depthShaderModule, nullptr);
+    vkDestroyShaderModule(device_, fragShaderModule, nullptr);
+    vkDestroyShaderModule(device_, vertShaderModule, nullptr);
+  };
+  try {
+    fragShaderModule = createShaderModule(fragCode);
+    if (options_.depthPrepass) {
+      depthShaderModule = createShaderModule(depthCode);
+    }
+  } catch (const std::exception&) {
+    destroyShaderModules();
+    throw;
+  }
 
   VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
   vertShaderStageInfo.sType =
@@ -822,13 +1252,16 @@ void Application::createGraphicsPipeline() {
   vertexInputInfo.sType =
       VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
 
-  auto bindingDescription = Vertex::getBindingDescription();
-  auto attributeDescriptions = Vertex::getAttributeDescriptions();
+  std::vector<VkVertexInputBindingDescription> bindingDescriptions;
+  std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
+  describeVertexInput(options_.vertexFormat, false, bindingDescriptions,
+                      attributeDescriptions);
 
-  vertexInputInfo.vertexBindingDescriptionCount = 1;
+  vertexInputInfo.vertexBindingDescriptionCount =
+      static_cast<uint32_t>(bindingDescriptions.size());
   vertexInputInfo.vertexAttributeDescriptionCount =
       static_cast<uint32_t>(attributeDescriptions.size());
-  vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+  vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions.data();
   vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
 
   VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
@@ -876,8 +1309,13 @@ void Application::createGraphicsPipeline() {
   depthStencil.sType =
       VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
   depthStencil.depthTestEnable = VK_TRUE;
-  depthStencil.depthWriteEnable = VK_TRUE;
-  depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+  // After a depth pre-pass the depth buffer is final, and only the nearest
+  // fragment of each sample passes.
+  depthStencil.depthWriteEnable =
+      options_.depthPrepass ? VK_FALSE : VK_TRUE;
+  depthStencil.depthCompareOp = options_.depthPrepass
+                                    ? VK_COMPARE_OP_LESS_OR_EQUAL
+                                    : VK_COMPARE_OP_LESS;
   depthStencil.depthBoundsTestEnable = VK_FALSE;
   depthStencil.stencilTestEnable = VK_FALSE;
 
@@ -905,7 +1343,8 @@ void Application::createGraphicsPipeline() {
   pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout_;
 
   if (vkCreatePipelineLayout(device_, &pipelineLayoutInfo, nullptr,
-                             &pipelineLayout_) != VK_SUCCESS) {
+                             &layout) != VK_SUCCESS) {
+    destroyShaderModules();
     throw std::runtime_error("failed to create pipeline layout!");
   }
 
@@ -920,18 +1359,49 @@ void Application::createGraphicsPipeline() {
   pipelineInfo.pMultisampleState = &multisampling;
   pipelineInfo.pDepthStencilState = &depthStencil;
   pipelineInfo.pColorBlendState = &colorBlending;
-  pipelineInfo.layout = pipelineLayout_;
+  pipelineInfo.layout = layout;
   pipelineInfo.renderPass = renderPass_;
   pipelineInfo.subpass = 0;
   pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
   if (vkCreateGraphicsPipelines(device_, VK_NULL_HANDLE, 1, &pipelineInfo,
-                                nullptr, &graphicsPipeline_) != VK_SUCCESS) {
+                                nullptr, &pipeline) != VK_SUCCESS) {
+    destroyShaderModules();
     throw std::runtime_error("failed to create graphics pipeline!");
   }
 
-  vkDestroyShaderModule(device_, fragShaderModule, nullptr);
-  vkDestroyShaderModule(device_, vertShaderModule, nullptr);
+  if (!options_.depthPrepass) {
+    destroyShaderModules();
+    return;
+  }
+
+  // The same state with positions only, no fragment shader and no color
+  // writes; with split streams it does not fetch the other attributes.
+  VkPipelineShaderStageCreateInfo depthShaderStageInfo = vertShaderStageInfo;
+  depthShaderStageInfo.module = depthShaderModule;
+
+  describeVertexInput(options_.vertexFormat, true, bindingDescriptions,
+                      attributeDescriptions);
+  vertexInputInfo.vertexBindingDescriptionCount =
+      static_cast<uint32_t>(bindingDescriptions.size());
+  vertexInputInfo.vertexAttributeDescriptionCount =
+      static_cast<uint32_t>(attributeDescriptions.size());
+  vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions.data();
+  vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+  depthStencil.depthWriteEnable = VK_TRUE;
+  depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+  colorBlendAttachment.colorWriteMask = 0;
+
+  pipelineInfo.stageCount = 1;
+  pipelineInfo.pStages = &depthShaderStageInfo;
+
+  const VkResult result = vkCreateGraphicsPipelines(
+      device_, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &depthPipeline);
+  destroyShaderModules();
+  if (result != VK_SUCCESS) {
+    throw std::runtime_error("failed to create depth pipeline!");
+  }
 }
 
 void Application::createFramebuffers() {
@@ -963,6 +1433,8 @@ void Application::createCommandPool() {
   VkCommandPoolCreateInfo poolInfo{};
   poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
   poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
+  // Command buffers are re-recorded when the level of detail changes.
+  poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
   if (vkCreateCommandPool(device_, &poolInfo, nullptr, &commandPool_) !=
       VK_SUCCESS) {
@@ -973,8 +1445,8 @@ void Application::createCommandPool() {
 void Application::createColorResources() {
   VkFormat colorFormat = swapChainImageFormat_;
 
-  createImage(swapChainExtent_.width, swapChainExtent_.height, 1, msaaSamples_,
-              colorFormat, VK_IMAGE_TILING_OPTIMAL,
+  createImage(swapChainExtent_.width, swapChainExtent_.height, 1, 1,
+              msaaSamples_, colorFormat, VK_IMAGE_TILING_OPTIMAL,
               VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT |
                   VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, colorImage_,
@@ -986,8 +1458,8 @@ void Application::createColorResources() {
 void Application::createDepthResources() {
   VkFormat depthFormat = findDepthFormat();
 
-  createImage(swapChainExtent_.width, swapChainExtent_.height, 1, msaaSamples_,
-              depthFormat, VK_IMAGE_TILING_OPTIMAL,
+  createImage(swapChainExtent_.width, swapChainExtent_.height, 1, 1,
+              msaaSamples_, depthFormat, VK_IMAGE_TILING_OPTIMAL,
               VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, depthImage_,
               depthImageMemory_);
@@ -1027,145 +1499,802 @@ bool Application::hasStencilComponent(VkFormat format) {
          format == VK_FORMAT_D24_UNORM_S8_UINT;
 }
 
-void Application::createTextureImage() {
-  int texWidth{0};
-  int texHeight{0};
-  int texChannels{0};
-  stbi_uc* pixels = stbi_load(TEXTURE_PATH.c_str(), &texWidth, &texHeight,
-                              &texChannels, STBI_rgb_alpha);
-  VkDeviceSize imageSize = texWidth * texHeight * 4;
-  mipLevels_ = static_cast<uint32_t>(
-                   std::floor(std::log2(std::max(texWidth, texHeight)))) +
-               1;
+// Every texture decodes and cooks on its own, so the batch is spread over the
+// worker threads and takes about as long as its slowest texture.
+TextureBatch Application::loadTextures() const {
+  const auto first = TEXTURE_NAMES.begin() + (options_.virtualTexture ? 1 : 0);
+  TextureBatch batch(std::vector<std::string>(first, TEXTURE_NAMES.end()));
+  parallelFor(batch.names.size(), [this, &batch](size_t i) {
+    batch.views[i] =
+        loadTexture(batch.names[i], batch.caches[i], batch.cooked[i]);
+  });
+  return batch;
+}
+
+// A cooked texture is used as is: from the pack, in whatever format it was
+// packed in, or from the cache next to the source if that is unchanged and in
+// the requested format. Otherwise the source is decoded and cooked here, and
+// the cache written for the next start. Whether a texture is an atlas tile
+// depends on its extent, so both caches are tried before the source is read.
+TextureView Application::loadTexture(const std::string& name,
+                                     TextureCache& cache,
+                                     CookedTexture& cooked) const {
+  const std::array<std::string, 2> extensions{ATLAS_TILE_EXTENSION,
+                                              TEXTURE_CACHE_EXTENSION};
+  for (const std::string& extension : extensions) {
+    const AssetData packed = assetPack_.view(name + extension);
+    if (packed.data != nullptr && cache.open(packed.data, packed.size)) {
+      return cache.view();
+    }
+  }
+  const std::string path = ASSET_DIR + name;
+  for (const std::string& extension : extensions) {
+    if (!assetPack_.isOpen() && cache.open(path + extension, path)) {
+      if (cache.view().format == options_.textureFormat &&
+          isCookedForAtlas(cache.view())) {
+        return cache.view();
+      }
+      cache.close();
+    }
+  }
 
-  if (pixels == nullptr) {
+  cooked = decodeTexture(name, options_.textureFormat);
+  const std::string cachePath =
+      path + (cooked.contentWidth != 0 ? ATLAS_TILE_EXTENSION
+                                       : TEXTURE_CACHE_EXTENSION);
+  if (!assetPack_.isOpen() &&
+      !TextureCache::write(cachePath, path, cooked.view())) {
+    std::cerr << "failed to write texture cache " << cachePath << '\n';
+  }
+  return cooked.view();
+}
+
+// The image is sized from its header and decoded straight into level 0 of
+// the cooked texture, so no second full-size copy of it is ever made. Atlas
+// tiles are the exception: the image sits inside its gutter there, and is
+// small anyway.
+CookedTexture Application::decodeTexture(const std::string& name,
+                                         VkFormat format) const {
+  std::vector<uint8_t> storage;
+  const AssetData file = findAsset(name, storage);
+  ImageInfo info{};
+  if (!readImageInfo(file.data, file.size, info)) {
     throw std::runtime_error("failed to load texture image!");
   }
+  CookedTexture cooked;
+  if (isAtlasCandidate(info.width, info.height)) {
+    std::vector<uint8_t> pixels(size_t{info.width} * info.height * 4 +
+                                IMAGE_DECODE_SLACK);
+    if (!decodeImage(file.data, file.size, info, pixels.data(),
+                     pixels.size())) {
+      throw std::runtime_error("failed to load texture image!");
+    }
+    cooked = cookAtlasTile(pixels.data(), info.width, info.height);
+  } else {
+    cooked = allocateTexture(info.width, info.height);
+    if (!decodeImage(file.data, file.size, info, cooked.data.data(),
+                     cooked.data.size())) {
+      throw std::runtime_error("failed to load texture image!");
+    }
+    cookMips(cooked);
+  }
+  if (isBlockCompressed(format)) {
+    cooked = compressTexture(cooked.view(), format);
+  }
+  return cooked;
+}
+
+// Textures are cooked before the device exists, so the format is checked
+// only here. A format the device cannot sample with linear filtering is
+// replaced by RGBA8, which every device supports, cooked again from the
+// source.
+TextureView Application::supportedTexture(const std::string& name,
+                                          const TextureView& texture,
+                                          CookedTexture& fallback) const {
+  VkFormatProperties properties{};
+  vkGetPhysicalDeviceFormatProperties(physicalDevice_, texture.format,
+                                      &properties);
+  const VkFormatFeatureFlags required =
+      VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+      VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT |
+      VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+  if ((properties.optimalTilingFeatures & required) == required) {
+    return texture;
+  }
+  std::cerr << name << ": texture format " << texture.format
+            << " is not supported, falling back to RGBA8\n";
+  fallback = decodeTexture(name, VK_FORMAT_R8G8B8A8_SRGB);
+  return fallback.view();
+}
+
+// The mip tails of the whole batch go up through one staging buffer and one
+// command buffer: the tail of every array moves to TRANSFER_DST, gets one
+// copy per layer and level, and moves on to SHADER_READ_ONLY. All levels are
+// cooked already, so nothing is blitted. The finer levels are left to
+// streamTextureMips(), so this takes about as long for large textures as
+// for small ones. The tiles chooseAtlasTiles() picks are left to
+// createTextureAtlas(); tiles it leaves out are uploaded like any texture.
+void Application::createTextureArrays(TextureBatch& batch,
+                                      std::vector<TextureArray>& arrays) {
+  // The texture table and the transforms need at least one texture.
+  if (batch.views.empty()) {
+    throw std::runtime_error("failed to create texture table: no textures!");
+  }
+  if (batch.views.size() > textureSlotCount()) {
+    throw std::runtime_error("failed to create texture table: too many "
+                             "textures!");
+  }
+  for (size_t i{0}; i < batch.views.size(); ++i) {
+    batch.views[i] =
+        supportedTexture(batch.names[i], batch.views[i], batch.cooked[i]);
+  }
+  const std::vector<uint32_t> tiles =
+      chooseAtlasTiles(batch.views, ATLAS_MAX_EXTENT);
+  std::vector<uint32_t> arrayTextures;
+  std::vector<TextureView> arrayViews;
+  for (uint32_t i{0}; i < batch.views.size(); ++i) {
+    if (std::find(tiles.begin(), tiles.end(), i) == tiles.end()) {
+      arrayTextures.push_back(i);
+      arrayViews.push_back(batch.views[i]);
+    }
+  }
+  VkPhysicalDeviceProperties properties{};
+  vkGetPhysicalDeviceProperties(physicalDevice_, &properties);
+  for (TextureArrayLayout& layout : groupTextureLayers(
+           arrayViews, properties.limits.maxImageArrayLayers)) {
+    for (uint32_t& texture : layout.textures) {
+      texture = arrayTextures[texture];
+    }
+    TextureArray array{};
+    array.layout = std::move(layout);
+    createImage(array.layout.width, array.layout.height,
+                array.layout.levelCount,
+                static_cast<uint32_t>(array.layout.textures.size()),
+                VK_SAMPLE_COUNT_1_BIT, array.layout.format,
+                VK_IMAGE_TILING_OPTIMAL,
+                VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, array.image,
+                array.memory);
+    array.residentLevel = mipTailLevel(array.layout);
+    arrays.push_back(std::move(array));
+  }
+
+  std::vector<TextureArrayLayout> layouts;
+  for (const TextureArray& array : arrays) {
+    layouts.push_back(array.layout);
+  }
+  const std::vector<uint64_t> tailOffsets =
+      mipTailOffsets(batch.views, layouts);
+  std::vector<VkDeviceSize> offsets(batch.views.size());
+  VkDeviceSize stagingSize{0};
+  for (size_t i{0}; i < batch.views.size(); ++i) {
+    offsets[i] = stagingSize;
+    stagingSize += (batch.views[i].dataSize - tailOffsets[i] +
+                    STAGING_ALIGNMENT - 1) /
+                   STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+  }
+  // A batch of atlas tiles only, as with --virtual-texture, leaves nothing
+  // to upload here, and Vulkan has no buffers of size 0.
+  if (stagingSize == 0) {
+    return;
+  }
+  StagingBuffer staging = createStagingBuffer(stagingSize);
+  for (size_t i{0}; i < batch.views.size(); ++i) {
+    memcpy(staging.data + offsets[i], batch.views[i].data + tailOffsets[i],
+           static_cast<size_t>(batch.views[i].dataSize - tailOffsets[i]));
+  }
 
-  VkBuffer stagingBuffer = nullptr;
-  VkDeviceMemory stagingBufferMemory = nullptr;
-  createBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-               stagingBuffer, stagingBufferMemory);
+  std::unique_lock<std::mutex> lock(singleTimeCommandsMutex_);
+  VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+  for (const TextureArray& array : arrays) {
+    const auto layerCount =
+        static_cast<uint32_t>(array.layout.textures.size());
+    const uint32_t tail = array.residentLevel;
+    const uint32_t tailCount = array.layout.levelCount - tail;
+    transitionImageLayout(commandBuffer, array.image,
+                          VK_IMAGE_LAYOUT_UNDEFINED,
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, tail,
+                          tailCount, layerCount);
+    for (uint32_t layer{0}; layer < layerCount; ++layer) {
+      const uint32_t texture = array.layout.textures[layer];
+      copyBufferToImage(commandBuffer, staging.buffer, offsets[texture],
+                        array.image, layer, batch.views[texture], tail,
+                        tailCount);
+    }
+    transitionImageLayout(commandBuffer, array.image,
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, tail,
+                          tailCount, layerCount);
+  }
+  endSingleTimeCommands(commandBuffer, lock);
+  destroyStagingBuffer(staging);
+}
+
+void Application::destroyTextureArrays(std::vector<TextureArray>& arrays) {
+  for (TextureArray& array : arrays) {
+    vkDestroyImage(device_, array.image, nullptr);
+    vkFreeMemory(device_, array.memory, nullptr);
+  }
+  arrays.clear();
+}
+
+// The tiles go up through one staging buffer and one command buffer, like
+// the mip tails of the arrays, but with all of the atlas's levels: tiles are
+// small, so nothing is left for streamTextureMips(). The transforms come
+// along in the same copy. The tiles are the ones createTextureArrays() left
+// out, picked again from the same views.
+void Application::createTextureAtlas(const TextureBatch& batch,
+                                     TextureAtlas& atlas) {
+  const std::vector<uint32_t> members =
+      chooseAtlasTiles(batch.views, ATLAS_MAX_EXTENT);
+  std::vector<TextureView> tiles;
+  for (uint32_t member : members) {
+    tiles.push_back(batch.views[member]);
+  }
+  const AtlasLayout layout = packAtlas(tiles, ATLAS_MAX_EXTENT);
+
+  // The virtual texture path samples its page atlas with the mesh's own
+  // coordinates, so they are left unchanged there.
+  std::vector<std::array<float, 4>> transforms(batch.views.size(),
+                                               {1.0f, 1.0f, 0.0f, 0.0f});
+  if (!options_.virtualTexture) {
+    for (size_t i{0}; i < batch.views.size(); ++i) {
+      if (batch.views[i].contentWidth != 0) {
+        transforms[i] = tileTexCoordTransform(batch.views[i]);
+      }
+    }
+    for (size_t i{0}; i < tiles.size(); ++i) {
+      transforms[members[i]] = atlasTexCoordTransform(layout, i, tiles[i]);
+    }
+  }
+  const VkDeviceSize transformSize = sizeof(transforms[0]) * transforms.size();
+  createBuffer(transformSize,
+               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                   VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, atlas.transformBuffer,
+               atlas.transformBufferMemory);
+
+  std::vector<VkDeviceSize> offsets(tiles.size());
+  VkDeviceSize stagingSize = transformSize;
+  for (size_t i{0}; i < tiles.size(); ++i) {
+    const TextureLevel& last = tiles[i].levels[ATLAS_LEVEL_COUNT - 1];
+    offsets[i] = stagingSize;
+    stagingSize += (last.offset + last.size - tiles[i].levels[0].offset +
+                    STAGING_ALIGNMENT - 1) /
+                   STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+  }
+  StagingBuffer staging = createStagingBuffer(stagingSize);
+  memcpy(staging.data, transforms.data(), static_cast<size_t>(transformSize));
+  for (size_t i{0}; i < tiles.size(); ++i) {
+    const TextureLevel& first = tiles[i].levels[0];
+    const TextureLevel& last = tiles[i].levels[ATLAS_LEVEL_COUNT - 1];
+    memcpy(staging.data + offsets[i], tiles[i].data + first.offset,
+           static_cast<size_t>(last.offset + last.size - first.offset));
+  }
+
+  if (!tiles.empty()) {
+    createImage(layout.width, layout.height, ATLAS_LEVEL_COUNT, 1,
+                VK_SAMPLE_COUNT_1_BIT, tiles[0].format,
+                VK_IMAGE_TILING_OPTIMAL,
+                VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, atlas.image,
+                atlas.memory);
+  }
+  std::vector<VkBufferImageCopy> regions;
+  for (size_t i{0}; i < tiles.size(); ++i) {
+    const AtlasRect& rect = layout.rects[i];
+    for (uint32_t level{0}; level < ATLAS_LEVEL_COUNT; ++level) {
+      const TextureLevel& source = tiles[i].levels[level];
+      VkBufferImageCopy region{};
+      region.bufferOffset =
+          offsets[i] + source.offset - tiles[i].levels[0].offset;
+      region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      region.imageSubresource.mipLevel = level;
+      region.imageSubresource.layerCount = 1;
+      region.imageOffset = {static_cast<int32_t>(rect.x >> level),
+                            static_cast<int32_t>(rect.y >> level), 0};
+      region.imageExtent = {source.width, source.height, 1};
+      regions.push_back(region);
+    }
+  }
 
-  void* data = nullptr;
-  vkMapMemory(device_, stagingBufferMemory, 0, imageSize, 0, &data);
-  memcpy(data, pixels, static_cast<size_t>(imageSize));
-  vkUnmapMemory(device_, stagingBufferMemory);
+  std::unique_lock<std::mutex> lock(singleTimeCommandsMutex_);
+  VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+  VkBufferCopy transformCopy{};
+  transformCopy.size = transformSize;
+  vkCmdCopyBuffer(commandBuffer, staging.buffer, atlas.transformBuffer, 1,
+                  &transformCopy);
+  if (!tiles.empty()) {
+    transitionImageLayout(commandBuffer, atlas.image,
+                          VK_IMAGE_LAYOUT_UNDEFINED,
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0,
+                          ATLAS_LEVEL_COUNT, 1);
+    vkCmdCopyBufferToImage(commandBuffer, staging.buffer, atlas.image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<uint32_t>(regions.size()),
+                           regions.data());
+    transitionImageLayout(commandBuffer, atlas.image,
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 0,
+                          ATLAS_LEVEL_COUNT, 1);
+  }
+  endSingleTimeCommands(commandBuffer, lock);
+  destroyStagingBuffer(staging);
+
+  if (!tiles.empty()) {
+    atlas.view = createImageView(atlas.image, tiles[0].format,
+                                 VK_IMAGE_ASPECT_COLOR_BIT, ATLAS_LEVEL_COUNT);
+    atlas.tileCount = static_cast<uint32_t>(tiles.size());
+    atlas.width = layout.width;
+    atlas.height = layout.height;
+  }
+}
+
+void Application::destroyTextureAtlas(TextureAtlas& atlas) {
+  vkDestroyImageView(device_, atlas.view, nullptr);
+  vkDestroyImage(device_, atlas.image, nullptr);
+  vkFreeMemory(device_, atlas.memory, nullptr);
+  vkDestroyBuffer(device_, atlas.transformBuffer, nullptr);
+  vkFreeMemory(device_, atlas.transformBufferMemory, nullptr);
+  atlas = TextureAtlas{};
+}
+
+// Called once per frame. Picks up the levels the last upload made resident
+// and starts uploading the next ones, so that at most MIP_UPLOAD_BUDGET
+// bytes go up per frame. The batch is dropped once every level is resident.
+void Application::streamTextureMips() {
+  if (mipStreamJob_.valid()) {
+    if (mipStreamJob_.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready) {
+      return;
+    }
+    finishMipStream();
+  }
+  if (textureBatch_.views.empty()) {
+    return;
+  }
 
-  stbi_image_free(pixels);
+  std::vector<TextureArrayLayout> layouts;
+  std::vector<uint32_t> residentLevels;
+  for (const TextureArray& array : textureArrays_) {
+    layouts.push_back(array.layout);
+    residentLevels.push_back(array.residentLevel);
+  }
+  std::vector<MipUpload> uploads =
+      planMipUploads(layouts, residentLevels, MIP_UPLOAD_BUDGET);
+  if (uploads.empty()) {
+    textureBatch_ = TextureBatch{};
+    std::cout << "streamed in all texture levels\n";
+    return;
+  }
+  mipStreamJob_ = std::async(std::launch::async, &Application::uploadMips,
+                             this, std::move(uploads));
+}
 
-  createImage(texWidth, texHeight, mipLevels_, VK_SAMPLE_COUNT_1_BIT,
-              VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL,
-              VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
-                  VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage_,
-              textureImageMemory_);
-
-  transitionImageLayout(textureImage_, VK_FORMAT_R8G8B8A8_SRGB,
-                        VK_IMAGE_LAYOUT_UNDEFINED,
-                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels_);
-  copyBufferToImage(stagingBuffer, textureImage_,
-                    static_cast<uint32_t>(texWidth),
-                    static_cast<uint32_t>(texHeight));
-  // transitioned to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL while generating
-  // mipmaps
-
-  vkDestroyBuffer(device_, stagingBuffer, nullptr);
-  vkFreeMemory(device_, stagingBufferMemory, nullptr);
-
-  generateMipmaps(textureImage_, VK_FORMAT_R8G8B8A8_SRGB, texWidth, texHeight,
-                  mipLevels_);
-}
-
-void Application::generateMipmaps(VkImage image, VkFormat imageFormat,
-                                  int32_t texWidth, int32_t texHeight,
-                                  uint32_t mipLevels) {
-  // Check if image format supports linear blitting
-  VkFormatProperties formatProperties;
-  vkGetPhysicalDeviceFormatProperties(physicalDevice_, imageFormat,
-                                      &formatProperties);
-
-  if ((formatProperties.optimalTilingFeatures &
-       VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) == 0u) {
-    throw std::runtime_error(
-        "texture image format does not support linear blitting!");
+// Waits for the upload in progress, if any, and moves the views of the
+// textures it touched down to the levels it made resident. The old views are
+// kept until the frames submitted so far have completed.
+void Application::finishMipStream() {
+  if (!mipStreamJob_.valid()) {
+    return;
+  }
+  std::vector<bool> changed(textureArrays_.size(), false);
+  for (const MipUpload& upload : mipStreamJob_.get()) {
+    TextureArray& array = textureArrays_[upload.array];
+    array.residentLevel = std::min(array.residentLevel, upload.level);
+    changed[upload.array] = true;
   }
+  std::vector<VkImageView> retired;
+  for (size_t i{0}; i < textureArrays_.size(); ++i) {
+    if (!changed[i]) {
+      continue;
+    }
+    const TextureArray& array = textureArrays_[i];
+    for (uint32_t layer{0}; layer < array.layout.textures.size(); ++layer) {
+      VkImageView& view = textureImageViews_[array.layout.textures[layer]];
+      retired.push_back(view);
+      view = createTextureImageView(array, layer);
+    }
+  }
+  if (retired.empty()) {
+    return;
+  }
+  ++textureGeneration_;
+  releaseQueue_.retire(submittedFrames_, [this, retired]() mutable {
+    destroyTextureImageViews(retired);
+  });
+}
 
+// Runs on a worker thread, like a reload. The levels it fills are outside
+// every view until finishMipStream(), so frames keep sampling the arrays
+// meanwhile.
+std::vector<MipUpload> Application::uploadMips(
+    std::vector<MipUpload> uploads) {
+  std::vector<VkDeviceSize> offsets(uploads.size());
+  VkDeviceSize stagingSize{0};
+  for (size_t i{0}; i < uploads.size(); ++i) {
+    offsets[i] = stagingSize;
+    stagingSize += (arrayLevelSize(textureArrays_[uploads[i].array].layout,
+                                   uploads[i].level) +
+                    STAGING_ALIGNMENT - 1) /
+                   STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+  }
+  StagingBuffer staging = createStagingBuffer(stagingSize);
+  for (size_t i{0}; i < uploads.size(); ++i) {
+    VkDeviceSize offset = offsets[i];
+    for (uint32_t texture : textureArrays_[uploads[i].array].layout.textures) {
+      const TextureView& view = textureBatch_.views[texture];
+      const TextureLevel& level = view.levels[uploads[i].level];
+      memcpy(staging.data + offset, view.data + level.offset,
+             static_cast<size_t>(level.size));
+      offset += level.size;
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(singleTimeCommandsMutex_);
   VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+  for (size_t i{0}; i < uploads.size(); ++i) {
+    const TextureArray& array = textureArrays_[uploads[i].array];
+    const uint32_t level = uploads[i].level;
+    const auto layerCount =
+        static_cast<uint32_t>(array.layout.textures.size());
+    transitionImageLayout(commandBuffer, array.image,
+                          VK_IMAGE_LAYOUT_UNDEFINED,
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, level, 1,
+                          layerCount);
+    VkDeviceSize offset = offsets[i];
+    for (uint32_t layer{0}; layer < layerCount; ++layer) {
+      const TextureView& view =
+          textureBatch_.views[array.layout.textures[layer]];
+      copyBufferToImage(commandBuffer, staging.buffer, offset, array.image,
+                        layer, view, level, 1);
+      offset += view.levels[level].size;
+    }
+    transitionImageLayout(commandBuffer, array.image,
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, level, 1,
+                          layerCount);
+  }
+  endSingleTimeCommands(commandBuffer, lock);
+  destroyStagingBuffer(staging);
+  return uploads;
+}
+
+// Like the texture cache: the pages come from the pack, or from the tiled
+// file next to the source if that is current and in the requested format.
+// Otherwise the source is decoded and tiled here, once. Pages are read in
+// place, so a pack has to carry them already tiled.
+void Application::loadVirtualTexture() {
+  if (!options_.virtualTexture) {
+    return;
+  }
+  const std::string name = TEXTURE_NAME + VIRTUAL_TEXTURE_EXTENSION;
+  if (assetPack_.isOpen()) {
+    const AssetData packed = assetPack_.view(name);
+    if (packed.data == nullptr ||
+        !virtualTexture_.open(packed.data, packed.size)) {
+      throw std::runtime_error("failed to load virtual texture!");
+    }
+    return;
+  }
+  const std::string sourcePath = ASSET_DIR + TEXTURE_NAME;
+  const std::string path = ASSET_DIR + name;
+  if (virtualTexture_.open(path, sourcePath)) {
+    if (virtualTexture_.format() == options_.textureFormat) {
+      return;
+    }
+    virtualTexture_.close();
+  }
 
-  VkImageMemoryBarrier barrier{};
-  barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-  barrier.image = image;
-  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-  barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  barrier.subresourceRange.baseArrayLayer = 0;
-  barrier.subresourceRange.layerCount = 1;
-  barrier.subresourceRange.levelCount = 1;
+  std::vector<uint8_t> storage;
+  const AssetData file = findAsset(TEXTURE_NAME, storage);
+  int width{0};
+  int height{0};
+  int texChannels{0};
+  stbi_uc* pixels =
+      stbi_load_from_memory(file.data, static_cast<int>(file.size), &width,
+                            &height, &texChannels, STBI_rgb_alpha);
+  if (pixels == nullptr) {
+    throw std::runtime_error("failed to load texture image!");
+  }
+  const bool written = VirtualTextureFile::write(
+      path, sourcePath, pixels, static_cast<uint32_t>(width),
+      static_cast<uint32_t>(height), options_.textureFormat);
+  stbi_image_free(pixels);
+  if (!written || !virtualTexture_.open(path, sourcePath)) {
+    throw std::runtime_error("failed to write virtual texture!");
+  }
+}
 
-  int32_t mipWidth = texWidth;
-  int32_t mipHeight = texHeight;
+// The atlas is the only image the virtual texture occupies, whatever the
+// size of the source. Before the first frame it holds the root page, which
+// the whole page table points at.
+void Application::createVirtualTexture() {
+  if (!options_.virtualTexture) {
+    return;
+  }
+  const VkFormat format = virtualTexture_.format();
+  const uint32_t atlasSize = PAGE_ATLAS_SLOTS_PER_ROW * VIRTUAL_PAGE_STRIDE;
+  createImage(atlasSize, atlasSize, 1, 1, VK_SAMPLE_COUNT_1_BIT, format,
+              VK_IMAGE_TILING_OPTIMAL,
+              VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, pageAtlas_,
+              pageAtlasMemory_);
+  pageAtlasView_ =
+      createImageView(pageAtlas_, format, VK_IMAGE_ASPECT_COLOR_BIT, 1);
+
+  // Pages have their own borders and the shader picks the level, so the
+  // atlas is sampled bilinearly at its only level, without anisotropy.
+  VkSamplerCreateInfo samplerInfo{};
+  samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+  samplerInfo.magFilter = VK_FILTER_LINEAR;
+  samplerInfo.minFilter = VK_FILTER_LINEAR;
+  samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  samplerInfo.anisotropyEnable = VK_FALSE;
+  samplerInfo.maxAnisotropy = 1.0f;
+  samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+  samplerInfo.unnormalizedCoordinates = VK_FALSE;
+  samplerInfo.compareEnable = VK_FALSE;
+  samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+  samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+  samplerInfo.minLod = 0.0f;
+  samplerInfo.maxLod = 0.0f;
+  samplerInfo.mipLodBias = 0.0f;
+  if (vkCreateSampler(device_, &samplerInfo, nullptr, &pageAtlasSampler_) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("failed to create page atlas sampler!");
+  }
 
-  for (uint32_t i = 1; i < mipLevels; i++) {
-    barrier.subresourceRange.baseMipLevel = i - 1;
-    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-
-    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
-                         nullptr, 1, &barrier);
-
-    VkImageBlit blit{};
-    blit.srcOffsets[0] = {0, 0, 0};
-    blit.srcOffsets[1] = {mipWidth, mipHeight, 1};
-    blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    blit.srcSubresource.mipLevel = i - 1;
-    blit.srcSubresource.baseArrayLayer = 0;
-    blit.srcSubresource.layerCount = 1;
-    blit.dstOffsets[0] = {0, 0, 0};
-    blit.dstOffsets[1] = {mipWidth > 1 ? mipWidth / 2 : 1,
-                          mipHeight > 1 ? mipHeight / 2 : 1, 1};
-    blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    blit.dstSubresource.mipLevel = i;
-    blit.dstSubresource.baseArrayLayer = 0;
-    blit.dstSubresource.layerCount = 1;
-
-    vkCmdBlitImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                   image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit,
-                   VK_FILTER_LINEAR);
-
-    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  pageCache_ = PageCache(virtualTexture_.levels(),
+                         PAGE_ATLAS_SLOTS_PER_ROW * PAGE_ATLAS_SLOTS_PER_ROW);
+  const VkDeviceSize tableSize = pageTableSize();
+  createBuffer(tableSize,
+               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                   VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, pageTableBuffer_,
+               pageTableBufferMemory_);
 
-    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr,
-                         0, nullptr, 1, &barrier);
+  const VkDeviceSize pageBytes = virtualTexture_.pageBytes();
+  StagingBuffer staging = createStagingBuffer(pageBytes + tableSize);
+  memcpy(staging.data, virtualTexture_.page(pageCache_.rootPage()),
+         static_cast<size_t>(pageBytes));
+  writePageTable(staging.data + pageBytes);
 
-    if (mipWidth > 1) {
-      mipWidth /= 2;
+  std::unique_lock<std::mutex> lock(singleTimeCommandsMutex_);
+  VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+  transitionImageLayout(commandBuffer, pageAtlas_, VK_IMAGE_LAYOUT_UNDEFINED,
+                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0, 1, 1);
+  VkBufferImageCopy region{};
+  region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  region.imageSubresource.layerCount = 1;
+  region.imageExtent = {VIRTUAL_PAGE_STRIDE, VIRTUAL_PAGE_STRIDE, 1};
+  vkCmdCopyBufferToImage(commandBuffer, staging.buffer, pageAtlas_,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+  transitionImageLayout(commandBuffer, pageAtlas_,
+                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 0, 1, 1);
+  VkBufferCopy tableCopy{};
+  tableCopy.srcOffset = pageBytes;
+  tableCopy.size = tableSize;
+  vkCmdCopyBuffer(commandBuffer, staging.buffer, pageTableBuffer_, 1,
+                  &tableCopy);
+  endSingleTimeCommands(commandBuffer, lock);
+  destroyStagingBuffer(staging);
+
+  pageLoader_ =
+      std::make_unique<PageLoader>(virtualTexture_, 4 * VIRTUAL_PAGE_UPLOADS);
+}
+
+void Application::destroyVirtualTexture() {
+  pageLoader_.reset();
+  vkDestroySampler(device_, pageAtlasSampler_, nullptr);
+  vkDestroyImageView(device_, pageAtlasView_, nullptr);
+  vkDestroyImage(device_, pageAtlas_, nullptr);
+  vkFreeMemory(device_, pageAtlasMemory_, nullptr);
+  vkDestroyBuffer(device_, pageTableBuffer_, nullptr);
+  vkFreeMemory(device_, pageTableBufferMemory_, nullptr);
+  virtualTexture_.close();
+}
+
+// The caller holds singleTimeCommandsMutex_, since the upload command
+// buffers come from the shared pool.
+void Application::createVirtualTextureFrames() {
+  if (!options_.virtualTexture) {
+    return;
+  }
+  const size_t imageCount = swapChainImages_.size();
+  const VkDeviceSize feedbackSize = pageCache_.pageCount() * sizeof(uint32_t);
+
+  // Read back every frame, so cached memory is preferred where there is
+  // some.
+  VkMemoryPropertyFlags feedbackProperties =
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+  VkPhysicalDeviceMemoryProperties memoryProperties{};
+  vkGetPhysicalDeviceMemoryProperties(physicalDevice_, &memoryProperties);
+  for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+    const VkMemoryPropertyFlags cached =
+        feedbackProperties | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+    if ((memoryProperties.memoryTypes[i].propertyFlags & cached) == cached) {
+      feedbackProperties = cached;
+      break;
     }
-    if (mipHeight > 1) {
-      mipHeight /= 2;
+  }
+
+  feedbackBuffers_.resize(imageCount);
+  feedbackBuffersMemory_.resize(imageCount);
+  feedbackData_.resize(imageCount);
+  feedbackStamps_.assign(imageCount, 0);
+  pageStaging_.resize(imageCount);
+  for (size_t i = 0; i < imageCount; i++) {
+    createBuffer(feedbackSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                 feedbackProperties, feedbackBuffers_[i],
+                 feedbackBuffersMemory_[i]);
+    void* data{nullptr};
+    if (vkMapMemory(device_, feedbackBuffersMemory_[i], 0, feedbackSize, 0,
+                    &data) != VK_SUCCESS) {
+      throw std::runtime_error("failed to map feedback buffer!");
     }
+    memset(data, 0, static_cast<size_t>(feedbackSize));
+    feedbackData_[i] = static_cast<const uint32_t*>(data);
+    pageStaging_[i] = createStagingBuffer(
+        VIRTUAL_PAGE_UPLOADS * virtualTexture_.pageBytes() + pageTableSize());
+  }
+
+  pageUploadCommandBuffers_.resize(imageCount);
+  VkCommandBufferAllocateInfo allocInfo{};
+  allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  allocInfo.commandPool = commandPool_;
+  allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  allocInfo.commandBufferCount = static_cast<uint32_t>(imageCount);
+  if (vkAllocateCommandBuffers(device_, &allocInfo,
+                               pageUploadCommandBuffers_.data()) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("failed to allocate command buffers!");
   }
+}
 
-  barrier.subresourceRange.baseMipLevel = mipLevels - 1;
-  barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-  barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+void Application::destroyVirtualTextureFrames() {
+  if (!pageUploadCommandBuffers_.empty()) {
+    vkFreeCommandBuffers(
+        device_, commandPool_,
+        static_cast<uint32_t>(pageUploadCommandBuffers_.size()),
+        pageUploadCommandBuffers_.data());
+    pageUploadCommandBuffers_.clear();
+  }
+  for (size_t i = 0; i < feedbackBuffers_.size(); i++) {
+    vkUnmapMemory(device_, feedbackBuffersMemory_[i]);
+    vkDestroyBuffer(device_, feedbackBuffers_[i], nullptr);
+    vkFreeMemory(device_, feedbackBuffersMemory_[i], nullptr);
+  }
+  feedbackBuffers_.clear();
+  feedbackBuffersMemory_.clear();
+  feedbackData_.clear();
+  for (StagingBuffer& staging : pageStaging_) {
+    destroyStagingBuffer(staging);
+  }
+  pageStaging_.clear();
+}
+
+VkDeviceSize Application::pageTableSize() const {
+  return sizeof(PageTableHeader) + pageCache_.pageCount() * sizeof(uint32_t);
+}
+
+// Writes the contents of the page table buffer to `data` and returns their
+// size.
+VkDeviceSize Application::writePageTable(uint8_t* data) {
+  PageTableHeader header{};
+  const std::vector<VirtualLevel> levels = virtualTexture_.levels();
+  header.levelCount = static_cast<uint32_t>(levels.size());
+  header.slotsPerRow = PAGE_ATLAS_SLOTS_PER_ROW;
+  header.atlasSize = PAGE_ATLAS_SLOTS_PER_ROW * VIRTUAL_PAGE_STRIDE;
+  for (size_t i{0}; i < levels.size(); ++i) {
+    header.levels[i][0] = levels[i].width;
+    header.levels[i][1] = levels[i].height;
+    header.levels[i][2] = levels[i].pagesX;
+    header.levels[i][3] = levels[i].firstPage;
+  }
+  const std::vector<uint32_t>& table = pageCache_.table();
+  memcpy(data, &header, sizeof(header));
+  memcpy(data + sizeof(header), table.data(), table.size() * sizeof(uint32_t));
+  return pageTableSize();
+}
+
+// Runs once the image's last frame has completed. The pages that frame
+// sampled are requested, and pages the loader has finished since are staged
+// with the updated page table and recorded into the image's upload command
+// buffer. Returns false if there was nothing to upload.
+bool Application::recordPageUploads(size_t image) {
+  std::vector<uint32_t> sampled;
+  if (feedbackStamps_[image] != 0) {
+    const uint32_t* feedback = feedbackData_[image];
+    for (uint32_t page{0}; page < pageCache_.pageCount(); ++page) {
+      if (feedback[page] == feedbackStamps_[image]) {
+        sampled.push_back(page);
+      }
+    }
+  }
+  // As written to the uniform buffer by updateUniformBuffer().
+  feedbackStamps_[image] = static_cast<uint32_t>(submittedFrames_ + 1);
+  pageLoader_->request(pageCache_.request(sampled, submittedFrames_));
+
+  StagingBuffer& staging = pageStaging_[image];
+  const VkDeviceSize pageBytes = virtualTexture_.pageBytes();
+  std::vector<VkBufferImageCopy> regions;
+  for (const LoadedPage& loaded :
+       pageLoader_->takeLoaded(VIRTUAL_PAGE_UPLOADS)) {
+    const uint32_t slot = pageCache_.map(loaded.page, submittedFrames_);
+    if (slot == NO_PAGE_SLOT) {
+      continue;
+    }
+    VkBufferImageCopy region{};
+    region.bufferOffset = regions.size() * pageBytes;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = {
+        static_cast<int32_t>(slot % PAGE_ATLAS_SLOTS_PER_ROW *
+                             VIRTUAL_PAGE_STRIDE),
+        static_cast<int32_t>(slot / PAGE_ATLAS_SLOTS_PER_ROW *
+                             VIRTUAL_PAGE_STRIDE),
+        0};
+    region.imageExtent = {VIRTUAL_PAGE_STRIDE, VIRTUAL_PAGE_STRIDE, 1};
+    memcpy(staging.data + region.bufferOffset, loaded.data.data(),
+           loaded.data.size());
+    regions.push_back(region);
+  }
+  if (regions.empty()) {
+    return false;
+  }
+  VkBufferCopy tableCopy{};
+  tableCopy.srcOffset = VIRTUAL_PAGE_UPLOADS * pageBytes;
+  tableCopy.size = writePageTable(staging.data + tableCopy.srcOffset);
+
+  VkCommandBuffer commandBuffer = pageUploadCommandBuffers_[image];
+  VkCommandBufferBeginInfo beginInfo{};
+  beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+    throw std::runtime_error("failed to begin recording command buffer!");
+  }
+
+  // Earlier frames may still be reading the slots and the table.
+  transitionImageLayout(commandBuffer, pageAtlas_,
+                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0, 1, 1);
+  vkCmdCopyBufferToImage(commandBuffer, staging.buffer, pageAtlas_,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         static_cast<uint32_t>(regions.size()),
+                         regions.data());
+  transitionImageLayout(commandBuffer, pageAtlas_,
+                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 0, 1, 1);
+
+  VkBufferMemoryBarrier barrier{};
+  barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+  barrier.srcAccessMask = 0;
+  barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.buffer = pageTableBuffer_;
+  barrier.offset = 0;
+  barrier.size = VK_WHOLE_SIZE;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 1,
+                       &barrier, 0, nullptr);
+  vkCmdCopyBuffer(commandBuffer, staging.buffer, pageTableBuffer_, 1,
+                  &tableCopy);
   barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
   barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
   vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                       VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0,
-                       nullptr, 1, &barrier);
+                       VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr,
+                       1, &barrier, 0, nullptr);
 
-  endSingleTimeCommands(commandBuffer);
+  if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+    throw std::runtime_error("failed to record command buffer!");
+  }
+  return true;
 }
 
 VkSampleCountFlagBits Application::getMaxUsableSampleCount() {
@@ -1197,9 +2326,37 @@ VkSampleCountFlagBits Application::getMaxUsableSampleCount() {
   return VK_SAMPLE_COUNT_1_BIT;
 }
 
-void Application::createTextureImageView() {
-  textureImageView_ = createImageView(textureImage_, VK_FORMAT_R8G8B8A8_SRGB,
-                                      VK_IMAGE_ASPECT_COLOR_BIT, mipLevels_);
+// One layer of `array`, down from its finest resident level.
+VkImageView Application::createTextureImageView(const TextureArray& array,
+                                                uint32_t layer) {
+  return createImageView(array.image, array.layout.format,
+                         VK_IMAGE_ASPECT_COLOR_BIT,
+                         array.layout.levelCount - array.residentLevel,
+                         array.residentLevel, layer);
+}
+
+// A view of every texture in `arrays`, in the order of their batch of
+// textureCount textures. Textures in no array, and views not created when
+// this throws, are left null.
+void Application::createTextureImageViews(
+    const std::vector<TextureArray>& arrays, size_t textureCount,
+    std::vector<VkImageView>& views) {
+  views.assign(textureCount, VK_NULL_HANDLE);
+  for (const TextureArray& array : arrays) {
+    for (uint32_t layer{0}; layer < array.layout.textures.size(); ++layer) {
+      views[array.layout.textures[layer]] =
+          createTextureImageView(array, layer);
+    }
+  }
+}
+
+void Application::destroyTextureImageViews(std::vector<VkImageView>& views) {
+  for (VkImageView view : views) {
+    if (view != VK_NULL_HANDLE) {
+      vkDestroyImageView(device_, view, nullptr);
+    }
+  }
+  views.clear();
 }
 
 void Application::createTextureSampler() {
@@ -1218,7 +2375,9 @@ void Application::createTextureSampler() {
   samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
   samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
   samplerInfo.minLod = 0.0f;
-  samplerInfo.maxLod = static_cast<float>(mipLevels_);
+  // Not clamped to the texture's mip chain, so the sampler also fits a
+  // reloaded texture of another size.
+  samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
   samplerInfo.mipLodBias = 0.0f;
 
   if (vkCreateSampler(device_, &samplerInfo, nullptr, &textureSampler_) !=
@@ -1229,16 +2388,18 @@ void Application::createTextureSampler() {
 
 VkImageView Application::createImageView(VkImage image, VkFormat format,
                                          VkImageAspectFlags aspectFlags,
-                                         uint32_t mipLevels) {
+                                         uint32_t mipLevels,
+                                         uint32_t baseMipLevel,
+                                         uint32_t baseArrayLayer) {
   VkImageViewCreateInfo viewInfo{};
   viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
   viewInfo.image = image;
   viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
   viewInfo.format = format;
   viewInfo.subresourceRange.aspectMask = aspectFlags;
-  viewInfo.subresourceRange.baseMipLevel = 0;
+  viewInfo.subresourceRange.baseMipLevel = baseMipLevel;
   viewInfo.subresourceRange.levelCount = mipLevels;
-  viewInfo.subresourceRange.baseArrayLayer = 0;
+  viewInfo.subresourceRange.baseArrayLayer = baseArrayLayer;
   viewInfo.subresourceRange.layerCount = 1;
 
   VkImageView imageView{nullptr};
@@ -1251,7 +2412,7 @@ VkImageView Application::createImageView(VkImage image, VkFormat format,
 }
 
 void Application::createImage(uint32_t width, uint32_t height,
-                              uint32_t mipLevels,
+                              uint32_t mipLevels, uint32_t arrayLayers,
                               VkSampleCountFlagBits numSamples, VkFormat format,
                               VkImageTiling tiling, VkImageUsageFlags usage,
                               VkMemoryPropertyFlags properties, VkImage& image,
@@ -1263,7 +2424,7 @@ void Application::createImage(uint32_t width, uint32_t height,
   imageInfo.extent.height = height;
   imageInfo.extent.depth = 1;
   imageInfo.mipLevels = mipLevels;
-  imageInfo.arrayLayers = 1;
+  imageInfo.arrayLayers = arrayLayers;
   imageInfo.format = format;
   imageInfo.tiling = tiling;
   imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -1292,12 +2453,14 @@ void Application::createImage(uint32_t width, uint32_t height,
   vkBindImageMemory(device_, image, imageMemory, 0);
 }
 
-void Application::transitionImageLayout(VkImage image, VkFormat format,
-                                        VkImageLayout oldLayout,
+// Records the barrier into commandBuffer, so that several transitions and
+// copies share one submission.
+void Application::transitionImageLayout(VkCommandBuffer commandBuffer,
+                                        VkImage image, VkImageLayout oldLayout,
                                         VkImageLayout newLayout,
-                                        uint32_t mipLevels) {
-  VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
+                                        uint32_t baseMipLevel,
+                                        uint32_t mipLevels,
+                                        uint32_t layerCount) {
   VkImageMemoryBarrier barrier{};
   barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
   barrier.oldLayout = oldLayout;
@@ -1306,10 +2469,10 @@ void Application::transitionImageLayout(VkImage image, VkFormat format,
   barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
   barrier.image = image;
   barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  barrier.subresourceRange.baseMipLevel = 0;
+  barrier.subresourceRange.baseMipLevel = baseMipLevel;
   barrier.subresourceRange.levelCount = mipLevels;
   barrier.subresourceRange.baseArrayLayer = 0;
-  barrier.subresourceRange.layerCount = 1;
+  barrier.subresourceRange.layerCount = layerCount;
 
   VkPipelineStageFlags sourceStage{0};
   VkPipelineStageFlags destinationStage{0};
@@ -1328,126 +2491,257 @@ void Application::transitionImageLayout(VkImage image, VkFormat format,
 
     sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
     destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+  } else if (oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL &&
+             newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
+    // Copies into an image that earlier frames may still sample.
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    sourceStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
   } else {
     throw std::invalid_argument("unsupported layout transition!");
   }
 
   vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 0,
                        nullptr, 0, nullptr, 1, &barrier);
+}
+
+// One region per mip level of one array layer, read from `offset` into the
+// buffer. Each region covers its whole level, so levels of a
+// block-compressed texture that are not a multiple of the block size (the
+// last few, down to 1x1) are still valid copies of their partial blocks.
+// Copies levels [firstLevel, firstLevel + levelCount) of `texture`, which
+// sit in `buffer` from `offset` on as they do in the texture's data.
+void Application::copyBufferToImage(VkCommandBuffer commandBuffer,
+                                    VkBuffer buffer, VkDeviceSize offset,
+                                    VkImage image, uint32_t layer,
+                                    const TextureView& texture,
+                                    uint32_t firstLevel, uint32_t levelCount) {
+  std::vector<VkBufferImageCopy> regions(levelCount);
+  for (uint32_t i{0}; i < levelCount; ++i) {
+    const uint32_t level = firstLevel + i;
+    VkBufferImageCopy& region = regions[i];
+    region.bufferOffset = offset + texture.levels[level].offset -
+                          texture.levels[firstLevel].offset;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = level;
+    region.imageSubresource.baseArrayLayer = layer;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = {0, 0, 0};
+    region.imageExtent = {texture.levels[level].width,
+                          texture.levels[level].height, 1};
+  }
 
-  endSingleTimeCommands(commandBuffer);
+  vkCmdCopyBufferToImage(commandBuffer, buffer, image,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         static_cast<uint32_t>(regions.size()),
+                         regions.data());
 }
 
-void Application::copyBufferToImage(VkBuffer buffer, VkImage image,
-                                    uint32_t width, uint32_t height) {
-  VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+void Application::loadModel() {
+  // A packed mesh cache is used in place, straight from the mapping.
+  const AssetData cooked = assetPack_.view(MODEL_NAME + MESH_CACHE_EXTENSION);
+  if (cooked.data != nullptr && meshCache_.open(cooked.data, cooked.size)) {
+    mesh_ = meshCache_.view();
+    return;
+  }
+  const std::string cachePath = MODEL_PATH + MESH_CACHE_EXTENSION;
+  if (!assetPack_.isOpen() && meshCache_.open(cachePath, MODEL_PATH)) {
+    mesh_ = meshCache_.view();
+    return;
+  }
 
-  VkBufferImageCopy region{};
-  region.bufferOffset = 0;
-  region.bufferRowLength = 0;
-  region.bufferImageHeight = 0;
-  region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  region.imageSubresource.mipLevel = 0;
-  region.imageSubresource.baseArrayLayer = 0;
-  region.imageSubresource.layerCount = 1;
-  region.imageOffset = {0, 0, 0};
-  region.imageExtent = {width, height, 1};
+  scene_ = buildScene(importModel());
+  mesh_ = scene_.view();
+  const MeshOptimizationStats& stats = scene_.stats;
 
-  vkCmdCopyBufferToImage(commandBuffer, buffer, image,
-                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+  std::cout << MODEL_PATH << ": ACMR " << stats.before.acmr << " -> "
+            << stats.after.acmr << ", ATVR " << stats.before.atvr << " -> "
+            << stats.after.atvr << '\n';
+  std::cout << mesh_.partCount << " parts\n";
+  for (uint32_t lod = 0; lod < mesh_.lodCount; lod++) {
+    std::cout << "LOD " << lod << ": " << mesh_.lods[lod].indexCount / 3
+              << " triangles, error " << mesh_.lods[lod].error << '\n';
+  }
 
-  endSingleTimeCommands(commandBuffer);
+  // A pack is left as shipped; it should carry the cooked mesh instead.
+  if (!assetPack_.isOpen() &&
+      !MeshCache::write(cachePath, MODEL_PATH, mesh_,
+                        options_.meshCompression)) {
+    std::cerr << "failed to write mesh cache " << cachePath << '\n';
+  }
 }
 
-void Application::loadModel() {
-  std::future<void> loadModelFuture = std::async(std::launch::async, [&]() {
-    Assimp::Importer importer;
-    const auto* scene = importer.ReadFile(
-        MODEL_PATH.data(), aiProcess_Triangulate | aiProcess_FlipUVs);
-    if (scene == nullptr ||
-        ((scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) != 0u) ||
-        scene->mRootNode == nullptr) {
-      throw std::runtime_error("Error::Assimp::" +
-                               std::string(importer.GetErrorString()));
-    }
-    if (!scene->HasMeshes()) {
-      throw std::runtime_error("Error::Assimp::" +
-                               std::string(importer.GetErrorString()));
-    }
-    std::unordered_map<Vertex, uint32_t> uniqueVertices{};
-    for (unsigned int i{0}; i < scene->mNumMeshes; ++i) {
-      const auto* mesh = scene->mMeshes[i];
-      for (unsigned int j{0}; j < mesh->mNumVertices; ++j) {
-        auto mVertex = mesh->mVertices[j];
-        Vertex vertex{};
-        vertex.color = {1.0f, 1.0f, 1.0f};
-        vertex.pos = {mVertex.x, mVertex.y, mVertex.z};
-        if (mesh->mTextureCoords[0] == nullptr) {
-          vertex.texCoord = {0.0f, 0.0f};
-        } else {
-          vertex.texCoord = {mesh->mTextureCoords[0][j].x,
-                             mesh->mTextureCoords[0][j].y};
-        }
-        if (uniqueVertices.count(vertex) == 0) {
-          uniqueVertices[vertex] = static_cast<uint32_t>(vertices_.size());
-          vertices_.push_back(vertex);
-        }
-        indices_.push_back(uniqueVertices[vertex]);
-      }
-    }
-  });
+std::vector<ImportedPart> Application::importModel() const {
+  if (!assetPack_.isOpen()) {
+    return importScene(MODEL_PATH, options_.importer);
+  }
+  std::vector<uint8_t> storage;
+  const AssetData model = findAsset(MODEL_NAME, storage);
+  return importScene(model.data, model.size, MODEL_NAME, options_.importer);
 }
 
-void Application::createVertexBuffer() {
-  VkDeviceSize bufferSize = sizeof(vertices_[0]) * vertices_.size();
+void Application::createVertexBuffer(const MeshView& mesh,
+                                     StagingBuffer& staging, VkBuffer& buffer,
+                                     VkDeviceMemory& bufferMemory) {
+  const VkDeviceSize bufferSize =
+      vertexBufferSize(mesh, options_.vertexFormat);
 
-  VkBuffer stagingBuffer{nullptr};
-  VkDeviceMemory stagingBufferMemory{nullptr};
-  createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-               stagingBuffer, stagingBufferMemory);
+  // Converted straight into the staging memory, without a copy in between.
+  void* data = stageBuffer(staging, bufferSize,
+                           VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, buffer,
+                           bufferMemory);
+  if (options_.vertexFormat == VertexFormat::Compact) {
+    compactVertices(mesh.vertices, mesh.vertexCount, mesh.bounds,
+                    static_cast<CompactVertex*>(data));
+  } else if (options_.vertexFormat == VertexFormat::Split) {
+    splitVertices(mesh.vertices, mesh.vertexCount, static_cast<uint8_t*>(data));
+  } else {
+    memcpy(data, mesh.vertices, (size_t)bufferSize);
+  }
+}
 
-  void* data{nullptr};
-  vkMapMemory(device_, stagingBufferMemory, 0, bufferSize, 0, &data);
-  memcpy(data, vertices_.data(), (size_t)bufferSize);
-  vkUnmapMemory(device_, stagingBufferMemory);
+void Application::createIndexBuffer(const MeshView& mesh,
+                                    StagingBuffer& staging, VkBuffer& buffer,
+                                    VkDeviceMemory& bufferMemory) {
+  VkDeviceSize bufferSize = VkDeviceSize{mesh.indexSize} * mesh.indexCount;
 
-  createBuffer(
-      bufferSize,
-      VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vertexBuffer_, vertexBufferMemory_);
+  void* data = stageBuffer(staging, bufferSize,
+                           VK_BUFFER_USAGE_INDEX_BUFFER_BIT, buffer,
+                           bufferMemory);
+  memcpy(data, mesh.indices, (size_t)bufferSize);
+}
 
-  copyBuffer(stagingBuffer, vertexBuffer_, bufferSize);
+void Application::createPartBuffer(const MeshView& mesh,
+                                   StagingBuffer& staging, VkBuffer& buffer,
+                                   VkDeviceMemory& bufferMemory) {
+  // A mesh without parts is drawn as one, untransformed.
+  const MeshPart identity{};
+  const MeshPart* parts = mesh.partCount != 0 ? mesh.parts : &identity;
+  const uint32_t partCount = std::max(mesh.partCount, 1u);
+  VkDeviceSize bufferSize = sizeof(MeshPart) * partCount;
 
-  vkDestroyBuffer(device_, stagingBuffer, nullptr);
-  vkFreeMemory(device_, stagingBufferMemory, nullptr);
+  void* data = stageBuffer(staging, bufferSize,
+                           VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, buffer,
+                           bufferMemory);
+  memcpy(data, parts, (size_t)bufferSize);
 }
 
-void Application::createIndexBuffer() {
-  VkDeviceSize bufferSize = sizeof(indices_[0]) * indices_.size();
+bool Application::canCullMeshlets(const MeshView& mesh) {
+  VkPhysicalDeviceProperties properties{};
+  vkGetPhysicalDeviceProperties(physicalDevice_, &properties);
+  if (mesh.meshletCount > properties.limits.maxDrawIndirectCount) {
+    std::cerr << "too many meshlets for one indirect draw\n";
+    return false;
+  }
+  return mesh.meshletCount != 0;
+}
 
-  VkBuffer stagingBuffer;
-  VkDeviceMemory stagingBufferMemory;
-  createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-               stagingBuffer, stagingBufferMemory);
+void Application::createMeshletBuffer(const MeshView& mesh,
+                                      StagingBuffer& staging, VkBuffer& buffer,
+                                      VkDeviceMemory& bufferMemory) {
+  if (!meshletCulling_) {
+    return;
+  }
 
-  void* data{nullptr};
-  vkMapMemory(device_, stagingBufferMemory, 0, bufferSize, 0, &data);
-  memcpy(data, indices_.data(), (size_t)bufferSize);
-  vkUnmapMemory(device_, stagingBufferMemory);
+  VkDeviceSize bufferSize = sizeof(Meshlet) * mesh.meshletCount;
 
-  createBuffer(
-      bufferSize,
-      VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, indexBuffer_, indexBufferMemory_);
+  void* data = stageBuffer(staging, bufferSize,
+                           VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, buffer,
+                           bufferMemory);
+  memcpy(data, mesh.meshlets, (size_t)bufferSize);
+}
 
-  copyBuffer(stagingBuffer, indexBuffer_, bufferSize);
+// Once uploaded, the buffers hold the only copies of the vertices, indices
+// and meshlets that drawing needs. mesh_ keeps its counts, ranges, levels of
+// detail and parts.
+void Application::releaseGeometry() {
+  if (options_.keepGeometry) {
+    return;
+  }
+  const MemoryUsage before = queryMemoryUsage();
+  scene_.releaseGeometry();
+  meshCache_.releaseGeometry();
+  mesh_.vertices = nullptr;
+  mesh_.indices = nullptr;
+  mesh_.meshlets = nullptr;
+  std::cout << "memory before releasing geometry: " << before
+            << "\nmemory after: " << queryMemoryUsage() << '\n';
+}
+
+void Application::createCullPipeline() {
+  if (!meshletCulling_) {
+    return;
+  }
 
-  vkDestroyBuffer(device_, stagingBuffer, nullptr);
-  vkFreeMemory(device_, stagingBufferMemory, nullptr);
+  std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+  bindings[0].binding = 0;
+  bindings[0].descriptorCount = 1;
+  bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+  bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+  bindings[1].binding = 1;
+  bindings[1].descriptorCount = 1;
+  bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+  bindings[2].binding = 2;
+  bindings[2].descriptorCount = 1;
+  bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  bindings[2].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+  VkDescriptorSetLayoutCreateInfo layoutInfo{};
+  layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+  layoutInfo.pBindings = bindings.data();
+
+  if (vkCreateDescriptorSetLayout(device_, &layoutInfo, nullptr,
+                                  &cullDescriptorSetLayout_) != VK_SUCCESS) {
+    throw std::runtime_error("failed to create descriptor set layout!");
+  }
+
+  VkPushConstantRange pushConstantRange{};
+  pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+  pushConstantRange.offset = 0;
+  pushConstantRange.size = sizeof(CullParams);
+
+  VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+  pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+  pipelineLayoutInfo.setLayoutCount = 1;
+  pipelineLayoutInfo.pSetLayouts = &cullDescriptorSetLayout_;
+  pipelineLayoutInfo.pushConstantRangeCount = 1;
+  pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+  if (vkCreatePipelineLayout(device_, &pipelineLayoutInfo, nullptr,
+                             &cullPipelineLayout_) != VK_SUCCESS) {
+    throw std::runtime_error("failed to create pipeline layout!");
+  }
+
+  cullPipeline_ = createComputePipeline(cullShaderCode_, cullPipelineLayout_);
+}
+
+VkPipeline Application::createComputePipeline(const std::vector<char>& code,
+                                               VkPipelineLayout layout) {
+  VkShaderModule shaderModule = createShaderModule(code);
+
+  VkComputePipelineCreateInfo pipelineInfo{};
+  pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+  pipelineInfo.stage.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+  pipelineInfo.stage.module = shaderModule;
+  pipelineInfo.stage.pName = "main";
+  pipelineInfo.layout = layout;
+
+  VkPipeline pipeline{};
+  const VkResult result = vkCreateComputePipelines(
+      device_, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
+  vkDestroyShaderModule(device_, shaderModule, nullptr);
+  if (result != VK_SUCCESS) {
+    throw std::runtime_error("failed to create compute pipeline!");
+  }
+  return pipeline;
 }
 
 void Application::createUniformBuffers() {
@@ -1464,18 +2758,59 @@ void Application::createUniformBuffers() {
   }
 }
 
+void Application::createDrawBuffers() {
+  if (!meshletCulling_) {
+    return;
+  }
+
+  drawBuffers_.resize(swapChainImages_.size());
+  drawBuffersMemory_.resize(swapChainImages_.size());
+
+  for (size_t i = 0; i < swapChainImages_.size(); i++) {
+    createDrawBuffer(drawBuffers_[i], drawBuffersMemory_[i]);
+  }
+}
+
+void Application::createDrawBuffer(VkBuffer& buffer,
+                                   VkDeviceMemory& bufferMemory) {
+  VkDeviceSize bufferSize =
+      DRAW_COMMANDS_OFFSET +
+      sizeof(VkDrawIndexedIndirectCommand) * mesh_.meshletCount;
+
+  createBuffer(bufferSize,
+               VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                   VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer, bufferMemory);
+}
+
 void Application::createDescriptorPool() {
-  std::array<VkDescriptorPoolSize, 2> poolSizes{};
+  // The culling sets need another uniform buffer and two storage buffers per
+  // swap chain image.
+  const uint32_t setsPerImage = meshletCulling_ ? 2 : 1;
+  // Virtual texturing adds an image and two storage buffers.
+  const uint32_t virtualDescriptors = options_.virtualTexture ? 1 : 0;
+  const auto imageCount = static_cast<uint32_t>(swapChainImages_.size());
+
+  std::array<VkDescriptorPoolSize, 3> poolSizes{};
   poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-  poolSizes[0].descriptorCount = static_cast<uint32_t>(swapChainImages_.size());
+  poolSizes[0].descriptorCount = imageCount * setsPerImage;
   poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-  poolSizes[1].descriptorCount = static_cast<uint32_t>(swapChainImages_.size());
+  poolSizes[1].descriptorCount =
+      imageCount * (textureSlotCount() + virtualDescriptors);
+  // Two for the culling sets and one for the texture transforms.
+  poolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  poolSizes[2].descriptorCount = imageCount * (3 + 2 * virtualDescriptors);
 
   VkDescriptorPoolCreateInfo poolInfo{};
   poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  // For the texture table; the culling sets do without.
+  if (textureTable_) {
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+  }
   poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
   poolInfo.pPoolSizes = poolSizes.data();
-  poolInfo.maxSets = static_cast<uint32_t>(swapChainImages_.size());
+  poolInfo.maxSets = imageCount * setsPerImage;
 
   if (vkCreateDescriptorPool(device_, &poolInfo, nullptr, &descriptorPool_) !=
       VK_SUCCESS) {
@@ -1498,40 +2833,192 @@ void Application::createDescriptorSets() {
     throw std::runtime_error("failed to allocate descriptor sets!");
   }
 
-  for (size_t i = 0; i < swapChainImages_.size(); i++) {
-    VkDescriptorBufferInfo bufferInfo{};
-    bufferInfo.buffer = uniformBuffers_[i];
-    bufferInfo.offset = 0;
-    bufferInfo.range = sizeof(UniformBufferObject);
-
-    VkDescriptorImageInfo imageInfo{};
-    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    imageInfo.imageView = textureImageView_;
-    imageInfo.sampler = textureSampler_;
-
-    std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
+  if (meshletCulling_) {
+    std::vector<VkDescriptorSetLayout> cullLayouts(swapChainImages_.size(),
+                                                   cullDescriptorSetLayout_);
+    allocInfo.pSetLayouts = cullLayouts.data();
 
-    descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    descriptorWrites[0].dstSet = descriptorSets_[i];
-    descriptorWrites[0].dstBinding = 0;
-    descriptorWrites[0].dstArrayElement = 0;
-    descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    descriptorWrites[0].descriptorCount = 1;
-    descriptorWrites[0].pBufferInfo = &bufferInfo;
+    cullDescriptorSets_.resize(swapChainImages_.size());
+    if (vkAllocateDescriptorSets(device_, &allocInfo,
+                                 cullDescriptorSets_.data()) != VK_SUCCESS) {
+      throw std::runtime_error("failed to allocate descriptor sets!");
+    }
+  }
 
-    descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    descriptorWrites[1].dstSet = descriptorSets_[i];
-    descriptorWrites[1].dstBinding = 1;
-    descriptorWrites[1].dstArrayElement = 0;
-    descriptorWrites[1].descriptorType =
-        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    descriptorWrites[1].descriptorCount = 1;
-    descriptorWrites[1].pImageInfo = &imageInfo;
+  writtenTextureGenerations_.resize(swapChainImages_.size());
+  for (size_t i = 0; i < swapChainImages_.size(); i++) {
+    writeDescriptorSets(i);
+  }
+}
+
+// Points the descriptor sets of one swap chain image at the current
+// resources. The sets must not be in use by a pending frame.
+void Application::writeDescriptorSets(size_t image) {
+  VkDescriptorBufferInfo bufferInfo{};
+  bufferInfo.buffer = uniformBuffers_[image];
+  bufferInfo.offset = 0;
+  bufferInfo.range = sizeof(UniformBufferObject);
+
+  VkDescriptorBufferInfo transformInfo{};
+  transformInfo.buffer = textureAtlas_.transformBuffer;
+  transformInfo.offset = 0;
+  transformInfo.range = VK_WHOLE_SIZE;
+
+  std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
+  descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  descriptorWrites[0].dstSet = descriptorSets_[image];
+  descriptorWrites[0].dstBinding = 0;
+  descriptorWrites[0].dstArrayElement = 0;
+  descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+  descriptorWrites[0].descriptorCount = 1;
+  descriptorWrites[0].pBufferInfo = &bufferInfo;
+  descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  descriptorWrites[1].dstSet = descriptorSets_[image];
+  descriptorWrites[1].dstBinding = TEXTURE_TRANSFORM_BINDING;
+  descriptorWrites[1].dstArrayElement = 0;
+  descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  descriptorWrites[1].descriptorCount = 1;
+  descriptorWrites[1].pBufferInfo = &transformInfo;
+
+  vkUpdateDescriptorSets(device_,
+                         static_cast<uint32_t>(descriptorWrites.size()),
+                         descriptorWrites.data(), 0, nullptr);
+  writeTextureDescriptors(image);
+
+  if (options_.virtualTexture) {
+    VkDescriptorImageInfo atlasInfo{};
+    atlasInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    atlasInfo.imageView = pageAtlasView_;
+    atlasInfo.sampler = pageAtlasSampler_;
+
+    std::array<VkDescriptorBufferInfo, 2> pageBufferInfos{};
+    pageBufferInfos[0].buffer = pageTableBuffer_;
+    pageBufferInfos[0].offset = 0;
+    pageBufferInfos[0].range = VK_WHOLE_SIZE;
+    pageBufferInfos[1].buffer = feedbackBuffers_[image];
+    pageBufferInfos[1].offset = 0;
+    pageBufferInfos[1].range = VK_WHOLE_SIZE;
+
+    std::array<VkWriteDescriptorSet, 3> pageWrites{};
+    for (uint32_t i = 0; i < pageWrites.size(); i++) {
+      pageWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+      pageWrites[i].dstSet = descriptorSets_[image];
+      pageWrites[i].dstBinding = 2 + i;
+      pageWrites[i].dstArrayElement = 0;
+      pageWrites[i].descriptorCount = 1;
+      if (i == 0) {
+        pageWrites[i].descriptorType =
+            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        pageWrites[i].pImageInfo = &atlasInfo;
+      } else {
+        pageWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        pageWrites[i].pBufferInfo = &pageBufferInfos[i - 1];
+      }
+    }
+    vkUpdateDescriptorSets(device_, static_cast<uint32_t>(pageWrites.size()),
+                           pageWrites.data(), 0, nullptr);
+  }
 
-    vkUpdateDescriptorSets(device_,
-                           static_cast<uint32_t>(descriptorWrites.size()),
-                           descriptorWrites.data(), 0, nullptr);
+  if (!meshletCulling_) {
+    return;
   }
+
+  std::array<VkDescriptorBufferInfo, 3> bufferInfos{};
+  bufferInfos[0].buffer = uniformBuffers_[image];
+  bufferInfos[0].offset = 0;
+  bufferInfos[0].range = sizeof(UniformBufferObject);
+  bufferInfos[1].buffer = meshletBuffer_;
+  bufferInfos[1].offset = 0;
+  bufferInfos[1].range = VK_WHOLE_SIZE;
+  bufferInfos[2].buffer = drawBuffers_[image];
+  bufferInfos[2].offset = 0;
+  bufferInfos[2].range = VK_WHOLE_SIZE;
+
+  std::array<VkWriteDescriptorSet, 3> cullWrites{};
+  for (uint32_t binding = 0; binding < cullWrites.size(); binding++) {
+    cullWrites[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    cullWrites[binding].dstSet = cullDescriptorSets_[image];
+    cullWrites[binding].dstBinding = binding;
+    cullWrites[binding].dstArrayElement = 0;
+    cullWrites[binding].descriptorType =
+        binding == 0 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER
+                     : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    cullWrites[binding].descriptorCount = 1;
+    cullWrites[binding].pBufferInfo = &bufferInfos[binding];
+  }
+
+  vkUpdateDescriptorSets(device_, static_cast<uint32_t>(cullWrites.size()),
+                         cullWrites.data(), 0, nullptr);
+}
+
+// Points the texture table of one swap chain image at the current texture
+// views, and the entries of the atlas tiles at the atlas. The table is
+// update-after-bind, so this leaves the image's command buffer valid; the
+// sets must still not be in use by a pending frame. The fixed array is not,
+// and has every entry written: the unused ones repeat the first texture.
+void Application::writeTextureDescriptors(size_t image) {
+  std::vector<VkDescriptorImageInfo> imageInfos(textureImageViews_.size());
+  for (size_t i{0}; i < imageInfos.size(); ++i) {
+    imageInfos[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfos[i].imageView = textureImageViews_[i] != VK_NULL_HANDLE
+                                  ? textureImageViews_[i]
+                                  : textureAtlas_.view;
+    imageInfos[i].sampler = textureSampler_;
+  }
+  if (!textureTable_) {
+    const VkDescriptorImageInfo first = imageInfos[0];
+    imageInfos.resize(MAX_FIXED_TEXTURES, first);
+  }
+
+  VkWriteDescriptorSet descriptorWrite{};
+  descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  descriptorWrite.dstSet = descriptorSets_[image];
+  descriptorWrite.dstBinding = 1;
+  descriptorWrite.dstArrayElement = 0;
+  descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  descriptorWrite.descriptorCount = static_cast<uint32_t>(imageInfos.size());
+  descriptorWrite.pImageInfo = imageInfos.data();
+
+  vkUpdateDescriptorSets(device_, 1, &descriptorWrite, 0, nullptr);
+  writtenTextureGenerations_[image] = textureGeneration_;
+}
+
+// Zeroes the draw list, culls the meshlets into it and makes the result
+// visible to the indirect draw. Recorded before the render pass.
+void Application::recordMeshletCulling(VkCommandBuffer commandBuffer,
+                                       size_t image) {
+  vkCmdFillBuffer(commandBuffer, drawBuffers_[image], 0, VK_WHOLE_SIZE, 0);
+
+  VkBufferMemoryBarrier barrier{};
+  barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask =
+      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.buffer = drawBuffers_[image];
+  barrier.offset = 0;
+  barrier.size = VK_WHOLE_SIZE;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 1,
+                       &barrier, 0, nullptr);
+
+  const MeshLod lod = mesh_.lod(recordedLods_[image]);
+  const CullParams params{lod.firstMeshlet, lod.meshletCount};
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                    cullPipeline_);
+  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                          cullPipelineLayout_, 0, 1,
+                          &cullDescriptorSets_[image], 0, nullptr);
+  vkCmdPushConstants(commandBuffer, cullPipelineLayout_,
+                     VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+  vkCmdDispatch(commandBuffer, (params.meshletCount + 63) / 64, 1, 1);
+
+  barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 0, nullptr, 1,
+                       &barrier, 0, nullptr);
 }
 
 void Application::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
@@ -1564,6 +3051,77 @@ void Application::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
   vkBindBufferMemory(device_, buffer, bufferMemory, 0);
 }
 
+// Mapped once for the whole upload. The memory is coherent, so what is
+// written to it needs no flush before submitStaging().
+StagingBuffer Application::createStagingBuffer(VkDeviceSize size) {
+  StagingBuffer staging{};
+  staging.size = size;
+  createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+               staging.buffer, staging.memory);
+
+  void* data{nullptr};
+  if (vkMapMemory(device_, staging.memory, 0, size, 0, &data) != VK_SUCCESS) {
+    destroyStagingBuffer(staging);
+    throw std::runtime_error("failed to map staging buffer!");
+  }
+  staging.data = static_cast<uint8_t*>(data);
+  return staging;
+}
+
+// Creates a device-local buffer of `size` bytes and returns where its
+// contents go in `staging`; submitStaging() copies them over.
+void* Application::stageBuffer(StagingBuffer& staging, VkDeviceSize size,
+                               VkBufferUsageFlags usage, VkBuffer& buffer,
+                               VkDeviceMemory& bufferMemory) {
+  const VkDeviceSize offset = (staging.used + STAGING_ALIGNMENT - 1) /
+                              STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+  if (offset + size > staging.size) {
+    throw std::runtime_error("staging buffer too small!");
+  }
+  createBuffer(size, usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer, bufferMemory);
+
+  VkBufferCopy copyRegion{};
+  copyRegion.srcOffset = offset;
+  copyRegion.size = size;
+  staging.targets.push_back(buffer);
+  staging.copies.push_back(copyRegion);
+  staging.used = offset + size;
+  return staging.data + offset;
+}
+
+// Returns once the copies have completed, so the sources can be freed.
+void Application::submitStaging(StagingBuffer& staging) {
+  std::unique_lock<std::mutex> lock(singleTimeCommandsMutex_);
+  VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+  for (size_t i{0}; i < staging.copies.size(); ++i) {
+    vkCmdCopyBuffer(commandBuffer, staging.buffer, staging.targets[i], 1,
+                    &staging.copies[i]);
+  }
+  endSingleTimeCommands(commandBuffer, lock);
+
+  staging.targets.clear();
+  staging.copies.clear();
+  staging.used = 0;
+}
+
+void Application::destroyStagingBuffer(StagingBuffer& staging) {
+  if (staging.data != nullptr) {
+    vkUnmapMemory(device_, staging.memory);
+    staging.data = nullptr;
+  }
+  if (staging.buffer != VK_NULL_HANDLE) {
+    vkDestroyBuffer(device_, staging.buffer, nullptr);
+    staging.buffer = VK_NULL_HANDLE;
+  }
+  if (staging.memory != VK_NULL_HANDLE) {
+    vkFreeMemory(device_, staging.memory, nullptr);
+    staging.memory = VK_NULL_HANDLE;
+  }
+}
+
 VkCommandBuffer Application::beginSingleTimeCommands() {
   VkCommandBufferAllocateInfo allocInfo{};
   allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -1583,7 +3141,11 @@ VkCommandBuffer Application::beginSingleTimeCommands() {
   return commandBuffer;
 }
 
-void Application::endSingleTimeCommands(VkCommandBuffer commandBuffer) {
+// Waits for the commands with `lock` released, so that frames can be
+// submitted meanwhile; while frames are in flight, waiting for the whole queue
+// would also wait for those.
+void Application::endSingleTimeCommands(VkCommandBuffer commandBuffer,
+                                        std::unique_lock<std::mutex>& lock) {
   vkEndCommandBuffer(commandBuffer);
 
   VkSubmitInfo submitInfo{};
@@ -1591,21 +3153,20 @@ void Application::endSingleTimeCommands(VkCommandBuffer commandBuffer) {
   submitInfo.commandBufferCount = 1;
   submitInfo.pCommandBuffers = &commandBuffer;
 
-  vkQueueSubmit(graphicsQueue_, 1, &submitInfo, VK_NULL_HANDLE);
-  vkQueueWaitIdle(graphicsQueue_);
-
-  vkFreeCommandBuffers(device_, commandPool_, 1, &commandBuffer);
-}
-
-void Application::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer,
-                             VkDeviceSize size) {
-  VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+  VkFenceCreateInfo fenceInfo{};
+  fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+  VkFence fence{};
+  if (vkCreateFence(device_, &fenceInfo, nullptr, &fence) != VK_SUCCESS) {
+    throw std::runtime_error("failed to create fence!");
+  }
 
-  VkBufferCopy copyRegion{};
-  copyRegion.size = size;
-  vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+  vkQueueSubmit(graphicsQueue_, 1, &submitInfo, fence);
+  lock.unlock();
+  vkWaitForFences(device_, 1, &fence, VK_TRUE, UINT64_MAX);
+  lock.lock();
 
-  endSingleTimeCommands(commandBuffer);
+  vkDestroyFence(device_, fence, nullptr);
+  vkFreeCommandBuffers(device_, commandPool_, 1, &commandBuffer);
 }
 
 uint32_t Application::findMemoryType(uint32_t typeFilter,
@@ -1637,53 +3198,106 @@ void Application::createCommandBuffers() {
     throw std::runtime_error("failed to allocate command buffers!");
   }
 
+  recordedLods_.assign(commandBuffers_.size(), activeLod_);
+  recordedGenerations_.assign(commandBuffers_.size(), assetGeneration_);
   for (size_t i = 0; i < commandBuffers_.size(); i++) {
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    recordCommandBuffer(i);
+  }
+}
 
-    if (vkBeginCommandBuffer(commandBuffers_[i], &beginInfo) != VK_SUCCESS) {
-      throw std::runtime_error("failed to begin recording command buffer!");
-    }
+void Application::recordCommandBuffer(size_t image) {
+  recordedLods_[image] = activeLod_;
+  recordedGenerations_[image] = assetGeneration_;
+  const MeshLod lod = mesh_.lod(activeLod_);
+  VkCommandBuffer commandBuffer = commandBuffers_[image];
 
-    VkRenderPassBeginInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = renderPass_;
-    renderPassInfo.framebuffer = swapChainFramebuffers_[i];
-    renderPassInfo.renderArea.offset = {0, 0};
-    renderPassInfo.renderArea.extent = swapChainExtent_;
+  VkCommandBufferBeginInfo beginInfo{};
+  beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 
-    std::array<VkClearValue, 2> clearValues{};
-    clearValues[0].color = {0.0f, 0.0f, 0.0f, 1.0f};
-    clearValues[1].depthStencil = {1.0f, 0};
+  if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+    throw std::runtime_error("failed to begin recording command buffer!");
+  }
 
-    renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-    renderPassInfo.pClearValues = clearValues.data();
+  if (meshletCulling_) {
+    recordMeshletCulling(commandBuffer, image);
+  }
 
-    vkCmdBeginRenderPass(commandBuffers_[i], &renderPassInfo,
-                         VK_SUBPASS_CONTENTS_INLINE);
+  VkRenderPassBeginInfo renderPassInfo{};
+  renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+  renderPassInfo.renderPass = renderPass_;
+  renderPassInfo.framebuffer = swapChainFramebuffers_[image];
+  renderPassInfo.renderArea.offset = {0, 0};
+  renderPassInfo.renderArea.extent = swapChainExtent_;
+
+  std::array<VkClearValue, 2> clearValues{};
+  clearValues[0].color = {0.0f, 0.0f, 0.0f, 1.0f};
+  clearValues[1].depthStencil = {1.0f, 0};
 
-    vkCmdBindPipeline(commandBuffers_[i], VK_PIPELINE_BIND_POINT_GRAPHICS,
-                      graphicsPipeline_);
+  renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+  renderPassInfo.pClearValues = clearValues.data();
 
-    VkBuffer vertexBuffers[] = {vertexBuffer_};
-    VkDeviceSize offsets[] = {0};
-    vkCmdBindVertexBuffers(commandBuffers_[i], 0, 1, vertexBuffers, offsets);
+  vkCmdBeginRenderPass(commandBuffer, &renderPassInfo,
+                       VK_SUBPASS_CONTENTS_INLINE);
 
-    vkCmdBindIndexBuffer(commandBuffers_[i], indexBuffer_, 0,
-                         VK_INDEX_TYPE_UINT32);
+  // Every part draws from these buffers; ranges and meshlets pick their
+  // part's transform with firstInstance. Split streams are two bindings into
+  // the same buffer.
+  if (options_.vertexFormat == VertexFormat::Split) {
+    VkBuffer vertexBuffers[] = {vertexBuffer_, vertexBuffer_, partBuffer_};
+    VkDeviceSize offsets[] = {0, splitAttributeOffset(mesh_.vertexCount), 0};
+    vkCmdBindVertexBuffers(commandBuffer, 0, 3, vertexBuffers, offsets);
+  } else {
+    VkBuffer vertexBuffers[] = {vertexBuffer_, partBuffer_};
+    VkDeviceSize offsets[] = {0, 0};
+    vkCmdBindVertexBuffers(commandBuffer, 0, 2, vertexBuffers, offsets);
+  }
+
+  vkCmdBindIndexBuffer(commandBuffer, indexBuffer_, 0, mesh_.indexType());
+
+  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          pipelineLayout_, 0, 1, &descriptorSets_[image], 0,
+                          nullptr);
+
+  const auto draw = [&]() {
+    if (meshletCulling_) {
+      vkCmdDrawIndexedIndirect(commandBuffer, drawBuffers_[image],
+                               DRAW_COMMANDS_OFFSET, lod.meshletCount,
+                               sizeof(VkDrawIndexedIndirectCommand));
+    } else {
+      for (uint32_t range = lod.firstRange;
+           range < lod.firstRange + lod.rangeCount; range++) {
+        vkCmdDrawIndexed(commandBuffer, mesh_.ranges[range].indexCount, 1,
+                         mesh_.ranges[range].firstIndex,
+                         mesh_.ranges[range].vertexOffset,
+                         mesh_.ranges[range].part);
+      }
+    }
+  };
 
-    vkCmdBindDescriptorSets(commandBuffers_[i], VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            pipelineLayout_, 0, 1, &descriptorSets_[i], 0,
-                            nullptr);
+  if (options_.depthPrepass) {
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                      depthPipeline_);
+    draw();
+  }
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                    graphicsPipeline_);
+  draw();
 
-    vkCmdDrawIndexed(commandBuffers_[i], static_cast<uint32_t>(indices_.size()),
-                     1, 0, 0, 0);
+  vkCmdEndRenderPass(commandBuffer);
 
-    vkCmdEndRenderPass(commandBuffers_[i]);
+  // The feedback is read on the host once the frame's fence has signaled.
+  if (options_.virtualTexture) {
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                         VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0,
+                         nullptr, 0, nullptr);
+  }
 
-    if (vkEndCommandBuffer(commandBuffers_[i]) != VK_SUCCESS) {
-      throw std::runtime_error("failed to record command buffer!");
-    }
+  if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+    throw std::runtime_error("failed to record command buffer!");
   }
 }
 
@@ -1726,14 +3340,36 @@ void Application::updateUniformBuffer(uint32_t currentImage) {
                           glm::vec3(0.0f, 0.0f, 1.0f));
   ubo.model *=
       glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, TRANSLATEFACTOR, 0.0f));
-  ubo.view =
-      glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f),
-                  glm::vec3(0.0f, 0.0f, 1.0f));
+  const glm::vec3 cameraPosition(2.0f, 2.0f, 2.0f);
+  ubo.view = glm::lookAt(cameraPosition, glm::vec3(0.0f, 0.0f, 0.0f),
+                         glm::vec3(0.0f, 0.0f, 1.0f));
+  ubo.cameraPosition = glm::vec4(cameraPosition, 1.0f);
   ubo.proj = glm::perspective(
       glm::radians(ZOOMDEGREES),
       swapChainExtent_.width / (float)swapChainExtent_.height, 0.1f, 10.0f);
   ubo.proj[1][1] *= -1;
 
+  // Pick the coarsest level whose error stays below a pixel at the point of
+  // the bounding sphere nearest to the camera.
+  const MeshBounds& bounds = mesh_.sceneBounds;
+  const glm::vec3 boundsCenter = (bounds.min + bounds.max) * 0.5f;
+  const glm::vec3 center = glm::vec3(ubo.model * glm::vec4(boundsCenter, 1.0f));
+  const float radius = glm::length(bounds.max - bounds.min) * 0.5f;
+  const float distance =
+      std::max(glm::length(cameraPosition - center) - radius, 0.1f);
+  const float pixelsPerUnit =
+      static_cast<float>(swapChainExtent_.height) /
+      (2.0f * std::abs(std::tan(glm::radians(ZOOMDEGREES) * 0.5f)));
+  activeLod_ = selectLod(mesh_.lods, mesh_.lodCount, distance, pixelsPerUnit);
+  const PositionDequantization dequantization =
+      positionDequantization(mesh_.bounds);
+  ubo.positionScale = glm::vec4(dequantization.scale, 0.0f);
+  ubo.positionOffset = glm::vec4(dequantization.offset, 0.0f);
+  // Numbers the frame about to be submitted; never 0, which is what the
+  // feedback buffers start out with.
+  ubo.feedbackStamp = static_cast<uint32_t>(submittedFrames_ + 1);
+  ubo.textureCount = static_cast<uint32_t>(textureImageViews_.size());
+
   void* data{};
   vkMapMemory(device_, uniformBuffersMemory_[currentImage], 0, sizeof(ubo), 0,
               &data);
@@ -1744,6 +3380,11 @@ void Application::updateUniformBuffer(uint32_t currentImage) {
 void Application::drawFrame() {
   vkWaitForFences(device_, 1, &inFlightFences_[currentFrame_], VK_TRUE,
                   UINT64_MAX);
+  // The fence covers everything submitted before it, so all but the last
+  // MAX_FRAMES_IN_FLIGHT - 1 frames are done.
+  if (submittedFrames_ >= MAX_FRAMES_IN_FLIGHT) {
+    releaseQueue_.collect(submittedFrames_ - MAX_FRAMES_IN_FLIGHT + 1);
+  }
 
   uint32_t imageIndex{0};
   VkResult result = vkAcquireNextImageKHR(
@@ -1767,8 +3408,17 @@ void Application::drawFrame() {
   }
   imagesInFlight_[imageIndex] = inFlightFences_[currentFrame_];
 
-  std::array<VkCommandBuffer, 2> submitCommandBuffers = {
-      commandBuffers_[imageIndex], imGuiCommandBuffers_[imageIndex]};
+  // Images still refer to replaced assets until they are drawn again.
+  const bool stale = recordedGenerations_[imageIndex] != assetGeneration_;
+  bool rerecord = stale;
+  if (stale) {
+    refreshImageResources(imageIndex);
+  } else if (writtenTextureGenerations_[imageIndex] != textureGeneration_) {
+    writeTextureDescriptors(imageIndex);
+    // Updating the fixed array invalidates the commands that bind it.
+    rerecord = !textureTable_;
+  }
+
   VkSubmitInfo submitInfo{};
   submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
@@ -1779,20 +3429,34 @@ void Application::drawFrame() {
   submitInfo.pWaitSemaphores = waitSemaphores;
   submitInfo.pWaitDstStageMask = waitStages;
 
-  submitInfo.commandBufferCount =
-      static_cast<uint32_t>(submitCommandBuffers.size());
-  submitInfo.pCommandBuffers = submitCommandBuffers.data();
-
   VkSemaphore signalSemaphores[] = {renderFinishedSemaphores_[currentFrame_]};
   submitInfo.signalSemaphoreCount = 1;
   submitInfo.pSignalSemaphores = signalSemaphores;
 
   vkResetFences(device_, 1, &inFlightFences_[currentFrame_]);
 
+  // Reloads record into the same command pool and submit to the same queue.
+  std::unique_lock<std::mutex> lock(singleTimeCommandsMutex_);
+  if (rerecord || recordedLods_[imageIndex] != activeLod_) {
+    recordCommandBuffer(imageIndex);
+  }
+
+  // Pages go up ahead of the frame, in the same submission.
+  std::vector<VkCommandBuffer> submitCommandBuffers;
+  if (options_.virtualTexture && recordPageUploads(imageIndex)) {
+    submitCommandBuffers.push_back(pageUploadCommandBuffers_[imageIndex]);
+  }
+  submitCommandBuffers.push_back(commandBuffers_[imageIndex]);
+  submitCommandBuffers.push_back(imGuiCommandBuffers_[imageIndex]);
+  submitInfo.commandBufferCount =
+      static_cast<uint32_t>(submitCommandBuffers.size());
+  submitInfo.pCommandBuffers = submitCommandBuffers.data();
+
   if (vkQueueSubmit(graphicsQueue_, 1, &submitInfo,
                     inFlightFences_[currentFrame_]) != VK_SUCCESS) {
     throw std::runtime_error("failed to submit draw command buffer!");
   }
+  ++submittedFrames_;
 
   VkPresentInfoKHR presentInfo{};
   presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -1807,6 +3471,7 @@ void Application::drawFrame() {
   presentInfo.pImageIndices = &imageIndex;
 
   result = vkQueuePresentKHR(presentQueue_, &presentInfo);
+  lock.unlock();
 
   if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR ||
       framebufferResized_) {
@@ -1819,7 +3484,255 @@ void Application::drawFrame() {
   currentFrame_ = (currentFrame_ + 1) % MAX_FRAMES_IN_FLIGHT;
 }
 
+void Application::watchAssets() {
+  // A pack is not rebuilt on the fly, so edits to loose files would not show.
+  if (assetPack_.isOpen()) {
+    return;
+  }
+  const bool compact = options_.vertexFormat == VertexFormat::Compact;
+  std::vector<std::string> paths = {
+      MODEL_PATH, compact ? VERT_COMPACT_SHADER_PATH : VERT_SHADER_PATH,
+      ASSET_DIR + fragShaderName()};
+  for (const std::string& name : TEXTURE_NAMES) {
+    paths.push_back(ASSET_DIR + name);
+  }
+  if (meshletCulling_) {
+    paths.push_back(CULL_SHADER_PATH);
+  }
+  if (options_.depthPrepass) {
+    paths.push_back(compact ? DEPTH_COMPACT_SHADER_PATH : DEPTH_SHADER_PATH);
+  }
+  for (const std::string& path : paths) {
+    if (!assetWatcher_.add(path)) {
+      std::cerr << "cannot watch " << path << " for changes\n";
+    }
+  }
+}
+
+// Changes are collected while a reload is running and picked up by the next
+// one, so a burst of writes costs at most two reloads.
+void Application::pollAssetChanges() {
+  for (const std::string& path : assetWatcher_.poll()) {
+    const auto isTexture = [&path](const std::string& name) {
+      return path == ASSET_DIR + name;
+    };
+    if (path == MODEL_PATH) {
+      modelChanged_ = true;
+    } else if (std::any_of(TEXTURE_NAMES.begin(), TEXTURE_NAMES.end(),
+                           isTexture)) {
+      textureChanged_ = true;
+    } else {
+      shadersChanged_ = true;
+    }
+  }
+
+  if (reloadJob_.valid()) {
+    if (reloadJob_.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready) {
+      return;
+    }
+    AssetReload reload = reloadJob_.get();
+    applyReload(reload);
+  }
+
+  if (modelChanged_ || textureChanged_ || shadersChanged_) {
+    reloadJob_ = std::async(std::launch::async, &Application::prepareReload,
+                            this, modelChanged_, textureChanged_,
+                            shadersChanged_);
+    modelChanged_ = false;
+    textureChanged_ = false;
+    shadersChanged_ = false;
+  }
+}
+
+// Runs on a worker thread. Everything it creates is unused until
+// applyReload(); if anything fails, the old assets stay.
+AssetReload Application::prepareReload(bool model, bool texture,
+                                       bool shaders) {
+  AssetReload reload{};
+  StagingBuffer staging{};
+  try {
+    if (model) {
+      reload.scene = buildScene(importScene(MODEL_PATH, options_.importer));
+      const MeshView mesh = reload.scene.view();
+      if (meshletCulling_ && !canCullMeshlets(mesh)) {
+        throw std::runtime_error("cannot cull the new model's meshlets");
+      }
+      const std::string cachePath = MODEL_PATH + MESH_CACHE_EXTENSION;
+      if (!MeshCache::write(cachePath, MODEL_PATH, mesh,
+                            options_.meshCompression)) {
+        std::cerr << "failed to write mesh cache " << cachePath << '\n';
+      }
+      staging = createStagingBuffer(meshStagingSize(mesh));
+      createVertexBuffer(mesh, staging, reload.vertexBuffer,
+                         reload.vertexBufferMemory);
+      createIndexBuffer(mesh, staging, reload.indexBuffer,
+                        reload.indexBufferMemory);
+      createPartBuffer(mesh, staging, reload.partBuffer,
+                       reload.partBufferMemory);
+      createMeshletBuffer(mesh, staging, reload.meshletBuffer,
+                          reload.meshletBufferMemory);
+      submitStaging(staging);
+      destroyStagingBuffer(staging);
+      reload.model = true;
+    }
+    if (texture) {
+      // The batch is reloaded as a whole; unchanged textures come from their
+      // caches.
+      reload.textureBatch = loadTextures();
+      createTextureArrays(reload.textureBatch, reload.textureArrays);
+      createTextureAtlas(reload.textureBatch, reload.textureAtlas);
+      createTextureImageViews(reload.textureArrays,
+                              reload.textureBatch.views.size(),
+                              reload.textureImageViews);
+      reload.texture = true;
+    }
+    if (shaders) {
+      readShaders(reload.vertShaderCode, reload.fragShaderCode,
+                  reload.cullShaderCode, reload.depthShaderCode);
+      // The pipelines bake in the swap chain's extent and render pass, which
+      // recreateSwapChain() replaces while holding this lock.
+      std::lock_guard<std::mutex> lock(singleTimeCommandsMutex_);
+      reload.swapChainGeneration = swapChainGeneration_;
+      createGraphicsPipeline(reload.vertShaderCode, reload.fragShaderCode,
+                             reload.depthShaderCode, reload.pipelineLayout,
+                             reload.graphicsPipeline, reload.depthPipeline);
+      if (meshletCulling_) {
+        reload.cullPipeline =
+            createComputePipeline(reload.cullShaderCode, cullPipelineLayout_);
+      }
+      reload.shaders = true;
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "reload failed, keeping the old assets: " << e.what()
+              << '\n';
+    destroyStagingBuffer(staging);
+    destroyReload(reload);
+    return AssetReload{};
+  }
+  return reload;
+}
+
+// Swaps the prepared objects in between frames. The replaced ones are kept
+// until the frames submitted so far have completed, and each image picks up
+// the new ones the next time it is drawn.
+void Application::applyReload(AssetReload& reload) {
+  if (!reload.model && !reload.texture && !reload.shaders) {
+    return;
+  }
+
+  if (reload.model) {
+    meshCache_.close();
+    std::swap(scene_, reload.scene);
+    mesh_ = scene_.view();
+    releaseGeometry();
+    activeLod_ = 0;
+    std::swap(vertexBuffer_, reload.vertexBuffer);
+    std::swap(vertexBufferMemory_, reload.vertexBufferMemory);
+    std::swap(indexBuffer_, reload.indexBuffer);
+    std::swap(indexBufferMemory_, reload.indexBufferMemory);
+    std::swap(partBuffer_, reload.partBuffer);
+    std::swap(partBufferMemory_, reload.partBufferMemory);
+    std::swap(meshletBuffer_, reload.meshletBuffer);
+    std::swap(meshletBufferMemory_, reload.meshletBufferMemory);
+    std::cout << "reloaded " << MODEL_PATH << '\n';
+  }
+  if (reload.texture) {
+    // The new arrays start from their mip tails again.
+    finishMipStream();
+    std::swap(textureBatch_, reload.textureBatch);
+    std::swap(textureArrays_, reload.textureArrays);
+    std::swap(textureImageViews_, reload.textureImageViews);
+    std::swap(textureAtlas_, reload.textureAtlas);
+    std::cout << "reloaded textures\n";
+  }
+  if (reload.shaders && reload.swapChainGeneration != swapChainGeneration_) {
+    // The pipelines were made for the old swap chain; they are dropped with
+    // the rest of the reload and made again.
+    shadersChanged_ = true;
+  } else if (reload.shaders) {
+    std::swap(vertShaderCode_, reload.vertShaderCode);
+    std::swap(fragShaderCode_, reload.fragShaderCode);
+    std::swap(depthShaderCode_, reload.depthShaderCode);
+    std::swap(pipelineLayout_, reload.pipelineLayout);
+    std::swap(graphicsPipeline_, reload.graphicsPipeline);
+    std::swap(depthPipeline_, reload.depthPipeline);
+    if (meshletCulling_) {
+      std::swap(cullShaderCode_, reload.cullShaderCode);
+      std::swap(cullPipeline_, reload.cullPipeline);
+    }
+    std::cout << "reloaded shaders\n";
+  }
+
+  ++assetGeneration_;
+  auto retired = std::make_shared<AssetReload>(std::move(reload));
+  releaseQueue_.retire(submittedFrames_,
+                       [this, retired] { destroyReload(*retired); });
+}
+
+void Application::destroyReload(AssetReload& reload) {
+  const auto destroyBuffer = [this](VkBuffer& buffer, VkDeviceMemory& memory) {
+    if (buffer != VK_NULL_HANDLE) {
+      vkDestroyBuffer(device_, buffer, nullptr);
+      buffer = VK_NULL_HANDLE;
+    }
+    if (memory != VK_NULL_HANDLE) {
+      vkFreeMemory(device_, memory, nullptr);
+      memory = VK_NULL_HANDLE;
+    }
+  };
+  destroyBuffer(reload.vertexBuffer, reload.vertexBufferMemory);
+  destroyBuffer(reload.indexBuffer, reload.indexBufferMemory);
+  destroyBuffer(reload.partBuffer, reload.partBufferMemory);
+  destroyBuffer(reload.meshletBuffer, reload.meshletBufferMemory);
+
+  destroyTextureImageViews(reload.textureImageViews);
+  destroyTextureArrays(reload.textureArrays);
+  destroyTextureAtlas(reload.textureAtlas);
+
+  if (reload.graphicsPipeline != VK_NULL_HANDLE) {
+    vkDestroyPipeline(device_, reload.graphicsPipeline, nullptr);
+    reload.graphicsPipeline = VK_NULL_HANDLE;
+  }
+  if (reload.pipelineLayout != VK_NULL_HANDLE) {
+    vkDestroyPipelineLayout(device_, reload.pipelineLayout, nullptr);
+    reload.pipelineLayout = VK_NULL_HANDLE;
+  }
+  if (reload.depthPipeline != VK_NULL_HANDLE) {
+    vkDestroyPipeline(device_, reload.depthPipeline, nullptr);
+    reload.depthPipeline = VK_NULL_HANDLE;
+  }
+  if (reload.cullPipeline != VK_NULL_HANDLE) {
+    vkDestroyPipeline(device_, reload.cullPipeline, nullptr);
+    reload.cullPipeline = VK_NULL_HANDLE;
+  }
+}
+
+// The image's last frame has completed, so its draw list and descriptor sets
+// can be changed in place.
+void Application::refreshImageResources(size_t image) {
+  if (meshletCulling_) {
+    // Sized for the current model's meshlets.
+    vkDestroyBuffer(device_, drawBuffers_[image], nullptr);
+    vkFreeMemory(device_, drawBuffersMemory_[image], nullptr);
+    createDrawBuffer(drawBuffers_[image], drawBuffersMemory_[image]);
+  }
+  writeDescriptorSets(image);
+}
+
+// A half-written file is caught here rather than by the driver, which need
+// not check the code at all.
 VkShaderModule Application::createShaderModule(const std::vector<char>& code) {
+  constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+  uint32_t magic{0};
+  if (code.size() < sizeof(magic) || code.size() % sizeof(magic) != 0) {
+    throw std::runtime_error("failed to create shader module: not SPIR-V!");
+  }
+  memcpy(&magic, code.data(), sizeof(magic));
+  if (magic != SPIRV_MAGIC) {
+    throw std::runtime_error("failed to create shader module: not SPIR-V!");
+  }
+
   VkShaderModuleCreateInfo createInfo{};
   createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
   createInfo.codeSize = code.size();
@@ -1923,7 +3836,8 @@ bool Application::isDeviceSuitable(VkPhysicalDevice device) {
   vkGetPhysicalDeviceFeatures(device, &supportedFeatures);
 
   return indices.isComplete() && extensionsSupported && swapChainAdequate &&
-         supportedFeatures.samplerAnisotropy;
+         supportedFeatures.samplerAnisotropy &&
+         supportedFeatures.shaderSampledImageArrayDynamicIndexing;
 }
 
 bool Application::checkDeviceExtensionSupport(VkPhysicalDevice device) {
@@ -2037,6 +3951,31 @@ bool Application::checkValidationLayerSupport() {
   return buffer;
 }
 
+// Packed entries that are stored uncompressed are returned in place; others
+// are copied into `storage`. Assets missing from the pack are read from
+// ASSET_DIR, so a pack can leave out what it does not need to ship.
+AssetData Application::findAsset(const std::string& name,
+                                 std::vector<uint8_t>& storage) const {
+  if (assetPack_.isOpen()) {
+    const AssetData packed = assetPack_.view(name);
+    if (packed.data != nullptr) {
+      return packed;
+    }
+    if (assetPack_.read(name, storage)) {
+      return {storage.data(), storage.size()};
+    }
+  }
+  const std::vector<char> file = readFile(ASSET_DIR + name);
+  storage.assign(file.begin(), file.end());
+  return {storage.data(), storage.size()};
+}
+
+std::vector<char> Application::readAsset(const std::string& name) const {
+  std::vector<uint8_t> storage;
+  const AssetData asset = findAsset(name, storage);
+  return std::vector<char>(asset.data, asset.data + asset.size);
+}
+
 /*static*/ VKAPI_ATTR VkBool32 VKAPI_CALL Application::debugCallback(
     VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
     VkDebugUtilsMessageTypeFlagsEXT messageType,
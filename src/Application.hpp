@@ -11,14 +11,12 @@
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #define GLM_ENABLE_EXPERIMENTAL
-#include <assimp/postprocess.h>  // Post processing flags
-#include <assimp/scene.h>        // Output data structure
 #include <imgui.h>
 
 #include <algorithm>
 #include <array>
-#include <assimp/Importer.hpp>  // C++ importer interface
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
@@ -28,12 +26,35 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/hash.hpp>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <stdexcept>
 #include <unordered_map>
 #include <vector>
 
+#include "AssetPack.hpp"
+#include "BlockCompression.hpp"
+#include "FileWatcher.hpp"
+#include "ImageDecoder.hpp"
+#include "MemoryUsage.hpp"
+#include "MeshCache.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshSimplifier.hpp"
+#include "MipChain.hpp"
+#include "Options.hpp"
+#include "PageCache.hpp"
+#include "PageLoader.hpp"
+#include "Parallel.hpp"
+#include "ReleaseQueue.hpp"
+#include "SceneBuilder.hpp"
+#include "SplitVertex.hpp"
+#include "TaskGraph.hpp"
+#include "TextureArray.hpp"
+#include "TextureAtlas.hpp"
+#include "TextureCache.hpp"
+#include "VirtualTexture.hpp"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_vulkan.h"
 #include "stb_image.hpp"
@@ -48,11 +69,66 @@ static float ZOOMDEGREES{90.0f};
 static float ROTATEDEGREES{45.0f};
 static float TRANSLATEFACTOR{0.0f};
 
-const std::string MODEL_PATH = "../../src/models/viking_room.obj";
-const std::string TEXTURE_PATH = "../../src/textures/viking_room.png";
+// Assets are looked up by name, in ASSET_PACK_PATH if it exists and as loose
+// files under ASSET_DIR otherwise.
+const std::string ASSET_DIR = "../../src/";
+const std::string ASSET_PACK_PATH = "../../assets.pack";
+const std::string MODEL_NAME = "models/viking_room.obj";
+const std::string TEXTURE_NAME = "textures/viking_room.png";
+// Every texture of the scene's materials, loaded as one batch. Material i
+// samples texture i, the first being TEXTURE_NAME; with virtual texturing
+// that one is streamed instead and left out of the batch.
+const std::vector<std::string> TEXTURE_NAMES = {
+    TEXTURE_NAME, "textures/Mummelsee.jpg", "textures/texture.jpg"};
+const std::string MESH_CACHE_EXTENSION = ".meshcache";
+const std::string TEXTURE_CACHE_EXTENSION = ".texturecache";
+// Textures small enough to share the atlas, see isAtlasCandidate(), are
+// cooked as tiles and cached under this extension instead.
+const std::string ATLAS_TILE_EXTENSION = ".atlastile";
+const std::string VIRTUAL_TEXTURE_EXTENSION = ".vtpages";
+const std::string VERT_SHADER_NAME = "vert.spv";
+const std::string VERT_COMPACT_SHADER_NAME = "vert_compact.spv";
+const std::string FRAG_SHADER_NAME = "frag.spv";
+const std::string FRAG_TABLE_SHADER_NAME = "frag_table.spv";
+const std::string FRAG_VIRTUAL_SHADER_NAME = "frag_virtual.spv";
+const std::string CULL_SHADER_NAME = "cull.spv";
+const std::string DEPTH_SHADER_NAME = "vert_depth.spv";
+const std::string DEPTH_COMPACT_SHADER_NAME = "vert_depth_compact.spv";
+const std::string MODEL_PATH = ASSET_DIR + MODEL_NAME;
+const std::string VERT_SHADER_PATH = ASSET_DIR + VERT_SHADER_NAME;
+const std::string VERT_COMPACT_SHADER_PATH =
+    ASSET_DIR + VERT_COMPACT_SHADER_NAME;
+const std::string CULL_SHADER_PATH = ASSET_DIR + CULL_SHADER_NAME;
+const std::string DEPTH_SHADER_PATH = ASSET_DIR + DEPTH_SHADER_NAME;
+const std::string DEPTH_COMPACT_SHADER_PATH =
+    ASSET_DIR + DEPTH_COMPACT_SHADER_NAME;
 
 constexpr int MAX_FRAMES_IN_FLIGHT = 2;
 
+// The draw buffers start with the visible meshlet count (padded to 16 bytes),
+// followed by one VkDrawIndexedIndirectCommand per meshlet.
+constexpr VkDeviceSize DRAW_COMMANDS_OFFSET = 16;
+
+// Virtual texturing: the page atlas is PAGE_ATLAS_SLOTS_PER_ROW slots square,
+// 4080 texels, which every device supports. At most VIRTUAL_PAGE_UPLOADS
+// pages are copied into it per frame.
+constexpr uint32_t PAGE_ATLAS_SLOTS_PER_ROW = 30;
+constexpr uint32_t VIRTUAL_PAGE_UPLOADS = 16;
+
+// Texture levels above the mip tail are streamed in after the first frame,
+// at most this many bytes per frame (but always one level at a time).
+constexpr VkDeviceSize MIP_UPLOAD_BUDGET = 8 * 1024 * 1024;
+
+// Entries of the texture table, the array of textures the fragment shader
+// indexes by material. Only the first TEXTURE_NAMES.size() are bound.
+constexpr uint32_t MAX_BINDLESS_TEXTURES = 1024;
+// Without the table (no descriptor indexing, or virtual texturing), the
+// array has this many entries, all bound, and is indexed once per draw.
+constexpr uint32_t MAX_FIXED_TEXTURES = 8;
+// The storage buffer of texture coordinate transforms, one per entry of the
+// texture table, read by the vertex shader.
+constexpr uint32_t TEXTURE_TRANSFORM_BINDING = 5;
+
 const std::vector<const char*> validationLayers = {
     "VK_LAYER_KHRONOS_validation"};
 
@@ -91,72 +167,121 @@ struct SwapChainSupportDetails {
   std::vector<VkPresentModeKHR> presentModes;
 };
 
-struct Vertex {
-  glm::vec3 pos;
-  glm::vec3 color;
-  glm::vec2 texCoord;
-
-  static VkVertexInputBindingDescription getBindingDescription() {
-    VkVertexInputBindingDescription bindingDescription{};
-    bindingDescription.binding = 0;
-    bindingDescription.stride = sizeof(Vertex);
-    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-    return bindingDescription;
-  }
-
-  static std::array<VkVertexInputAttributeDescription, 3>
-  getAttributeDescriptions() {
-    std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
-
-    attributeDescriptions[0].binding = 0;
-    attributeDescriptions[0].location = 0;
-    attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-    attributeDescriptions[0].offset = offsetof(Vertex, pos);
+struct UniformBufferObject {
+  alignas(16) glm::mat4 model;
+  alignas(16) glm::mat4 view;
+  alignas(16) glm::mat4 proj;
+  // Only read by the COMPACT_VERTEX shader, see CompactVertex.
+  alignas(16) glm::vec4 positionScale;
+  alignas(16) glm::vec4 positionOffset;
+  alignas(16) glm::vec4 cameraPosition;
+  // Only read by the VIRTUAL_TEXTURE shader: what it writes into the
+  // feedback buffer for every page it samples.
+  alignas(16) uint32_t feedbackStamp;
+  // Entries of the texture table in use; materials beyond it are clamped.
+  uint32_t textureCount;
+};
 
-    attributeDescriptions[1].binding = 0;
-    attributeDescriptions[1].location = 1;
-    attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
-    attributeDescriptions[1].offset = offsetof(Vertex, color);
+// Push constants of cull.comp: the meshlets of the drawn level of detail.
+struct CullParams {
+  uint32_t firstMeshlet;
+  uint32_t meshletCount;
+};
 
-    attributeDescriptions[2].binding = 0;
-    attributeDescriptions[2].location = 2;
-    attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
-    attributeDescriptions[2].offset = offsetof(Vertex, texCoord);
+// Start of the page table buffer the VIRTUAL_TEXTURE shader reads, followed
+// by the entries of PageCache::table().
+struct PageTableHeader {
+  uint32_t levelCount;
+  uint32_t slotsPerRow;
+  uint32_t atlasSize;
+  uint32_t padding;
+  uint32_t levels[VIRTUAL_MAX_LEVELS][4];  // width, height, pagesX, firstPage
+};
 
-    return attributeDescriptions;
-  }
+// A host-visible buffer that stays mapped while a mesh is uploaded. Every
+// stream is written into it in place, then copied to its device-local buffer;
+// all copies go in one submission.
+struct StagingBuffer {
+  VkBuffer buffer{};
+  VkDeviceMemory memory{};
+  uint8_t* data{nullptr};
+  VkDeviceSize size{0};
+  VkDeviceSize used{0};
+  std::vector<VkBuffer> targets;
+  std::vector<VkBufferCopy> copies;
+};
 
-  bool operator==(const Vertex& other) const {
-    return pos == other.pos && color == other.color &&
-           texCoord == other.texCoord;
-  }
+// One image holding a group of same-sized textures as its array layers.
+struct TextureArray {
+  VkImage image{};
+  VkDeviceMemory memory{};
+  TextureArrayLayout layout;
+  // The finest level uploaded so far; views of the array start there.
+  uint32_t residentLevel{0};
 };
 
-namespace std {
-template <>
-struct hash<Vertex> {
-  size_t operator()(Vertex const& vertex) const {
-    return ((hash<glm::vec3>()(vertex.pos) ^
-             (hash<glm::vec3>()(vertex.color) << 1)) >>
-            1) ^
-           (hash<glm::vec2>()(vertex.texCoord) << 1);
-  }
+// The tiles chooseAtlasTiles() picks, packed into one image with as many
+// levels as the tiles share. The transform buffer maps the texture
+// coordinates of every texture in the table into its image: into its tile
+// for the atlas and for tiles left out of it, unchanged for the others.
+struct TextureAtlas {
+  VkImage image{};
+  VkDeviceMemory memory{};
+  VkImageView view{};
+  uint32_t tileCount{0};
+  uint32_t width{0};
+  uint32_t height{0};
+  VkBuffer transformBuffer{};
+  VkDeviceMemory transformBufferMemory{};
 };
-}  // namespace std
 
-struct UniformBufferObject {
-  alignas(16) glm::mat4 model;
-  alignas(16) glm::mat4 view;
-  alignas(16) glm::mat4 proj;
+// What a hot reload prepares on a background thread: the re-imported assets,
+// already uploaded into objects that no frame uses yet. applyReload() swaps
+// them with the live ones, after which this holds the replaced objects until
+// the frames using them have completed.
+struct AssetReload {
+  bool model{false};
+  bool texture{false};
+  bool shaders{false};
+
+  SceneGeometry scene;
+  VkBuffer vertexBuffer{};
+  VkDeviceMemory vertexBufferMemory{};
+  VkBuffer indexBuffer{};
+  VkDeviceMemory indexBufferMemory{};
+  VkBuffer partBuffer{};
+  VkDeviceMemory partBufferMemory{};
+  VkBuffer meshletBuffer{};
+  VkDeviceMemory meshletBufferMemory{};
+
+  TextureBatch textureBatch;
+  std::vector<TextureArray> textureArrays;
+  std::vector<VkImageView> textureImageViews;
+  TextureAtlas textureAtlas;
+
+  // The pipelines are made for the swap chain of swapChainGeneration;
+  // applyReload() drops them if it has been recreated since.
+  uint64_t swapChainGeneration{0};
+  std::vector<char> vertShaderCode;
+  std::vector<char> fragShaderCode;
+  std::vector<char> cullShaderCode;
+  std::vector<char> depthShaderCode;
+  VkPipelineLayout pipelineLayout{};
+  VkPipeline graphicsPipeline{};
+  VkPipeline depthPipeline{};
+  VkPipeline cullPipeline{};
 };
 
 class Application {
  public:
   Application() = default;
+  explicit Application(Options options) : options_(options) {}
   void run();
 
  private:
+  Options options_{};
+  // Mapped for the whole run; mesh_ may point into it.
+  AssetPack assetPack_;
   VkDescriptorPool imguiDescriptorPool_{};
   VkRenderPass imguiRenderPass_{};
   int minImGuiImageCount_ = 2;
@@ -187,8 +312,19 @@ class Application {
   VkDescriptorSetLayout descriptorSetLayout_{};
   VkPipelineLayout pipelineLayout_{};
   VkPipeline graphicsPipeline_{};
+  // Position-only pipeline of the depth pre-pass, if enabled.
+  VkPipeline depthPipeline_{};
 
   VkCommandPool commandPool_{};
+  // Uploads run on other threads during startup and hot reloads, but the
+  // command pool and the queue may only be used by one thread at a time.
+  std::mutex singleTimeCommandsMutex_;
+
+  // Read ahead of device creation, kept for pipeline re-creation.
+  std::vector<char> vertShaderCode_;
+  std::vector<char> fragShaderCode_;
+  std::vector<char> cullShaderCode_;
+  std::vector<char> depthShaderCode_;
 
   VkImage colorImage_{};
   VkDeviceMemory colorImageMemory_{};
@@ -198,18 +334,66 @@ class Application {
   VkDeviceMemory depthImageMemory_{};
   VkImageView depthImageView_{};
 
-  uint32_t mipLevels_{};
-  VkImage textureImage_{};
-  VkDeviceMemory textureImageMemory_{};
-  VkImageView textureImageView_{};
+  // Loaded by loadTextures(), freed once every level has been streamed in.
+  TextureBatch textureBatch_;
+  // The batch, grouped into arrays, except for the atlas tiles, which go
+  // into textureAtlas_. textureImageViews_ has a view of each texture in an
+  // array and is null for the atlas tiles, in batch order: the texture table
+  // of the fragment shader, where the tiles are given the atlas.
+  std::vector<TextureArray> textureArrays_;
+  std::vector<VkImageView> textureImageViews_;
+  // Whether that array is the texture table, see supportsTextureTable(), or
+  // MAX_FIXED_TEXTURES entries without descriptor indexing.
+  bool textureTable_{false};
+  TextureAtlas textureAtlas_;
   VkSampler textureSampler_{};
-
-  std::vector<Vertex> vertices_;
-  std::vector<uint32_t> indices_;
+  // Uploads the levels streamTextureMips() picked, one batch at a time.
+  std::future<std::vector<MipUpload>> mipStreamJob_;
+
+  // Virtual texturing: TEXTURE_NAME is tiled into pages, which pageLoader_
+  // reads as the fragment shader asks for them and which are then copied
+  // into slots of pageAtlas_. The page table tells the shader which slot
+  // holds each page, or its nearest resident ancestor.
+  VirtualTextureFile virtualTexture_;
+  PageCache pageCache_;
+  std::unique_ptr<PageLoader> pageLoader_;
+  VkImage pageAtlas_{};
+  VkDeviceMemory pageAtlasMemory_{};
+  VkImageView pageAtlasView_{};
+  VkSampler pageAtlasSampler_{};
+  VkBuffer pageTableBuffer_{};
+  VkDeviceMemory pageTableBufferMemory_{};
+  // Per swap chain image: the pages its last frame sampled, stamped with
+  // feedbackStamps_, and the staging memory and commands of the pages
+  // uploaded ahead of its next frame.
+  std::vector<VkBuffer> feedbackBuffers_;
+  std::vector<VkDeviceMemory> feedbackBuffersMemory_;
+  std::vector<const uint32_t*> feedbackData_;
+  std::vector<uint32_t> feedbackStamps_;
+  std::vector<StagingBuffer> pageStaging_;
+  std::vector<VkCommandBuffer> pageUploadCommandBuffers_;
+
+  // The imported scene, or empty when mesh_ comes from the cache. Vertices,
+  // indices and meshlets are freed once uploaded, see releaseGeometry().
+  SceneGeometry scene_;
+  MeshCache meshCache_;
+  MeshView mesh_;
   VkBuffer vertexBuffer_{};
   VkDeviceMemory vertexBufferMemory_{};
   VkBuffer indexBuffer_{};
   VkDeviceMemory indexBufferMemory_{};
+  VkBuffer partBuffer_{};
+  VkDeviceMemory partBufferMemory_{};
+
+  bool meshletCulling_{false};
+  VkBuffer meshletBuffer_{};
+  VkDeviceMemory meshletBufferMemory_{};
+  std::vector<VkBuffer> drawBuffers_;
+  std::vector<VkDeviceMemory> drawBuffersMemory_;
+  VkDescriptorSetLayout cullDescriptorSetLayout_{};
+  VkPipelineLayout cullPipelineLayout_{};
+  VkPipeline cullPipeline_{};
+  std::vector<VkDescriptorSet> cullDescriptorSets_;
 
   std::vector<VkBuffer> uniformBuffers_;
   std::vector<VkDeviceMemory> uniformBuffersMemory_;
@@ -218,6 +402,32 @@ class Application {
   std::vector<VkDescriptorSet> descriptorSets_;
 
   std::vector<VkCommandBuffer> commandBuffers_;
+  // Level of detail picked by updateUniformBuffer(), and the one each command
+  // buffer draws; drawFrame() re-records a command buffer when they differ.
+  uint32_t activeLod_{0};
+  std::vector<uint32_t> recordedLods_;
+
+  // Hot reload: changed assets are re-imported and uploaded by reloadJob_,
+  // then swapped in between frames. Replaced objects wait in releaseQueue_
+  // until the frames that may use them have completed.
+  FileWatcher assetWatcher_;
+  std::future<AssetReload> reloadJob_;
+  bool modelChanged_{false};
+  bool textureChanged_{false};
+  bool shadersChanged_{false};
+  // Bumped by recreateSwapChain(), see AssetReload::swapChainGeneration.
+  uint64_t swapChainGeneration_{0};
+  ReleaseQueue releaseQueue_;
+  uint64_t submittedFrames_{0};
+  // Bumped by every swap. An image whose command buffer was recorded for an
+  // older generation gets its descriptors and commands redone before it is
+  // drawn again.
+  uint64_t assetGeneration_{0};
+  std::vector<uint64_t> recordedGenerations_;
+  // Bumped when only texture views were replaced. The texture table is
+  // update-after-bind, so an image just rewrites it and keeps its commands.
+  uint64_t textureGeneration_{0};
+  std::vector<uint64_t> writtenTextureGenerations_;
 
   std::vector<VkSemaphore> imageAvailableSemaphores_;
   std::vector<VkSemaphore> renderFinishedSemaphores_;
@@ -257,6 +467,11 @@ class Application {
   void createRenderPass();
   void createDescriptorSetLayout();
   void createGraphicsPipeline();
+  void createGraphicsPipeline(const std::vector<char>& vertCode,
+                              const std::vector<char>& fragCode,
+                              const std::vector<char>& depthCode,
+                              VkPipelineLayout& layout, VkPipeline& pipeline,
+                              VkPipeline& depthPipeline);
   void createFramebuffers();
   void createCommandPool();
   void createColorResources();
@@ -266,43 +481,106 @@ class Application {
                                VkImageTiling tiling,
                                VkFormatFeatureFlags features);
   bool hasStencilComponent(VkFormat format);
-  void createTextureImage();
-  void generateMipmaps(VkImage image, VkFormat imageFormat, int32_t texWidth,
-                       int32_t texHeight, uint32_t mipLevels);
+  void readShaders(std::vector<char>& vertCode, std::vector<char>& fragCode,
+                   std::vector<char>& cullCode, std::vector<char>& depthCode);
+  const std::string& fragShaderName() const;
+  uint32_t textureSlotCount() const;
+  TextureBatch loadTextures() const;
+  TextureView loadTexture(const std::string& name, TextureCache& cache,
+                          CookedTexture& cooked) const;
+  CookedTexture decodeTexture(const std::string& name, VkFormat format) const;
+  TextureView supportedTexture(const std::string& name,
+                               const TextureView& texture,
+                               CookedTexture& fallback) const;
+  void createTextureArrays(TextureBatch& batch,
+                           std::vector<TextureArray>& arrays);
+  void destroyTextureArrays(std::vector<TextureArray>& arrays);
+  void createTextureAtlas(const TextureBatch& batch, TextureAtlas& atlas);
+  void destroyTextureAtlas(TextureAtlas& atlas);
+  void loadVirtualTexture();
+  void createVirtualTexture();
+  void destroyVirtualTexture();
+  void createVirtualTextureFrames();
+  void destroyVirtualTextureFrames();
+  VkDeviceSize pageTableSize() const;
+  VkDeviceSize writePageTable(uint8_t* data);
+  bool recordPageUploads(size_t image);
   VkSampleCountFlagBits getMaxUsableSampleCount();
-  void createTextureImageView();
+  VkImageView createTextureImageView(const TextureArray& array,
+                                     uint32_t layer);
+  void createTextureImageViews(const std::vector<TextureArray>& arrays,
+                               size_t textureCount,
+                               std::vector<VkImageView>& views);
+  void destroyTextureImageViews(std::vector<VkImageView>& views);
   void createTextureSampler();
+  void streamTextureMips();
+  void finishMipStream();
+  std::vector<MipUpload> uploadMips(std::vector<MipUpload> uploads);
   VkImageView createImageView(VkImage image, VkFormat format,
                               VkImageAspectFlags aspectFlags,
-                              uint32_t mipLevels);
+                              uint32_t mipLevels, uint32_t baseMipLevel = 0,
+                              uint32_t baseArrayLayer = 0);
   void createImage(uint32_t width, uint32_t height, uint32_t mipLevels,
-                   VkSampleCountFlagBits numSamples, VkFormat format,
-                   VkImageTiling tiling, VkImageUsageFlags usage,
-                   VkMemoryPropertyFlags properties, VkImage& image,
-                   VkDeviceMemory& imageMemory);
-  void transitionImageLayout(VkImage image, VkFormat format,
+                   uint32_t arrayLayers, VkSampleCountFlagBits numSamples,
+                   VkFormat format, VkImageTiling tiling,
+                   VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
+                   VkImage& image, VkDeviceMemory& imageMemory);
+  void transitionImageLayout(VkCommandBuffer commandBuffer, VkImage image,
                              VkImageLayout oldLayout, VkImageLayout newLayout,
-                             uint32_t mipLevels);
-  void copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width,
-                         uint32_t height);
+                             uint32_t baseMipLevel, uint32_t mipLevels,
+                             uint32_t layerCount);
+  void copyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer,
+                         VkDeviceSize offset, VkImage image, uint32_t layer,
+                         const TextureView& texture, uint32_t firstLevel,
+                         uint32_t levelCount);
   void loadModel();
-  void createVertexBuffer();
-  void createIndexBuffer();
+  std::vector<ImportedPart> importModel() const;
+  void createVertexBuffer(const MeshView& mesh, StagingBuffer& staging,
+                          VkBuffer& buffer, VkDeviceMemory& bufferMemory);
+  void createIndexBuffer(const MeshView& mesh, StagingBuffer& staging,
+                         VkBuffer& buffer, VkDeviceMemory& bufferMemory);
+  void createPartBuffer(const MeshView& mesh, StagingBuffer& staging,
+                        VkBuffer& buffer, VkDeviceMemory& bufferMemory);
+  bool canCullMeshlets(const MeshView& mesh);
+  void createMeshletBuffer(const MeshView& mesh, StagingBuffer& staging,
+                           VkBuffer& buffer, VkDeviceMemory& bufferMemory);
+  void releaseGeometry();
+  void createCullPipeline();
+  VkPipeline createComputePipeline(const std::vector<char>& code,
+                                   VkPipelineLayout layout);
   void createUniformBuffers();
+  void createDrawBuffers();
+  void createDrawBuffer(VkBuffer& buffer, VkDeviceMemory& bufferMemory);
+  void recordMeshletCulling(VkCommandBuffer commandBuffer, size_t image);
   void createDescriptorPool();
   void createDescriptorSets();
+  void writeDescriptorSets(size_t image);
+  void writeTextureDescriptors(size_t image);
   void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
                     VkMemoryPropertyFlags properties, VkBuffer& buffer,
                     VkDeviceMemory& bufferMemory);
+  StagingBuffer createStagingBuffer(VkDeviceSize size);
+  void* stageBuffer(StagingBuffer& staging, VkDeviceSize size,
+                    VkBufferUsageFlags usage, VkBuffer& buffer,
+                    VkDeviceMemory& bufferMemory);
+  void submitStaging(StagingBuffer& staging);
+  void destroyStagingBuffer(StagingBuffer& staging);
   VkCommandBuffer beginSingleTimeCommands();
-  void endSingleTimeCommands(VkCommandBuffer commandBuffer);
-  void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
+  void endSingleTimeCommands(VkCommandBuffer commandBuffer,
+                             std::unique_lock<std::mutex>& lock);
   uint32_t findMemoryType(uint32_t typeFilter,
                           VkMemoryPropertyFlags properties);
   void createCommandBuffers();
+  void recordCommandBuffer(size_t image);
   void createSyncObjects();
   void updateUniformBuffer(uint32_t currentImage);
   void drawFrame();
+  void watchAssets();
+  void pollAssetChanges();
+  AssetReload prepareReload(bool model, bool texture, bool shaders);
+  void applyReload(AssetReload& reload);
+  void destroyReload(AssetReload& reload);
+  void refreshImageResources(size_t image);
   VkShaderModule createShaderModule(const std::vector<char>& code);
   VkSurfaceFormatKHR chooseSwapSurfaceFormat(
       const std::vector<VkSurfaceFormatKHR>& availableFormats);
@@ -316,6 +594,9 @@ class Application {
   std::vector<const char*> getRequiredExtensions();
   bool checkValidationLayerSupport();
   static std::vector<char> readFile(const std::string& filename);
+  AssetData findAsset(const std::string& name,
+                      std::vector<uint8_t>& storage) const;
+  std::vector<char> readAsset(const std::string& name) const;
   static VKAPI_ATTR VkBool32 VKAPI_CALL
   debugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
                 VkDebugUtilsMessageTypeFlagsEXT messageType,
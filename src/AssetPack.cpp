@@ -0,0 +1,238 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "AssetPack.hpp"
+
+#include <zstd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <system_error>
+
+#include "Hash.hpp"
+
+namespace {
+
+// Packing happens once, offline, so this favours ratio over speed.
+constexpr int COMPRESSION_LEVEL = 19;
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+bool compress(const std::vector<uint8_t>& data, std::vector<uint8_t>& stored) {
+  const std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)> context(
+      ZSTD_createCCtx(), ZSTD_freeCCtx);
+  if (!context) {
+    return false;
+  }
+  ZSTD_CCtx_setParameter(context.get(), ZSTD_c_compressionLevel,
+                         COMPRESSION_LEVEL);
+  ZSTD_CCtx_setParameter(context.get(), ZSTD_c_checksumFlag, 1);
+  stored.resize(ZSTD_compressBound(data.size()));
+  const size_t written = ZSTD_compress2(
+      context.get(), stored.data(), stored.size(), data.data(), data.size());
+  if (ZSTD_isError(written) != 0u) {
+    return false;
+  }
+  stored.resize(written);
+  return true;
+}
+
+void writePadding(std::ofstream& out, uint64_t from, uint64_t to) {
+  static constexpr char zeros[ASSET_PACK_ALIGNMENT]{};
+  out.write(zeros, static_cast<std::streamsize>(to - from));
+}
+
+}  // namespace
+
+uint64_t hashAssetName(const std::string& name) {
+  return hashBytes(name.data(), name.size());
+}
+
+bool AssetPack::open(const std::string& path) {
+  close();
+  if (!file_.open(path)) {
+    return false;
+  }
+  header_ = reinterpret_cast<const AssetPackHeader*>(file_.data());
+  if (!validate()) {
+    close();
+    return false;
+  }
+  entries_ = reinterpret_cast<const AssetPackEntry*>(file_.data() +
+                                                     header_->entryOffset);
+  return true;
+}
+
+void AssetPack::close() {
+  header_ = nullptr;
+  entries_ = nullptr;
+  file_.close();
+}
+
+const AssetPackEntry* AssetPack::find(const std::string& name) const {
+  if (header_ == nullptr) {
+    return nullptr;
+  }
+  const uint64_t hash = hashAssetName(name);
+  const AssetPackEntry* end = entries_ + header_->entryCount;
+  const AssetPackEntry* entry = std::lower_bound(
+      entries_, end, hash, [](const AssetPackEntry& e, uint64_t h) {
+        return e.nameHash < h;
+      });
+  return entry != end && entry->nameHash == hash ? entry : nullptr;
+}
+
+AssetData AssetPack::view(const std::string& name) const {
+  const AssetPackEntry* entry = find(name);
+  if (entry == nullptr || entry->compression != AssetCompression::None) {
+    return {};
+  }
+  return {file_.data() + entry->offset, static_cast<size_t>(entry->size)};
+}
+
+bool AssetPack::read(const std::string& name,
+                     std::vector<uint8_t>& data) const {
+  const AssetPackEntry* entry = find(name);
+  if (entry == nullptr) {
+    return false;
+  }
+  const uint8_t* stored = file_.data() + entry->offset;
+  data.resize(static_cast<size_t>(entry->size));
+  if (entry->compression == AssetCompression::None) {
+    std::copy(stored, stored + entry->size, data.begin());
+    return true;
+  }
+  const size_t decoded =
+      ZSTD_decompress(data.data(), data.size(), stored,
+                      static_cast<size_t>(entry->storedSize));
+  return ZSTD_isError(decoded) == 0u && decoded == data.size();
+}
+
+// Everything read() and view() rely on is checked here, so that lookups on a
+// truncated or corrupt pack fail instead of reading out of bounds.
+bool AssetPack::validate() const {
+  if (file_.size() < sizeof(AssetPackHeader)) {
+    return false;
+  }
+  if (header_->magic != ASSET_PACK_MAGIC ||
+      header_->version != ASSET_PACK_VERSION) {
+    return false;
+  }
+  const uint64_t fileSize = file_.size();
+  const uint64_t tableBytes =
+      uint64_t{header_->entryCount} * sizeof(AssetPackEntry);
+  if (header_->entryOffset % alignof(AssetPackEntry) != 0 ||
+      header_->entryOffset > fileSize ||
+      tableBytes > fileSize - header_->entryOffset) {
+    return false;
+  }
+
+  const auto* entries = reinterpret_cast<const AssetPackEntry*>(
+      file_.data() + header_->entryOffset);
+  for (uint32_t i{0}; i < header_->entryCount; ++i) {
+    const AssetPackEntry& entry = entries[i];
+    if (i != 0 && entries[i - 1].nameHash >= entry.nameHash) {
+      return false;
+    }
+    if (entry.alignment == 0 || entry.offset % entry.alignment != 0 ||
+        entry.offset < header_->payloadOffset || entry.offset > fileSize ||
+        entry.storedSize > fileSize - entry.offset) {
+      return false;
+    }
+    if (entry.compression == AssetCompression::None) {
+      if (entry.size != entry.storedSize) {
+        return false;
+      }
+    } else if (entry.compression != AssetCompression::Zstd) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool AssetPack::write(const std::string& path,
+                      const std::vector<AssetSource>& sources) {
+  struct Packed {
+    AssetPackEntry entry;
+    const std::vector<uint8_t>* stored;
+  };
+  std::vector<std::vector<uint8_t>> compressed(sources.size());
+  std::vector<Packed> packed(sources.size());
+  for (size_t i{0}; i < sources.size(); ++i) {
+    const AssetSource& source = sources[i];
+    AssetPackEntry& entry = packed[i].entry;
+    entry.nameHash = hashAssetName(source.name);
+    entry.size = source.data.size();
+    entry.compression = source.compression;
+    entry.alignment = static_cast<uint32_t>(ASSET_PACK_ALIGNMENT);
+    packed[i].stored = &source.data;
+    if (source.compression == AssetCompression::Zstd) {
+      if (!compress(source.data, compressed[i])) {
+        return false;
+      }
+      packed[i].stored = &compressed[i];
+    }
+    entry.storedSize = packed[i].stored->size();
+  }
+
+  std::sort(packed.begin(), packed.end(),
+            [](const Packed& a, const Packed& b) {
+              return a.entry.nameHash < b.entry.nameHash;
+            });
+  for (size_t i{1}; i < packed.size(); ++i) {
+    if (packed[i - 1].entry.nameHash == packed[i].entry.nameHash) {
+      return false;
+    }
+  }
+
+  AssetPackHeader header{};
+  header.magic = ASSET_PACK_MAGIC;
+  header.version = ASSET_PACK_VERSION;
+  header.entryCount = static_cast<uint32_t>(packed.size());
+  header.entryOffset = sizeof(AssetPackHeader);
+  header.payloadOffset =
+      alignUp(header.entryOffset + packed.size() * sizeof(AssetPackEntry),
+              ASSET_PACK_ALIGNMENT);
+  uint64_t offset = header.payloadOffset;
+  for (Packed& p : packed) {
+    p.entry.offset = offset;
+    offset = alignUp(offset + p.entry.storedSize, ASSET_PACK_ALIGNMENT);
+  }
+
+  // Written next to the destination and renamed, like the mesh cache.
+  const std::string tempPath = path + ".tmp";
+  {
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const Packed& p : packed) {
+      out.write(reinterpret_cast<const char*>(&p.entry), sizeof(p.entry));
+    }
+    uint64_t written =
+        header.entryOffset + packed.size() * sizeof(AssetPackEntry);
+    for (const Packed& p : packed) {
+      writePadding(out, written, p.entry.offset);
+      out.write(reinterpret_cast<const char*>(p.stored->data()),
+                static_cast<std::streamsize>(p.entry.storedSize));
+      written = p.entry.offset + p.entry.storedSize;
+    }
+    if (!out.good()) {
+      return false;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tempPath, path, ec);
+  if (ec) {
+    std::filesystem::remove(tempPath, ec);
+    return false;
+  }
+  return true;
+}
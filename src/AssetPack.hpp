@@ -0,0 +1,92 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_ASSETPACK_HPP
+#define VULKANTEST_ASSETPACK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.hpp"
+
+constexpr uint32_t ASSET_PACK_MAGIC = 0x4b505456;  // "VTPK"
+constexpr uint32_t ASSET_PACK_VERSION = 1;
+// Every entry starts on its own page, so an entry that is used in place
+// (a mesh cache) is as aligned as a file of its own would be.
+constexpr uint64_t ASSET_PACK_ALIGNMENT = 4096;
+
+enum class AssetCompression : uint32_t {
+  None = 0,
+  Zstd = 1,
+};
+
+// On-disk layout of an asset pack: this header, entryCount AssetPackEntry
+// records sorted by nameHash, then the payload.
+struct AssetPackHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t entryCount;
+  uint32_t reserved;
+  uint64_t entryOffset;
+  uint64_t payloadOffset;
+};
+
+struct AssetPackEntry {
+  uint64_t nameHash;
+  uint64_t offset;      // from the start of the pack, a multiple of alignment
+  uint64_t storedSize;  // bytes in the pack
+  uint64_t size;        // bytes after decompression
+  AssetCompression compression;
+  uint32_t alignment;
+};
+
+// Bytes of an entry, in the pack mapping or in memory owned by the caller.
+struct AssetData {
+  const uint8_t* data{nullptr};
+  size_t size{0};
+};
+
+// An asset to be packed. Names are relative to the asset directory, with
+// forward slashes, e.g. "textures/viking_room.png".
+struct AssetSource {
+  std::string name;
+  std::vector<uint8_t> data;
+  AssetCompression compression{AssetCompression::None};
+};
+
+uint64_t hashAssetName(const std::string& name);
+
+// One mapped file holding every asset. Lookups are a binary search over the
+// entry table; nothing is read until the entry's pages are touched.
+class AssetPack {
+ public:
+  // Maps the pack and validates its header and entry table. Returns false if
+  // the pack is missing or malformed.
+  bool open(const std::string& path);
+  void close();
+
+  [[nodiscard]] bool isOpen() const { return header_ != nullptr; }
+  [[nodiscard]] const AssetPackEntry* find(const std::string& name) const;
+  // The stored bytes of an uncompressed entry, used in place. Empty if the
+  // entry is missing or compressed.
+  [[nodiscard]] AssetData view(const std::string& name) const;
+  // Copies the entry into `data`, decompressing it if needed. Returns false
+  // if it is missing or damaged.
+  bool read(const std::string& name, std::vector<uint8_t>& data) const;
+
+  // Returns false if two names hash alike or the pack could not be written.
+  static bool write(const std::string& path,
+                    const std::vector<AssetSource>& sources);
+
+ private:
+  MappedFile file_;
+  const AssetPackHeader* header_{nullptr};
+  const AssetPackEntry* entries_{nullptr};
+
+  bool validate() const;
+};
+
+#endif  // VULKANTEST_ASSETPACK_HPP
@@ -0,0 +1,659 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "BlockCompression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+#include "Parallel.hpp"
+#include "TextureCache.hpp"
+
+namespace {
+
+constexpr uint32_t BLOCK_EXTENT = 4;
+constexpr size_t BLOCK_TEXELS = BLOCK_EXTENT * BLOCK_EXTENT;
+
+// Share of the second endpoint for each BC1 index in four-color mode.
+constexpr std::array<float, 4> BC1_WEIGHTS{0.0f, 1.0f, 1.0f / 3.0f,
+                                           2.0f / 3.0f};
+// Interpolation weights of BC7 4-bit indices, out of 64.
+constexpr std::array<uint32_t, 16> BC7_WEIGHTS{0,  4,  9,  13, 17, 21, 26, 30,
+                                               34, 38, 43, 47, 51, 55, 60, 64};
+
+using Texel = std::array<float, 4>;
+using Block = std::array<Texel, BLOCK_TEXELS>;
+using Indices = std::array<uint8_t, BLOCK_TEXELS>;
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+size_t blockBytes(VkFormat format) {
+  return textureLevelSize(format, BLOCK_EXTENT, BLOCK_EXTENT);
+}
+
+Block loadBlock(const uint8_t* pixels, uint32_t width, uint32_t height,
+                uint32_t blockX, uint32_t blockY) {
+  Block block{};
+  for (uint32_t y{0}; y < BLOCK_EXTENT; ++y) {
+    const uint32_t sourceY = std::min(blockY * BLOCK_EXTENT + y, height - 1);
+    for (uint32_t x{0}; x < BLOCK_EXTENT; ++x) {
+      const uint32_t sourceX = std::min(blockX * BLOCK_EXTENT + x, width - 1);
+      const uint8_t* texel = pixels + (size_t{sourceY} * width + sourceX) * 4;
+      for (size_t c{0}; c < 4; ++c) {
+        block[y * BLOCK_EXTENT + x][c] = texel[c];
+      }
+    }
+  }
+  return block;
+}
+
+void storeBlock(const std::array<std::array<uint8_t, 4>, BLOCK_TEXELS>& block,
+                uint32_t blockX, uint32_t blockY, uint32_t width,
+                uint32_t height, uint8_t* pixels) {
+  for (uint32_t y{0}; y < BLOCK_EXTENT; ++y) {
+    const uint32_t targetY = blockY * BLOCK_EXTENT + y;
+    for (uint32_t x{0}; x < BLOCK_EXTENT; ++x) {
+      const uint32_t targetX = blockX * BLOCK_EXTENT + x;
+      if (targetX >= width || targetY >= height) {
+        continue;
+      }
+      uint8_t* texel = pixels + (size_t{targetY} * width + targetX) * 4;
+      for (size_t c{0}; c < 4; ++c) {
+        texel[c] = block[y * BLOCK_EXTENT + x][c];
+      }
+    }
+  }
+}
+
+float squaredDistance(const Texel& a, const Texel& b, size_t channels) {
+  float sum{0.0f};
+  for (size_t c{0}; c < channels; ++c) {
+    sum += (a[c] - b[c]) * (a[c] - b[c]);
+  }
+  return sum;
+}
+
+Texel clampTexel(const Texel& texel) {
+  Texel clamped{};
+  for (size_t c{0}; c < 4; ++c) {
+    clamped[c] = std::clamp(texel[c], 0.0f, 255.0f);
+  }
+  return clamped;
+}
+
+// Endpoints at the extremes of the block's projection onto its principal
+// axis, found by power iteration on the covariance of the first `channels`
+// channels.
+std::pair<Texel, Texel> principalEndpoints(const Block& block,
+                                           size_t channels) {
+  Texel mean{};
+  for (const Texel& texel : block) {
+    for (size_t c{0}; c < channels; ++c) {
+      mean[c] += texel[c] / static_cast<float>(BLOCK_TEXELS);
+    }
+  }
+  std::array<Texel, 4> covariance{};
+  Texel axis{};
+  float farthest{-1.0f};
+  for (const Texel& texel : block) {
+    for (size_t i{0}; i < channels; ++i) {
+      for (size_t j{0}; j < channels; ++j) {
+        covariance[i][j] += (texel[i] - mean[i]) * (texel[j] - mean[j]);
+      }
+    }
+    // Starting from the outlier keeps the iteration off vectors that are
+    // orthogonal to the axis.
+    const float distance = squaredDistance(texel, mean, channels);
+    if (distance > farthest) {
+      farthest = distance;
+      for (size_t c{0}; c < channels; ++c) {
+        axis[c] = texel[c] - mean[c];
+      }
+    }
+  }
+  for (int iteration{0}; iteration < 8; ++iteration) {
+    Texel next{};
+    float largest{0.0f};
+    for (size_t i{0}; i < channels; ++i) {
+      for (size_t j{0}; j < channels; ++j) {
+        next[i] += covariance[i][j] * axis[j];
+      }
+      largest = std::max(largest, std::abs(next[i]));
+    }
+    if (largest < 1e-6f) {
+      break;
+    }
+    for (size_t c{0}; c < channels; ++c) {
+      axis[c] = next[c] / largest;
+    }
+  }
+
+  const float length = std::sqrt(squaredDistance(axis, Texel{}, channels));
+  if (length < 1e-6f) {
+    return {mean, mean};
+  }
+  float low{0.0f};
+  float high{0.0f};
+  for (const Texel& texel : block) {
+    float t{0.0f};
+    for (size_t c{0}; c < channels; ++c) {
+      t += (texel[c] - mean[c]) * axis[c] / length;
+    }
+    low = std::min(low, t);
+    high = std::max(high, t);
+  }
+  Texel first{};
+  Texel second{};
+  for (size_t c{0}; c < channels; ++c) {
+    first[c] = mean[c] + axis[c] / length * low;
+    second[c] = mean[c] + axis[c] / length * high;
+  }
+  return {clampTexel(first), clampTexel(second)};
+}
+
+// The endpoints that minimise the squared error for fixed indices, where
+// index i blends weights[i] of the second endpoint into the first. Returns
+// false if every texel uses the same weight.
+template <size_t N>
+bool fitEndpoints(const Block& block, size_t channels, const Indices& indices,
+                  const std::array<float, N>& weights, Texel& first,
+                  Texel& second) {
+  float aa{0.0f};
+  float ab{0.0f};
+  float bb{0.0f};
+  Texel ap{};
+  Texel bp{};
+  for (size_t i{0}; i < BLOCK_TEXELS; ++i) {
+    const float b = weights[indices[i]];
+    const float a = 1.0f - b;
+    aa += a * a;
+    ab += a * b;
+    bb += b * b;
+    for (size_t c{0}; c < channels; ++c) {
+      ap[c] += a * block[i][c];
+      bp[c] += b * block[i][c];
+    }
+  }
+  const float determinant = aa * bb - ab * ab;
+  if (std::abs(determinant) < 1e-6f) {
+    return false;
+  }
+  for (size_t c{0}; c < channels; ++c) {
+    first[c] = (ap[c] * bb - bp[c] * ab) / determinant;
+    second[c] = (bp[c] * aa - ap[c] * ab) / determinant;
+  }
+  first = clampTexel(first);
+  second = clampTexel(second);
+  return true;
+}
+
+template <typename Palette>
+float chooseIndices(const Block& block, size_t channels,
+                    const Palette& palette, Indices& indices) {
+  float error{0.0f};
+  for (size_t i{0}; i < BLOCK_TEXELS; ++i) {
+    float best = squaredDistance(block[i], palette[0], channels);
+    indices[i] = 0;
+    for (size_t p{1}; p < palette.size(); ++p) {
+      const float distance = squaredDistance(block[i], palette[p], channels);
+      if (distance < best) {
+        best = distance;
+        indices[i] = static_cast<uint8_t>(p);
+      }
+    }
+    error += best;
+  }
+  return error;
+}
+
+void writeLittleEndian(uint64_t value, size_t bytes, uint8_t* out) {
+  for (size_t i{0}; i < bytes; ++i) {
+    out[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+uint64_t readLittleEndian(const uint8_t* in, size_t bytes) {
+  uint64_t value{0};
+  for (size_t i{0}; i < bytes; ++i) {
+    value |= uint64_t{in[i]} << (8 * i);
+  }
+  return value;
+}
+
+// ---- BC1 color ----
+
+uint16_t packRgb565(const Texel& color) {
+  const auto quantize = [](float value, float levels) {
+    return static_cast<uint16_t>(std::lround(value * levels / 255.0f));
+  };
+  return static_cast<uint16_t>(quantize(color[0], 31.0f) << 11 |
+                               quantize(color[1], 63.0f) << 5 |
+                               quantize(color[2], 31.0f));
+}
+
+std::array<uint8_t, 4> unpackRgb565(uint16_t color) {
+  const unsigned int r = color >> 11 & 31u;
+  const unsigned int g = color >> 5 & 63u;
+  const unsigned int b = color & 31u;
+  return {static_cast<uint8_t>(r << 3 | r >> 2),
+          static_cast<uint8_t>(g << 2 | g >> 4),
+          static_cast<uint8_t>(b << 3 | b >> 2), 255};
+}
+
+// The four colors a BC1 block decodes to; three plus black if
+// `threeColorMode`.
+std::array<std::array<uint8_t, 4>, 4> colorPalette(uint16_t color0,
+                                                   uint16_t color1,
+                                                   bool threeColorMode) {
+  std::array<std::array<uint8_t, 4>, 4> palette{};
+  palette[0] = unpackRgb565(color0);
+  palette[1] = unpackRgb565(color1);
+  for (size_t c{0}; c < 3; ++c) {
+    const unsigned int a = palette[0][c];
+    const unsigned int b = palette[1][c];
+    if (threeColorMode) {
+      palette[2][c] = static_cast<uint8_t>((a + b) / 2);
+      palette[3][c] = 0;
+    } else {
+      palette[2][c] = static_cast<uint8_t>((2 * a + b) / 3);
+      palette[3][c] = static_cast<uint8_t>((a + 2 * b) / 3);
+    }
+  }
+  palette[2][3] = 255;
+  palette[3][3] = 255;
+  return palette;
+}
+
+struct ColorFit {
+  uint16_t color0;
+  uint16_t color1;
+  Indices indices;
+  float error;
+};
+
+ColorFit fitColors(const Block& block, const Texel& first,
+                   const Texel& second) {
+  ColorFit fit{};
+  fit.color0 = packRgb565(first);
+  fit.color1 = packRgb565(second);
+  std::array<Texel, 4> palette{};
+  const auto bytes = colorPalette(fit.color0, fit.color1, false);
+  for (size_t p{0}; p < palette.size(); ++p) {
+    for (size_t c{0}; c < 3; ++c) {
+      palette[p][c] = bytes[p][c];
+    }
+  }
+  fit.error = chooseIndices(block, 3, palette, fit.indices);
+  return fit;
+}
+
+void encodeColorBlock(const Block& block, uint8_t* out) {
+  auto [first, second] = principalEndpoints(block, 3);
+  ColorFit fit = fitColors(block, first, second);
+  if (fitEndpoints(block, 3, fit.indices, BC1_WEIGHTS, first, second)) {
+    const ColorFit refined = fitColors(block, first, second);
+    if (refined.error < fit.error) {
+      fit = refined;
+    }
+  }
+  // Four-color mode is color0 > color1; swapping the endpoints swaps the
+  // indices 0 <-> 1 and 2 <-> 3.
+  if (fit.color0 < fit.color1) {
+    std::swap(fit.color0, fit.color1);
+    for (uint8_t& index : fit.indices) {
+      index ^= 1u;
+    }
+  } else if (fit.color0 == fit.color1) {
+    fit.indices.fill(0);
+  }
+
+  uint64_t indexBits{0};
+  for (size_t i{0}; i < BLOCK_TEXELS; ++i) {
+    indexBits |= uint64_t{fit.indices[i]} << (2 * i);
+  }
+  writeLittleEndian(fit.color0, 2, out);
+  writeLittleEndian(fit.color1, 2, out + 2);
+  writeLittleEndian(indexBits, 4, out + 4);
+}
+
+void decodeColorBlock(const uint8_t* in, bool alwaysFourColors,
+                      std::array<std::array<uint8_t, 4>, BLOCK_TEXELS>& out) {
+  const auto color0 = static_cast<uint16_t>(readLittleEndian(in, 2));
+  const auto color1 = static_cast<uint16_t>(readLittleEndian(in + 2, 2));
+  const uint64_t indexBits = readLittleEndian(in + 4, 4);
+  const auto palette =
+      colorPalette(color0, color1, !alwaysFourColors && color0 <= color1);
+  for (size_t i{0}; i < BLOCK_TEXELS; ++i) {
+    out[i] = palette[indexBits >> (2 * i) & 3u];
+  }
+}
+
+// ---- BC3 alpha ----
+
+std::array<uint8_t, 8> alphaPalette(uint8_t alpha0, uint8_t alpha1) {
+  std::array<uint8_t, 8> palette{alpha0, alpha1};
+  const unsigned int a = alpha0;
+  const unsigned int b = alpha1;
+  if (alpha0 > alpha1) {
+    for (unsigned int i{2}; i < 8; ++i) {
+      palette[i] = static_cast<uint8_t>(((8 - i) * a + (i - 1) * b) / 7);
+    }
+  } else {
+    for (unsigned int i{2}; i < 6; ++i) {
+      palette[i] = static_cast<uint8_t>(((6 - i) * a + (i - 1) * b) / 5);
+    }
+    palette[6] = 0;
+    palette[7] = 255;
+  }
+  return palette;
+}
+
+void encodeAlphaBlock(const Block& block, uint8_t* out) {
+  float low{255.0f};
+  float high{0.0f};
+  for (const Texel& texel : block) {
+    low = std::min(low, texel[3]);
+    high = std::max(high, texel[3]);
+  }
+  const auto alpha0 = static_cast<uint8_t>(high);
+  const auto alpha1 = static_cast<uint8_t>(low);
+  const std::array<uint8_t, 8> palette = alphaPalette(alpha0, alpha1);
+
+  uint64_t indexBits{0};
+  for (size_t i{0}; i < BLOCK_TEXELS; ++i) {
+    uint64_t best{0};
+    float bestError = std::abs(block[i][3] - palette[0]);
+    for (uint64_t p{1}; p < (alpha0 > alpha1 ? 8u : 1u); ++p) {
+      const float error = std::abs(block[i][3] - palette[p]);
+      if (error < bestError) {
+        bestError = error;
+        best = p;
+      }
+    }
+    indexBits |= best << (3 * i);
+  }
+  out[0] = alpha0;
+  out[1] = alpha1;
+  writeLittleEndian(indexBits, 6, out + 2);
+}
+
+void decodeAlphaBlock(const uint8_t* in,
+                      std::array<std::array<uint8_t, 4>, BLOCK_TEXELS>& out) {
+  const std::array<uint8_t, 8> palette = alphaPalette(in[0], in[1]);
+  const uint64_t indexBits = readLittleEndian(in + 2, 6);
+  for (size_t i{0}; i < BLOCK_TEXELS; ++i) {
+    out[i][3] = palette[indexBits >> (3 * i) & 7u];
+  }
+}
+
+// ---- BC7 mode 6 ----
+
+// 128 bits, filled and read least significant bit first.
+class BlockBits {
+ public:
+  BlockBits() = default;
+  explicit BlockBits(const uint8_t* bytes) {
+    std::copy(bytes, bytes + bytes_.size(), bytes_.begin());
+  }
+
+  void write(uint32_t value, size_t count) {
+    for (size_t i{0}; i < count; ++i, ++position_) {
+      if ((value >> i & 1u) != 0) {
+        bytes_[position_ / 8] |= static_cast<uint8_t>(1u << (position_ % 8));
+      }
+    }
+  }
+
+  uint32_t read(size_t count) {
+    uint32_t value{0};
+    for (size_t i{0}; i < count; ++i, ++position_) {
+      value |= uint32_t{bytes_[position_ / 8] >> (position_ % 8) & 1u} << i;
+    }
+    return value;
+  }
+
+  [[nodiscard]] const std::array<uint8_t, 16>& bytes() const {
+    return bytes_;
+  }
+
+ private:
+  std::array<uint8_t, 16> bytes_{};
+  size_t position_{0};
+};
+
+// A mode 6 endpoint: 7 bits per channel and a p-bit shared by all four as
+// their lowest bit.
+struct Bc7Endpoint {
+  std::array<uint8_t, 4> value;
+  uint32_t pBit;
+};
+
+Bc7Endpoint quantizeBc7(const Texel& color) {
+  Bc7Endpoint best{};
+  float bestError{-1.0f};
+  for (uint32_t p{0}; p < 2; ++p) {
+    Bc7Endpoint candidate{};
+    candidate.pBit = p;
+    float error{0.0f};
+    for (size_t c{0}; c < 4; ++c) {
+      const long q = std::clamp(
+          std::lround((color[c] - static_cast<float>(p)) / 2.0f), 0L, 127L);
+      candidate.value[c] = static_cast<uint8_t>(q << 1 | long{p});
+      const float difference = color[c] - candidate.value[c];
+      error += difference * difference;
+    }
+    if (bestError < 0.0f || error < bestError) {
+      best = candidate;
+      bestError = error;
+    }
+  }
+  return best;
+}
+
+std::array<Texel, 16> bc7Palette(const Bc7Endpoint& first,
+                                 const Bc7Endpoint& second) {
+  std::array<Texel, 16> palette{};
+  for (size_t i{0}; i < palette.size(); ++i) {
+    const uint32_t w = BC7_WEIGHTS[i];
+    for (size_t c{0}; c < 4; ++c) {
+      palette[i][c] = static_cast<float>(
+          ((64 - w) * first.value[c] + w * second.value[c] + 32) >> 6);
+    }
+  }
+  return palette;
+}
+
+struct Bc7Fit {
+  Bc7Endpoint first;
+  Bc7Endpoint second;
+  Indices indices;
+  float error;
+};
+
+Bc7Fit fitBc7(const Block& block, const Texel& first, const Texel& second) {
+  Bc7Fit fit{};
+  fit.first = quantizeBc7(first);
+  fit.second = quantizeBc7(second);
+  fit.error = chooseIndices(block, 4, bc7Palette(fit.first, fit.second),
+                            fit.indices);
+  return fit;
+}
+
+void encodeBc7Block(const Block& block, uint8_t* out) {
+  static const std::array<float, 16> weights = [] {
+    std::array<float, 16> values{};
+    for (size_t i{0}; i < values.size(); ++i) {
+      values[i] = static_cast<float>(BC7_WEIGHTS[i]) / 64.0f;
+    }
+    return values;
+  }();
+
+  auto [first, second] = principalEndpoints(block, 4);
+  Bc7Fit fit = fitBc7(block, first, second);
+  if (fitEndpoints(block, 4, fit.indices, weights, first, second)) {
+    const Bc7Fit refined = fitBc7(block, first, second);
+    if (refined.error < fit.error) {
+      fit = refined;
+    }
+  }
+  // The anchor index (texel 0) is stored without its top bit, so it must be
+  // below 8; swapping the endpoints mirrors every index.
+  if (fit.indices[0] >= 8) {
+    std::swap(fit.first, fit.second);
+    for (uint8_t& index : fit.indices) {
+      index = static_cast<uint8_t>(15 - index);
+    }
+  }
+
+  BlockBits bits;
+  bits.write(1u << 6, 7);
+  for (size_t c{0}; c < 4; ++c) {
+    bits.write(uint32_t{fit.first.value[c]} >> 1, 7);
+    bits.write(uint32_t{fit.second.value[c]} >> 1, 7);
+  }
+  bits.write(fit.first.pBit, 1);
+  bits.write(fit.second.pBit, 1);
+  bits.write(fit.indices[0], 3);
+  for (size_t i{1}; i < BLOCK_TEXELS; ++i) {
+    bits.write(fit.indices[i], 4);
+  }
+  std::copy(bits.bytes().begin(), bits.bytes().end(), out);
+}
+
+bool decodeBc7Block(const uint8_t* in,
+                    std::array<std::array<uint8_t, 4>, BLOCK_TEXELS>& out) {
+  BlockBits bits(in);
+  if (bits.read(7) != 1u << 6) {
+    return false;
+  }
+  Bc7Endpoint first{};
+  Bc7Endpoint second{};
+  for (size_t c{0}; c < 4; ++c) {
+    first.value[c] = static_cast<uint8_t>(bits.read(7) << 1);
+    second.value[c] = static_cast<uint8_t>(bits.read(7) << 1);
+  }
+  first.pBit = bits.read(1);
+  second.pBit = bits.read(1);
+  for (size_t c{0}; c < 4; ++c) {
+    first.value[c] = static_cast<uint8_t>(first.value[c] | first.pBit);
+    second.value[c] = static_cast<uint8_t>(second.value[c] | second.pBit);
+  }
+  const std::array<Texel, 16> palette = bc7Palette(first, second);
+  for (size_t i{0}; i < BLOCK_TEXELS; ++i) {
+    const uint32_t index = bits.read(i == 0 ? 3 : 4);
+    for (size_t c{0}; c < 4; ++c) {
+      out[i][c] = static_cast<uint8_t>(palette[index][c]);
+    }
+  }
+  return true;
+}
+
+void encodeBlock(VkFormat format, const Block& block, uint8_t* out) {
+  switch (format) {
+    case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+      encodeColorBlock(block, out);
+      break;
+    case VK_FORMAT_BC3_SRGB_BLOCK:
+      encodeAlphaBlock(block, out);
+      encodeColorBlock(block, out + 8);
+      break;
+    case VK_FORMAT_BC7_SRGB_BLOCK:
+      encodeBc7Block(block, out);
+      break;
+    default:
+      break;
+  }
+}
+
+bool decodeBlock(VkFormat format, const uint8_t* in,
+                 std::array<std::array<uint8_t, 4>, BLOCK_TEXELS>& out) {
+  switch (format) {
+    case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+      decodeColorBlock(in, false, out);
+      return true;
+    case VK_FORMAT_BC3_SRGB_BLOCK:
+      decodeColorBlock(in + 8, true, out);
+      decodeAlphaBlock(in, out);
+      return true;
+    case VK_FORMAT_BC7_SRGB_BLOCK:
+      return decodeBc7Block(in, out);
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+bool isBlockCompressed(VkFormat format) {
+  return format == VK_FORMAT_BC1_RGB_SRGB_BLOCK ||
+         format == VK_FORMAT_BC3_SRGB_BLOCK ||
+         format == VK_FORMAT_BC7_SRGB_BLOCK;
+}
+
+void compressBlocks(VkFormat format, const uint8_t* pixels, uint32_t width,
+                    uint32_t height, uint8_t* blocks,
+                    unsigned int threadCount) {
+  const uint32_t blocksWide = (width + BLOCK_EXTENT - 1) / BLOCK_EXTENT;
+  const uint32_t blocksHigh = (height + BLOCK_EXTENT - 1) / BLOCK_EXTENT;
+  const size_t bytes = blockBytes(format);
+  parallelFor(
+      blocksHigh,
+      [&](size_t row) {
+        const auto blockY = static_cast<uint32_t>(row);
+        for (uint32_t blockX{0}; blockX < blocksWide; ++blockX) {
+          encodeBlock(format, loadBlock(pixels, width, height, blockX, blockY),
+                      blocks + (row * blocksWide + blockX) * bytes);
+        }
+      },
+      threadCount);
+}
+
+bool decompressBlocks(VkFormat format, const uint8_t* blocks, uint32_t width,
+                      uint32_t height, uint8_t* pixels) {
+  const uint32_t blocksWide = (width + BLOCK_EXTENT - 1) / BLOCK_EXTENT;
+  const uint32_t blocksHigh = (height + BLOCK_EXTENT - 1) / BLOCK_EXTENT;
+  const size_t bytes = blockBytes(format);
+  std::array<std::array<uint8_t, 4>, BLOCK_TEXELS> block{};
+  for (uint32_t blockY{0}; blockY < blocksHigh; ++blockY) {
+    for (uint32_t blockX{0}; blockX < blocksWide; ++blockX) {
+      const size_t index = size_t{blockY} * blocksWide + blockX;
+      if (!decodeBlock(format, blocks + index * bytes, block)) {
+        return false;
+      }
+      storeBlock(block, blockX, blockY, width, height, pixels);
+    }
+  }
+  return true;
+}
+
+CookedTexture compressTexture(const TextureView& texture, VkFormat format,
+                              unsigned int threadCount) {
+  CookedTexture compressed;
+  compressed.format = format;
+  compressed.width = texture.width;
+  compressed.height = texture.height;
+  compressed.contentWidth = texture.contentWidth;
+  compressed.contentHeight = texture.contentHeight;
+  uint64_t size{0};
+  for (uint32_t level{0}; level < texture.levelCount; ++level) {
+    TextureLevel entry = texture.levels[level];
+    entry.offset = size;
+    entry.size = textureLevelSize(format, entry.width, entry.height);
+    compressed.levels.push_back(entry);
+    size = alignUp(entry.offset + entry.size, TEXTURE_CACHE_ALIGNMENT);
+  }
+
+  compressed.data.resize(size);
+  for (uint32_t level{0}; level < texture.levelCount; ++level) {
+    const TextureLevel& entry = compressed.levels[level];
+    compressBlocks(format, texture.data + texture.levels[level].offset,
+                   entry.width, entry.height,
+                   compressed.data.data() + entry.offset, threadCount);
+  }
+  return compressed;
+}
@@ -0,0 +1,42 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_BLOCKCOMPRESSION_HPP
+#define VULKANTEST_BLOCKCOMPRESSION_HPP
+
+#include <cstdint>
+
+#include "Texture.hpp"
+
+// CPU encoders for the BC formats textures are cooked to. Each 4x4 block is
+// fitted on its own: the endpoints start on the principal axis of the block's
+// colors and are refined once by least squares for the chosen indices.
+//
+// BC1 is written in its four-color mode only (no punch-through alpha), BC3 as
+// that color block plus an eight-value alpha block, and BC7 as mode 6 only
+// (one RGBA subset, 7-bit endpoints with a p-bit, 4-bit indices), which is
+// the best of the single-subset modes for smooth textures.
+
+// Whether textures can be cooked to `format`.
+bool isBlockCompressed(VkFormat format);
+
+// Encodes a width x height RGBA8 image into the 4x4 blocks of `format`, one
+// row of blocks after the other. Blocks that hang over the edge repeat the
+// last row and column. `blocks` holds textureLevelSize(format, width, height)
+// bytes. Rows of blocks are encoded in parallel.
+void compressBlocks(VkFormat format, const uint8_t* pixels, uint32_t width,
+                    uint32_t height, uint8_t* blocks,
+                    unsigned int threadCount = 0);
+
+// Inverse of compressBlocks(), for tests and tools. Returns false if a block
+// uses a BC7 mode other than 6.
+bool decompressBlocks(VkFormat format, const uint8_t* blocks, uint32_t width,
+                      uint32_t height, uint8_t* pixels);
+
+// Every level of an RGBA8 texture encoded to `format`, in the layout of a
+// texture cache.
+CookedTexture compressTexture(const TextureView& texture, VkFormat format,
+                              unsigned int threadCount = 0);
+
+#endif  // VULKANTEST_BLOCKCOMPRESSION_HPP
@@ -0,0 +1,122 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "CompactVertex.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr float UNORM16_MAX = 65535.0f;
+
+uint16_t quantizeUnorm16(float value, float min, float extent) {
+  if (extent <= 0.0f) {
+    return 0;
+  }
+  const float normalized = std::clamp((value - min) / extent, 0.0f, 1.0f);
+  return static_cast<uint16_t>(std::lround(normalized * UNORM16_MAX));
+}
+
+}  // namespace
+
+uint16_t floatToHalf(float value) {
+  uint32_t bits{0};
+  std::memcpy(&bits, &value, sizeof(bits));
+  const auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+  const uint32_t magnitude = bits & 0x7fffffffu;
+
+  if (magnitude >= 0x7f800000u) {
+    // Infinity stays infinity, NaN stays (quiet) NaN.
+    return static_cast<uint16_t>(sign | 0x7c00u |
+                                 (magnitude > 0x7f800000u ? 0x200u : 0u));
+  }
+  if (magnitude >= 0x477ff000u) {
+    // 65520 and above round to infinity.
+    return static_cast<uint16_t>(sign | 0x7c00u);
+  }
+  if (magnitude < 0x38800000u) {
+    // Subnormal half: count units of 2^-24. The scaling is exact, and lrint
+    // rounds to nearest even; 1024 units correctly becomes the smallest
+    // normal.
+    float absolute{0.0f};
+    std::memcpy(&absolute, &magnitude, sizeof(absolute));
+    return static_cast<uint16_t>(sign | std::lrint(absolute * 16777216.0f));
+  }
+
+  // Rebias the exponent from 127 to 15 and drop 13 mantissa bits.
+  uint32_t half = (magnitude - 0x38000000u) >> 13;
+  const uint32_t rest = magnitude & 0x1fffu;
+  if (rest > 0x1000u || (rest == 0x1000u && (half & 1u) != 0)) {
+    ++half;
+  }
+  return static_cast<uint16_t>(sign | half);
+}
+
+float halfToFloat(uint16_t half) {
+  const uint32_t sign = (half & 0x8000u) << 16;
+  const uint32_t exponent = (half >> 10) & 0x1fu;
+  const uint32_t mantissa = half & 0x3ffu;
+
+  float value{0.0f};
+  if (exponent == 0) {
+    value = std::ldexp(static_cast<float>(mantissa), -24);
+  } else if (exponent == 0x1f) {
+    value = mantissa == 0 ? INFINITY : NAN;
+  } else {
+    const uint32_t bits = ((exponent + 112) << 23) | (mantissa << 13);
+    std::memcpy(&value, &bits, sizeof(value));
+  }
+  return sign != 0 ? -value : value;
+}
+
+PositionDequantization positionDequantization(const MeshBounds& bounds) {
+  PositionDequantization dequantization;
+  dequantization.scale = bounds.max - bounds.min;
+  dequantization.offset = bounds.min;
+  return dequantization;
+}
+
+CompactVertex compactVertex(const Vertex& vertex, const MeshBounds& bounds) {
+  const glm::vec3 extent = bounds.max - bounds.min;
+  CompactVertex compact{};
+  for (int axis{0}; axis < 3; ++axis) {
+    compact.pos[static_cast<size_t>(axis)] =
+        quantizeUnorm16(vertex.pos[axis], bounds.min[axis], extent[axis]);
+  }
+  compact.texCoord[0] = floatToHalf(vertex.texCoord.x);
+  compact.texCoord[1] = floatToHalf(vertex.texCoord.y);
+  return compact;
+}
+
+std::vector<CompactVertex> compactVertices(const Vertex* vertices, size_t count,
+                                           const MeshBounds& bounds) {
+  std::vector<CompactVertex> compact(count);
+  compactVertices(vertices, count, bounds, compact.data());
+  return compact;
+}
+
+void compactVertices(const Vertex* vertices, size_t count,
+                     const MeshBounds& bounds, CompactVertex* compact) {
+  for (size_t i{0}; i < count; ++i) {
+    compact[i] = compactVertex(vertices[i], bounds);
+  }
+}
+
+Vertex expandVertex(const CompactVertex& vertex, const MeshBounds& bounds) {
+  const PositionDequantization dequantization =
+      positionDequantization(bounds);
+  Vertex expanded{};
+  for (int axis{0}; axis < 3; ++axis) {
+    expanded.pos[axis] =
+        dequantization.offset[axis] +
+        static_cast<float>(vertex.pos[static_cast<size_t>(axis)]) /
+            UNORM16_MAX * dequantization.scale[axis];
+  }
+  expanded.color = glm::vec3(1.0f);
+  expanded.texCoord = {halfToFloat(vertex.texCoord[0]),
+                       halfToFloat(vertex.texCoord[1])};
+  return expanded;
+}
@@ -0,0 +1,79 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_COMPACTVERTEX_HPP
+#define VULKANTEST_COMPACTVERTEX_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.hpp"
+
+// Vertex layout uploaded to the GPU.
+enum class VertexFormat {
+  Full,     // Vertex, 32 bytes
+  Compact,  // CompactVertex, 12 bytes
+  Split,    // VertexPosition and VertexAttributes streams, 12 + 20 bytes
+};
+
+// 12-byte vertex: positions as 16-bit unorm relative to the mesh bounds, UVs
+// as half floats, no color (it is always white). The vertex shader built with
+// COMPACT_VERTEX dequantizes positions with the scale and offset from
+// positionDequantization().
+struct CompactVertex {
+  std::array<uint16_t, 4> pos;  // w is padding
+  std::array<uint16_t, 2> texCoord;
+
+  static VkVertexInputBindingDescription getBindingDescription() {
+    VkVertexInputBindingDescription bindingDescription{};
+    bindingDescription.binding = 0;
+    bindingDescription.stride = sizeof(CompactVertex);
+    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    return bindingDescription;
+  }
+
+  static std::array<VkVertexInputAttributeDescription, 2>
+  getAttributeDescriptions() {
+    std::array<VkVertexInputAttributeDescription, 2> attributeDescriptions{};
+
+    attributeDescriptions[0].binding = 0;
+    attributeDescriptions[0].location = 0;
+    attributeDescriptions[0].format = VK_FORMAT_R16G16B16A16_UNORM;
+    attributeDescriptions[0].offset = offsetof(CompactVertex, pos);
+
+    attributeDescriptions[1].binding = 0;
+    attributeDescriptions[1].location = 2;
+    attributeDescriptions[1].format = VK_FORMAT_R16G16_SFLOAT;
+    attributeDescriptions[1].offset = offsetof(CompactVertex, texCoord);
+
+    return attributeDescriptions;
+  }
+};
+
+// IEEE 754 binary16 conversion, rounding to nearest even.
+uint16_t floatToHalf(float value);
+float halfToFloat(uint16_t half);
+
+// Scale and offset that map unorm positions in [0, 1] back into `bounds`.
+struct PositionDequantization {
+  glm::vec3 scale{1.0f};
+  glm::vec3 offset{0.0f};
+};
+
+PositionDequantization positionDequantization(const MeshBounds& bounds);
+
+CompactVertex compactVertex(const Vertex& vertex, const MeshBounds& bounds);
+std::vector<CompactVertex> compactVertices(const Vertex* vertices, size_t count,
+                                           const MeshBounds& bounds);
+// Writes the `count` compacted vertices to `compact`, e.g. mapped memory.
+void compactVertices(const Vertex* vertices, size_t count,
+                     const MeshBounds& bounds, CompactVertex* compact);
+
+// Inverse of compactVertex(), with the color set to white.
+Vertex expandVertex(const CompactVertex& vertex, const MeshBounds& bounds);
+
+#endif  // VULKANTEST_COMPACTVERTEX_HPP
@@ -0,0 +1,108 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "FileWatcher.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+void statFile(const std::string& path, uint64_t& size, int64_t& mtime) {
+  std::error_code ec;
+  size = std::filesystem::file_size(path, ec);
+  if (ec) {
+    size = 0;
+  }
+  const auto writeTime = std::filesystem::last_write_time(path, ec);
+  mtime = ec ? 0 : writeTime.time_since_epoch().count();
+}
+
+}  // namespace
+
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+  if (inotify_ >= 0) {
+    ::close(inotify_);
+  }
+#endif
+}
+
+bool FileWatcher::add(const std::string& path) {
+  const std::filesystem::path file(path);
+  WatchedFile watched{};
+  watched.path = path;
+  watched.directory =
+      file.has_parent_path() ? file.parent_path().string() : ".";
+  watched.name = file.filename().string();
+  statFile(path, watched.size, watched.mtime);
+
+#ifdef __linux__
+  if (inotify_ < 0) {
+    inotify_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_ < 0) {
+      return false;
+    }
+  }
+  // Adding a directory twice returns the same watch.
+  watched.watch = inotify_add_watch(inotify_, watched.directory.c_str(),
+                                    IN_CLOSE_WRITE | IN_MOVED_TO);
+  if (watched.watch < 0) {
+    return false;
+  }
+#endif
+
+  files_.push_back(watched);
+  return true;
+}
+
+std::vector<std::string> FileWatcher::poll() {
+  std::vector<std::string> changed;
+  const auto report = [&changed](const std::string& path) {
+    if (std::find(changed.begin(), changed.end(), path) == changed.end()) {
+      changed.push_back(path);
+    }
+  };
+
+#ifdef __linux__
+  alignas(inotify_event) char buffer[4096];
+  for (;;) {
+    const ssize_t length =
+        inotify_ < 0 ? -1 : read(inotify_, buffer, sizeof(buffer));
+    if (length <= 0) {
+      break;
+    }
+    for (ssize_t offset{0}; offset < length;) {
+      const auto* event =
+          reinterpret_cast<const inotify_event*>(buffer + offset);
+      if (event->len != 0) {
+        for (const WatchedFile& file : files_) {
+          if (file.watch == event->wd && file.name == event->name) {
+            report(file.path);
+          }
+        }
+      }
+      offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+    }
+  }
+#else
+  for (WatchedFile& file : files_) {
+    uint64_t size{0};
+    int64_t mtime{0};
+    statFile(file.path, size, mtime);
+    if (size != file.size || mtime != file.mtime) {
+      file.size = size;
+      file.mtime = mtime;
+      report(file.path);
+    }
+  }
+#endif
+  return changed;
+}
@@ -0,0 +1,43 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_FILEWATCHER_HPP
+#define VULKANTEST_FILEWATCHER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Reports files that were written since the last poll. On Linux this watches
+// the containing directories with inotify, which also sees editors that save
+// by renaming a new file over the old one; elsewhere poll() compares sizes
+// and modification times.
+class FileWatcher {
+ public:
+  FileWatcher() = default;
+  ~FileWatcher();
+  FileWatcher(const FileWatcher&) = delete;
+  FileWatcher& operator=(const FileWatcher&) = delete;
+
+  // Returns false if the file's directory cannot be watched.
+  bool add(const std::string& path);
+  // Never blocks. Each changed file is reported once, with the path it was
+  // added with.
+  std::vector<std::string> poll();
+
+ private:
+  struct WatchedFile {
+    std::string path;
+    std::string directory;
+    std::string name;
+    int watch{-1};
+    uint64_t size{0};
+    int64_t mtime{0};
+  };
+
+  std::vector<WatchedFile> files_;
+  int inotify_{-1};
+};
+
+#endif  // VULKANTEST_FILEWATCHER_HPP
@@ -0,0 +1,319 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "GeometryCodec.hpp"
+
+#include <zstd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Parallel.hpp"
+
+namespace {
+
+constexpr uint32_t STREAM_MAGIC = 0x53475456;  // "VTGS"
+
+enum class StreamKind : uint32_t {
+  Vertices = 1,
+  Indices = 2,
+};
+
+// A stream is this header, a table of blockCount entries and the compressed
+// blocks. Block i holds elements [i * blockElements, (i + 1) *
+// blockElements).
+struct StreamHeader {
+  uint32_t magic;
+  StreamKind kind;
+  uint32_t elementSize;
+  uint32_t blockElements;
+  uint64_t elementCount;
+  uint64_t blockCount;
+};
+
+struct BlockEntry {
+  uint64_t offset;  // from the start of the stream
+  uint64_t size;
+};
+
+// Filters turn `count` elements into as many bytes of planes and back.
+using Filter = void (*)(const uint8_t* elements, size_t count,
+                        size_t elementSize, uint8_t* planes);
+using Unfilter = void (*)(const uint8_t* planes, size_t count,
+                          size_t elementSize, uint8_t* elements);
+
+void filterVertices(const uint8_t* vertices, size_t count, size_t stride,
+                    uint8_t* planes) {
+  for (size_t b{0}; b < stride; ++b) {
+    uint8_t* plane = planes + b * count;
+    uint8_t previous{0};
+    for (size_t i{0}; i < count; ++i) {
+      const uint8_t value = vertices[i * stride + b];
+      plane[i] = static_cast<uint8_t>(value - previous);
+      previous = value;
+    }
+  }
+}
+
+// Works in tiles of rows: the deltas are transposed into place, then every
+// row is added bytewise onto the one above it, which is a plain vector add
+// over `stride` bytes.
+void unfilterVertices(const uint8_t* planes, size_t count, size_t stride,
+                      uint8_t* vertices) {
+  constexpr size_t TILE_ROWS = 64;
+  const std::vector<uint8_t> zeros(stride, 0);
+  const uint8_t* above = zeros.data();
+  for (size_t first{0}; first < count; first += TILE_ROWS) {
+    const size_t rows = std::min(TILE_ROWS, count - first);
+    uint8_t* tile = vertices + first * stride;
+    for (size_t b{0}; b < stride; ++b) {
+      const uint8_t* plane = planes + b * count + first;
+      for (size_t i{0}; i < rows; ++i) {
+        tile[i * stride + b] = plane[i];
+      }
+    }
+    for (size_t i{0}; i < rows; ++i) {
+      uint8_t* row = tile + i * stride;
+      for (size_t b{0}; b < stride; ++b) {
+        row[b] = static_cast<uint8_t>(row[b] + above[b]);
+      }
+      above = row;
+    }
+  }
+}
+
+template <typename T>
+void filterIndices(const uint8_t* indices, size_t count, uint8_t* planes) {
+  constexpr unsigned int BITS = sizeof(T) * 8;
+  T previous{0};
+  for (size_t i{0}; i < count; ++i) {
+    T value{0};
+    std::memcpy(&value, indices + i * sizeof(T), sizeof(T));
+    const auto delta = static_cast<T>(value - previous);
+    const auto sign = static_cast<T>(delta >> (BITS - 1));
+    const auto zigzag =
+        static_cast<T>(static_cast<T>(delta << 1) ^ static_cast<T>(0u - sign));
+    for (size_t b{0}; b < sizeof(T); ++b) {
+      planes[b * count + i] = static_cast<uint8_t>(zigzag >> (b * 8));
+    }
+    previous = value;
+  }
+}
+
+template <typename T>
+void unfilterIndices(const uint8_t* planes, size_t count, uint8_t* indices) {
+  T previous{0};
+  for (size_t i{0}; i < count; ++i) {
+    T zigzag{0};
+    for (size_t b{0}; b < sizeof(T); ++b) {
+      zigzag = static_cast<T>(zigzag | (T{planes[b * count + i]} << (b * 8)));
+    }
+    const auto delta = static_cast<T>(static_cast<T>(zigzag >> 1) ^
+                                      static_cast<T>(0u - (zigzag & 1u)));
+    previous = static_cast<T>(previous + delta);
+    std::memcpy(indices + i * sizeof(T), &previous, sizeof(T));
+  }
+}
+
+void filterIndices(const uint8_t* indices, size_t count, size_t indexSize,
+                   uint8_t* planes) {
+  if (indexSize == sizeof(uint16_t)) {
+    filterIndices<uint16_t>(indices, count, planes);
+  } else {
+    filterIndices<uint32_t>(indices, count, planes);
+  }
+}
+
+void unfilterIndices(const uint8_t* planes, size_t count, size_t indexSize,
+                     uint8_t* indices) {
+  if (indexSize == sizeof(uint16_t)) {
+    unfilterIndices<uint16_t>(planes, count, indices);
+  } else {
+    unfilterIndices<uint32_t>(planes, count, indices);
+  }
+}
+
+std::vector<uint8_t> encodeStream(StreamKind kind, const void* elements,
+                                  size_t count, size_t elementSize,
+                                  size_t blockElements, Filter filter,
+                                  unsigned int threadCount) {
+  const auto* bytes = static_cast<const uint8_t*>(elements);
+  const size_t blockCount = (count + blockElements - 1) / blockElements;
+  std::vector<std::vector<uint8_t>> blocks(blockCount);
+  parallelFor(
+      blockCount,
+      [&](size_t block) {
+        const size_t first = block * blockElements;
+        const size_t n = std::min(blockElements, count - first);
+        std::vector<uint8_t> planes(n * elementSize);
+        filter(bytes + first * elementSize, n, elementSize, planes.data());
+
+        // The frame checksum lets the decoder tell a damaged block from one
+        // that merely decompresses to the right size.
+        const std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)> context(
+            ZSTD_createCCtx(), ZSTD_freeCCtx);
+        if (!context) {
+          throw std::runtime_error("failed to compress geometry!");
+        }
+        ZSTD_CCtx_setParameter(context.get(), ZSTD_c_compressionLevel,
+                               CODEC_LEVEL);
+        ZSTD_CCtx_setParameter(context.get(), ZSTD_c_checksumFlag, 1);
+        std::vector<uint8_t>& compressed = blocks[block];
+        compressed.resize(ZSTD_compressBound(planes.size()));
+        const size_t written =
+            ZSTD_compress2(context.get(), compressed.data(), compressed.size(),
+                           planes.data(), planes.size());
+        if (ZSTD_isError(written) != 0u) {
+          throw std::runtime_error("failed to compress geometry!");
+        }
+        compressed.resize(written);
+      },
+      threadCount);
+
+  StreamHeader header{};
+  header.magic = STREAM_MAGIC;
+  header.kind = kind;
+  header.elementSize = static_cast<uint32_t>(elementSize);
+  header.blockElements = static_cast<uint32_t>(blockElements);
+  header.elementCount = count;
+  header.blockCount = blockCount;
+  std::vector<BlockEntry> table(blockCount);
+  uint64_t offset = sizeof(StreamHeader) + sizeof(BlockEntry) * blockCount;
+  for (size_t block{0}; block < blockCount; ++block) {
+    table[block] = {offset, blocks[block].size()};
+    offset += blocks[block].size();
+  }
+
+  std::vector<uint8_t> stream(offset);
+  std::memcpy(stream.data(), &header, sizeof(header));
+  std::memcpy(stream.data() + sizeof(header), table.data(),
+              sizeof(BlockEntry) * blockCount);
+  for (size_t block{0}; block < blockCount; ++block) {
+    std::memcpy(stream.data() + table[block].offset, blocks[block].data(),
+                blocks[block].size());
+  }
+  return stream;
+}
+
+// Reads only the header, the block table and the frame headers. Blocks are
+// always blockElements long, so the table, which has to fit into `size`,
+// bounds the count.
+bool checkStream(StreamKind kind, const uint8_t* data, size_t size,
+                 size_t count, size_t elementSize, size_t blockElements) {
+  StreamHeader header{};
+  if (size < sizeof(header)) {
+    return false;
+  }
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != STREAM_MAGIC || header.kind != kind ||
+      header.elementSize != elementSize || header.elementCount != count ||
+      header.blockElements != blockElements ||
+      header.blockCount != (count + blockElements - 1) / blockElements ||
+      header.blockCount > (size - sizeof(header)) / sizeof(BlockEntry)) {
+    return false;
+  }
+  for (size_t block{0}; block < header.blockCount; ++block) {
+    BlockEntry entry{};
+    std::memcpy(&entry, data + sizeof(header) + block * sizeof(BlockEntry),
+                sizeof(entry));
+    if (entry.offset > size || entry.size > size - entry.offset) {
+      return false;
+    }
+    const size_t n = std::min(blockElements, count - block * blockElements);
+    if (ZSTD_getFrameContentSize(data + entry.offset, entry.size) !=
+        n * elementSize) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool decodeStream(StreamKind kind, const uint8_t* data, size_t size,
+                  void* elements, size_t count, size_t elementSize,
+                  size_t blockElements, Unfilter unfilter,
+                  unsigned int threadCount) {
+  if (!checkStream(kind, data, size, count, elementSize, blockElements)) {
+    return false;
+  }
+  StreamHeader header{};
+  std::memcpy(&header, data, sizeof(header));
+
+  auto* bytes = static_cast<uint8_t*>(elements);
+  std::atomic<bool> valid{true};
+  parallelFor(
+      header.blockCount,
+      [&](size_t block) {
+        BlockEntry entry{};
+        std::memcpy(&entry,
+                    data + sizeof(header) + block * sizeof(BlockEntry),
+                    sizeof(entry));
+        const size_t first = block * blockElements;
+        const size_t n = std::min(blockElements, count - first);
+        std::vector<uint8_t> planes(n * elementSize);
+        const size_t decoded =
+            ZSTD_decompress(planes.data(), planes.size(), data + entry.offset,
+                            entry.size);
+        if (ZSTD_isError(decoded) != 0u || decoded != planes.size()) {
+          valid = false;
+          return;
+        }
+        unfilter(planes.data(), n, elementSize, bytes + first * elementSize);
+      },
+      threadCount);
+  return valid;
+}
+
+}  // namespace
+
+std::vector<uint8_t> encodeVertexStream(const void* vertices, size_t count,
+                                        size_t stride,
+                                        unsigned int threadCount) {
+  return encodeStream(StreamKind::Vertices, vertices, count, stride,
+                      CODEC_BLOCK_VERTICES, filterVertices, threadCount);
+}
+
+bool decodeVertexStream(const uint8_t* data, size_t size, void* vertices,
+                        size_t count, size_t stride,
+                        unsigned int threadCount) {
+  return decodeStream(StreamKind::Vertices, data, size, vertices, count,
+                      stride, CODEC_BLOCK_VERTICES, unfilterVertices,
+                      threadCount);
+}
+
+bool checkVertexStream(const uint8_t* data, size_t size, size_t count,
+                       size_t stride) {
+  return checkStream(StreamKind::Vertices, data, size, count, stride,
+                     CODEC_BLOCK_VERTICES);
+}
+
+std::vector<uint8_t> encodeIndexStream(const void* indices, size_t count,
+                                       size_t indexSize,
+                                       unsigned int threadCount) {
+  if (indexSize != sizeof(uint16_t) && indexSize != sizeof(uint32_t)) {
+    throw std::runtime_error("invalid index size!");
+  }
+  return encodeStream(StreamKind::Indices, indices, count, indexSize,
+                      CODEC_BLOCK_INDICES, filterIndices, threadCount);
+}
+
+bool decodeIndexStream(const uint8_t* data, size_t size, void* indices,
+                       size_t count, size_t indexSize,
+                       unsigned int threadCount) {
+  if (indexSize != sizeof(uint16_t) && indexSize != sizeof(uint32_t)) {
+    return false;
+  }
+  return decodeStream(StreamKind::Indices, data, size, indices, count,
+                      indexSize, CODEC_BLOCK_INDICES, unfilterIndices,
+                      threadCount);
+}
+
+bool checkIndexStream(const uint8_t* data, size_t size, size_t count,
+                      size_t indexSize) {
+  return checkStream(StreamKind::Indices, data, size, count, indexSize,
+                     CODEC_BLOCK_INDICES);
+}
@@ -0,0 +1,53 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_GEOMETRYCODEC_HPP
+#define VULKANTEST_GEOMETRYCODEC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Compression for vertex and index buffers. Each buffer is cut into blocks
+// that are filtered so that similar bytes line up, then compressed with zstd
+// on their own, so blocks encode and decode in parallel and a decoder never
+// holds more than one block of scratch per thread.
+//
+// Vertices are stored as byte planes (byte k of every vertex, then byte k + 1,
+// ...) of the bytewise difference to the previous vertex. Indices are stored
+// as byte planes of the zigzag-coded difference to the previous index, so a
+// cache-optimized triangle list is mostly small deltas in the low plane.
+// Undoing either filter is byte arithmetic without carries between lanes.
+
+constexpr size_t CODEC_BLOCK_VERTICES = 16384;
+constexpr size_t CODEC_BLOCK_INDICES = 65536;
+// Cooking happens once, so it can afford to compress harder; zstd decodes
+// equally fast at any level.
+constexpr int CODEC_LEVEL = 15;
+
+std::vector<uint8_t> encodeVertexStream(const void* vertices, size_t count,
+                                        size_t stride,
+                                        unsigned int threadCount = 0);
+// Returns false if `data` is not a vertex stream of exactly count vertices
+// of `stride` bytes, or is damaged.
+bool decodeVertexStream(const uint8_t* data, size_t size, void* vertices,
+                        size_t count, size_t stride,
+                        unsigned int threadCount = 0);
+// Whether `data` looks like such a stream, from its headers alone: cheap
+// enough to check a count before allocating for it. Decoding can still find
+// a block damaged.
+bool checkVertexStream(const uint8_t* data, size_t size, size_t count,
+                       size_t stride);
+
+// indexSize is 2 or 4.
+std::vector<uint8_t> encodeIndexStream(const void* indices, size_t count,
+                                       size_t indexSize,
+                                       unsigned int threadCount = 0);
+bool decodeIndexStream(const uint8_t* data, size_t size, void* indices,
+                       size_t count, size_t indexSize,
+                       unsigned int threadCount = 0);
+bool checkIndexStream(const uint8_t* data, size_t size, size_t count,
+                      size_t indexSize);
+
+#endif  // VULKANTEST_GEOMETRYCODEC_HPP
@@ -0,0 +1,66 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_HASH_HPP
+#define VULKANTEST_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// MurmurHash64A. Used to fingerprint asset files, so it has to stay stable
+// across platforms and releases: changing it invalidates every cooked file.
+inline uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 0) {
+  constexpr uint64_t m = 0xc6a4a7935bd1e995ULL;
+  constexpr int r = 47;
+
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  uint64_t h = seed ^ (size * m);
+
+  const size_t blocks = size / 8;
+  for (size_t i{0}; i < blocks; ++i) {
+    uint64_t k{0};
+    std::memcpy(&k, bytes + i * 8, sizeof(k));
+    k *= m;
+    k ^= k >> r;
+    k *= m;
+    h ^= k;
+    h *= m;
+  }
+
+  const uint8_t* tail = bytes + blocks * 8;
+  switch (size & 7) {
+    case 7:
+      h ^= uint64_t{tail[6]} << 48;
+      [[fallthrough]];
+    case 6:
+      h ^= uint64_t{tail[5]} << 40;
+      [[fallthrough]];
+    case 5:
+      h ^= uint64_t{tail[4]} << 32;
+      [[fallthrough]];
+    case 4:
+      h ^= uint64_t{tail[3]} << 24;
+      [[fallthrough]];
+    case 3:
+      h ^= uint64_t{tail[2]} << 16;
+      [[fallthrough]];
+    case 2:
+      h ^= uint64_t{tail[1]} << 8;
+      [[fallthrough]];
+    case 1:
+      h ^= uint64_t{tail[0]};
+      h *= m;
+      break;
+    default:
+      break;
+  }
+
+  h ^= h >> r;
+  h *= m;
+  h ^= h >> r;
+  return h;
+}
+
+#endif  // VULKANTEST_HASH_HPP
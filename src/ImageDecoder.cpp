@@ -0,0 +1,96 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "ImageDecoder.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "stb_image.hpp"
+
+namespace {
+
+// The memory decodeImage() lends to the decoder on this thread. It is handed
+// out at most once, for the first allocation of the result's size.
+struct DecodeTarget {
+  uint8_t* memory{nullptr};
+  size_t capacity{0};
+  size_t resultSize{0};
+  bool lent{false};
+};
+
+thread_local DecodeTarget target;
+
+}  // namespace
+
+bool readImageInfo(const uint8_t* data, size_t size, ImageInfo& info) {
+  int width{0};
+  int height{0};
+  int channels{0};
+  if (stbi_info_from_memory(data, static_cast<int>(size), &width, &height,
+                            &channels) == 0 ||
+      width <= 0 || height <= 0) {
+    return false;
+  }
+  info.width = static_cast<uint32_t>(width);
+  info.height = static_cast<uint32_t>(height);
+  return true;
+}
+
+bool decodeImage(const uint8_t* data, size_t size, const ImageInfo& info,
+                 uint8_t* destination, size_t capacity) {
+  const size_t resultSize = size_t{info.width} * info.height * 4;
+  if (capacity >= resultSize + IMAGE_DECODE_SLACK) {
+    target = {destination, capacity, resultSize, false};
+  }
+  int width{0};
+  int height{0};
+  int channels{0};
+  stbi_uc* pixels = stbi_load_from_memory(data, static_cast<int>(size),
+                                          &width, &height, &channels,
+                                          STBI_rgb_alpha);
+  target = {};
+  if (pixels == nullptr) {
+    return false;
+  }
+  const bool matches = static_cast<uint32_t>(width) == info.width &&
+                       static_cast<uint32_t>(height) == info.height;
+  if (pixels != destination) {
+    if (matches && capacity >= resultSize) {
+      memcpy(destination, pixels, resultSize);
+    }
+    stbi_image_free(pixels);
+  }
+  return matches && capacity >= resultSize;
+}
+
+void* stbiAllocate(size_t size) {
+  if (target.memory != nullptr && !target.lent && size >= target.resultSize &&
+      size <= target.resultSize + IMAGE_DECODE_SLACK) {
+    target.lent = true;
+    return target.memory;
+  }
+  return malloc(size);
+}
+
+// Lent memory is never resized in place; a decoder that grows it gets a
+// copy on the heap.
+void* stbiReallocate(void* pointer, size_t size) {
+  if (pointer != nullptr && pointer == target.memory) {
+    void* moved = malloc(size);
+    if (moved != nullptr) {
+      memcpy(moved, pointer, std::min(size, target.capacity));
+    }
+    return moved;
+  }
+  return realloc(pointer, size);
+}
+
+void stbiFree(void* pointer) {
+  if (pointer != nullptr && pointer == target.memory) {
+    return;
+  }
+  free(pointer);
+}
@@ -0,0 +1,39 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_IMAGEDECODER_HPP
+#define VULKANTEST_IMAGEDECODER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Extent of an encoded image, read from its header without decoding it.
+struct ImageInfo {
+  uint32_t width{0};
+  uint32_t height{0};
+};
+
+// stb_image's JPEG decoder allocates its result one byte larger than the
+// pixels, so the destination of decodeImage() needs that much room beyond
+// the image.
+constexpr size_t IMAGE_DECODE_SLACK = 1;
+
+// Returns false if the data is not an image stb_image can decode.
+bool readImageInfo(const uint8_t* data, size_t size, ImageInfo& info);
+
+// Decodes an image to RGBA8 into `destination`, which holds `capacity` bytes,
+// at least info.width * info.height * 4 + IMAGE_DECODE_SLACK. stb_image
+// allocates its result itself; the allocation that fits the result is
+// served from `destination`, so a JPEG or PNG lands there without an
+// intermediate buffer. Images the decoder assembles elsewhere are copied.
+// Returns false if decoding fails or the image is not `info`'s size.
+bool decodeImage(const uint8_t* data, size_t size, const ImageInfo& info,
+                 uint8_t* destination, size_t capacity);
+
+// The STBI_MALLOC, STBI_REALLOC and STBI_FREE of stb_image.cpp.
+void* stbiAllocate(size_t size);
+void* stbiReallocate(void* pointer, size_t size);
+void stbiFree(void* pointer);
+
+#endif  // VULKANTEST_IMAGEDECODER_HPP
@@ -0,0 +1,113 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "IndexSplitter.hpp"
+
+#include <stdexcept>
+
+namespace {
+
+constexpr uint32_t NONE = UINT32_MAX;
+
+}  // namespace
+
+void splitForUint16(std::vector<Vertex>& vertices,
+                    const std::vector<uint32_t>& indices,
+                    std::vector<uint16_t>& indices16,
+                    std::vector<MeshRange>& ranges, size_t maxVertices,
+                    const std::vector<uint32_t>& rangeStarts) {
+  if (maxVertices < 3 || maxVertices > MAX_UINT16_VERTICES) {
+    throw std::runtime_error("invalid vertex limit for 16-bit indices!");
+  }
+  if (indices.size() % 3 != 0 || indices.size() >= UINT32_MAX) {
+    throw std::runtime_error("invalid index count!");
+  }
+  for (uint32_t index : indices) {
+    if (index >= vertices.size()) {
+      throw std::runtime_error("index out of range!");
+    }
+  }
+  for (size_t i{0}; i < rangeStarts.size(); ++i) {
+    if (rangeStarts[i] % 3 != 0 || rangeStarts[i] > indices.size() ||
+        (i > 0 && rangeStarts[i] <= rangeStarts[i - 1])) {
+      throw std::runtime_error("invalid range starts!");
+    }
+  }
+  size_t nextStart{0};
+  const auto startsRange = [&](size_t index) {
+    while (nextStart < rangeStarts.size() && rangeStarts[nextStart] < index) {
+      ++nextStart;
+    }
+    return nextStart < rangeStarts.size() && rangeStarts[nextStart] == index;
+  };
+
+  indices16.clear();
+  indices16.reserve(indices.size());
+  ranges.clear();
+
+  if (vertices.size() <= maxVertices) {
+    MeshRange range{};
+    for (size_t i{0}; i < indices.size(); ++i) {
+      if (i > range.firstIndex && startsRange(i)) {
+        range.indexCount = static_cast<uint32_t>(i) - range.firstIndex;
+        ranges.push_back(range);
+        range.firstIndex = static_cast<uint32_t>(i);
+      }
+      indices16.push_back(static_cast<uint16_t>(indices[i]));
+    }
+    range.indexCount =
+        static_cast<uint32_t>(indices.size()) - range.firstIndex;
+    ranges.push_back(range);
+    return;
+  }
+
+  // `owner[v]` is the range that last copied vertex v, `local[v]` its index
+  // within that range.
+  std::vector<uint32_t> owner(vertices.size(), NONE);
+  std::vector<uint16_t> local(vertices.size(), 0);
+  std::vector<Vertex> result;
+  result.reserve(vertices.size());
+  MeshRange range{};
+  uint32_t rangeId{0};
+  size_t rangeVertices{0};
+
+  const auto closeRange = [&]() {
+    range.indexCount =
+        static_cast<uint32_t>(indices16.size()) - range.firstIndex;
+    ranges.push_back(range);
+    if (result.size() > static_cast<size_t>(INT32_MAX)) {
+      throw std::runtime_error("too many vertices for a vertex offset!");
+    }
+    range.firstIndex = static_cast<uint32_t>(indices16.size());
+    range.vertexOffset = static_cast<int32_t>(result.size());
+    ++rangeId;
+    rangeVertices = 0;
+  };
+
+  for (size_t t{0}; t < indices.size(); t += 3) {
+    const uint32_t a = indices[t];
+    const uint32_t b = indices[t + 1];
+    const uint32_t c = indices[t + 2];
+    const size_t added = (owner[a] != rangeId ? 1u : 0u) +
+                         (owner[b] != rangeId && b != a ? 1u : 0u) +
+                         (owner[c] != rangeId && c != a && c != b ? 1u : 0u);
+    if (rangeVertices + added > maxVertices ||
+        (t > range.firstIndex && startsRange(t))) {
+      closeRange();
+    }
+    for (size_t corner{0}; corner < 3; ++corner) {
+      const uint32_t vertex = indices[t + corner];
+      if (owner[vertex] != rangeId) {
+        owner[vertex] = rangeId;
+        local[vertex] = static_cast<uint16_t>(rangeVertices++);
+        result.push_back(vertices[vertex]);
+      }
+      indices16.push_back(local[vertex]);
+    }
+  }
+  if (indices16.size() > range.firstIndex) {
+    closeRange();
+  }
+  vertices.swap(result);
+}
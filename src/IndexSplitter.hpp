@@ -0,0 +1,31 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_INDEXSPLITTER_HPP
+#define VULKANTEST_INDEXSPLITTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.hpp"
+
+// Vertices one draw can address with 16-bit indices.
+constexpr size_t MAX_UINT16_VERTICES = 65536;
+
+// Converts a triangle list to 16-bit indices. A mesh that fits keeps its
+// vertices and gets a single range. A larger one is cut, in triangle order,
+// into ranges of at most `maxVertices` vertices each; every range gets its
+// own contiguous copy of the vertices it uses (shared ones are duplicated at
+// the seams) and is drawn with its vertexOffset. Ranges also start at every
+// index in `rangeStarts` (ascending, multiples of three), so that parts of the
+// index buffer drawn separately, like levels of detail, never share a range.
+void splitForUint16(std::vector<Vertex>& vertices,
+                    const std::vector<uint32_t>& indices,
+                    std::vector<uint16_t>& indices16,
+                    std::vector<MeshRange>& ranges,
+                    size_t maxVertices = MAX_UINT16_VERTICES,
+                    const std::vector<uint32_t>& rangeStarts = {});
+
+#endif  // VULKANTEST_INDEXSPLITTER_HPP
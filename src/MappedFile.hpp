@@ -0,0 +1,40 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_MAPPEDFILE_HPP
+#define VULKANTEST_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only memory mapping of a whole file. Pages are faulted in on first
+// access, so opening a large file is cheap until its contents are touched.
+class MappedFile {
+ public:
+  MappedFile() = default;
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  // Returns false if the file does not exist, is empty or cannot be mapped.
+  bool open(const std::string& path);
+  void close();
+
+  [[nodiscard]] bool isOpen() const { return data_ != nullptr; }
+  [[nodiscard]] const uint8_t* data() const { return data_; }
+  [[nodiscard]] size_t size() const { return size_; }
+
+ private:
+  const uint8_t* data_{nullptr};
+  size_t size_{0};
+#ifdef _WIN32
+  void* file_{nullptr};
+  void* mapping_{nullptr};
+#endif
+};
+
+#endif  // VULKANTEST_MAPPEDFILE_HPP
@@ -0,0 +1,78 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "MemoryUsage.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+// windows.h has to come first.
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#ifdef __APPLE__
+#include <mach/mach.h>
+#else
+#include <fstream>
+#endif
+#endif
+
+namespace {
+
+constexpr size_t MIB = size_t{1} << 20;
+
+}  // namespace
+
+#ifdef _WIN32
+
+MemoryUsage queryMemoryUsage() {
+  MemoryUsage usage{};
+  PROCESS_MEMORY_COUNTERS counters{};
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters,
+                           sizeof(counters)) != 0) {
+    usage.resident = counters.WorkingSetSize;
+    usage.peakResident = counters.PeakWorkingSetSize;
+  }
+  return usage;
+}
+
+#else
+
+MemoryUsage queryMemoryUsage() {
+  MemoryUsage usage{};
+  rusage self{};
+  if (getrusage(RUSAGE_SELF, &self) == 0) {
+#ifdef __APPLE__
+    usage.peakResident = static_cast<size_t>(self.ru_maxrss);
+#else
+    usage.peakResident = static_cast<size_t>(self.ru_maxrss) * 1024;
+#endif
+  }
+#ifdef __APPLE__
+  mach_task_basic_info_data_t info{};
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+    usage.resident = static_cast<size_t>(info.resident_size);
+  }
+#else
+  // The second field is the resident page count.
+  std::ifstream statm("/proc/self/statm");
+  size_t size{0};
+  size_t pages{0};
+  if (statm >> size >> pages) {
+    usage.resident = pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  }
+#endif
+  return usage;
+}
+
+#endif
+
+std::ostream& operator<<(std::ostream& out, const MemoryUsage& usage) {
+  return out << usage.resident / MIB << " MiB resident, "
+             << usage.peakResident / MIB << " MiB peak";
+}
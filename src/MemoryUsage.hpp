@@ -0,0 +1,23 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_MEMORYUSAGE_HPP
+#define VULKANTEST_MEMORYUSAGE_HPP
+
+#include <cstddef>
+#include <ostream>
+
+// Resident set size of the process, in bytes. Zero where the platform
+// doesn't report it.
+struct MemoryUsage {
+  size_t resident{0};
+  size_t peakResident{0};  // since the process started
+};
+
+MemoryUsage queryMemoryUsage();
+
+// "<resident> MiB resident, <peak> MiB peak"
+std::ostream& operator<<(std::ostream& out, const MemoryUsage& usage);
+
+#endif  // VULKANTEST_MEMORYUSAGE_HPP
@@ -0,0 +1,250 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_MESH_HPP
+#define VULKANTEST_MESH_HPP
+
+#include <vulkan/vulkan.h>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#define GLM_ENABLE_EXPERIMENTAL
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp>
+
+struct Vertex {
+  glm::vec3 pos;
+  glm::vec3 color;
+  glm::vec2 texCoord;
+
+  static VkVertexInputBindingDescription getBindingDescription() {
+    VkVertexInputBindingDescription bindingDescription{};
+    bindingDescription.binding = 0;
+    bindingDescription.stride = sizeof(Vertex);
+    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    return bindingDescription;
+  }
+
+  static std::array<VkVertexInputAttributeDescription, 3>
+  getAttributeDescriptions() {
+    std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
+
+    attributeDescriptions[0].binding = 0;
+    attributeDescriptions[0].location = 0;
+    attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attributeDescriptions[0].offset = offsetof(Vertex, pos);
+
+    attributeDescriptions[1].binding = 0;
+    attributeDescriptions[1].location = 1;
+    attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attributeDescriptions[1].offset = offsetof(Vertex, color);
+
+    attributeDescriptions[2].binding = 0;
+    attributeDescriptions[2].location = 2;
+    attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
+    attributeDescriptions[2].offset = offsetof(Vertex, texCoord);
+
+    return attributeDescriptions;
+  }
+
+  bool operator==(const Vertex& other) const {
+    return pos == other.pos && color == other.color &&
+           texCoord == other.texCoord;
+  }
+};
+
+// The raw bits of a vertex with -0.0 folded into +0.0, which is the form
+// vertices are hashed and welded in.
+struct PackedVertex {
+  std::array<uint32_t, 8> words;
+
+  bool operator==(const PackedVertex& other) const {
+    return words == other.words;
+  }
+};
+
+inline PackedVertex packVertex(const Vertex& vertex) {
+  static_assert(sizeof(Vertex) == sizeof(PackedVertex),
+                "Vertex must be tightly packed floats");
+  PackedVertex packed{};
+  std::memcpy(packed.words.data(), &vertex, sizeof(Vertex));
+  for (auto& word : packed.words) {
+    if ((word & 0x7fffffffu) == 0) {
+      word = 0;
+    }
+  }
+  return packed;
+}
+
+inline uint64_t hashPackedVertex(const PackedVertex& packed) {
+  std::array<uint64_t, 4> lanes{};
+  std::memcpy(lanes.data(), packed.words.data(), sizeof(lanes));
+  uint64_t h = 0x9e3779b97f4a7c15ULL;
+  for (uint64_t lane : lanes) {
+    h ^= lane;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 32;
+  }
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+namespace std {
+template <>
+struct hash<Vertex> {
+  size_t operator()(Vertex const& vertex) const {
+    return hashPackedVertex(packVertex(vertex));
+  }
+};
+}  // namespace std
+
+struct MeshBounds {
+  glm::vec3 min{0.0f};
+  glm::vec3 max{0.0f};
+};
+
+// One vkCmdDrawIndexed worth of a mesh. Indices in the range are relative to
+// vertexOffset. A range belongs to a single part, which is drawn as instance
+// `part` so that the vertex shader reads its transform.
+struct MeshRange {
+  uint32_t firstIndex{0};
+  uint32_t indexCount{0};
+  int32_t vertexOffset{0};
+  uint32_t part{0};
+};
+
+// One imported mesh as placed in the scene by its node. Parts are stored in an
+// instance-rate vertex buffer (binding 1, or SPLIT_PART_BINDING with split
+// vertex streams); the vertex shader reads the transform as four columns
+// starting at location 3 and the material at location 7.
+struct MeshPart {
+  glm::mat4 transform{1.0f};  // mesh space to scene space
+  uint32_t material{0};       // material index in the source file
+  std::array<uint32_t, 3> padding{};
+
+  static VkVertexInputBindingDescription getBindingDescription(
+      uint32_t binding = 1) {
+    VkVertexInputBindingDescription bindingDescription{};
+    bindingDescription.binding = binding;
+    bindingDescription.stride = sizeof(MeshPart);
+    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+    return bindingDescription;
+  }
+
+  static std::array<VkVertexInputAttributeDescription, 5>
+  getAttributeDescriptions(uint32_t binding = 1) {
+    std::array<VkVertexInputAttributeDescription, 5> attributeDescriptions{};
+
+    for (uint32_t column{0}; column < 4; ++column) {
+      attributeDescriptions[column].binding = binding;
+      attributeDescriptions[column].location = 3 + column;
+      attributeDescriptions[column].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+      attributeDescriptions[column].offset =
+          static_cast<uint32_t>(offsetof(MeshPart, transform) +
+                                column * sizeof(glm::vec4));
+    }
+
+    attributeDescriptions[4].binding = binding;
+    attributeDescriptions[4].location = 7;
+    attributeDescriptions[4].format = VK_FORMAT_R32_UINT;
+    attributeDescriptions[4].offset =
+        static_cast<uint32_t>(offsetof(MeshPart, material));
+
+    return attributeDescriptions;
+  }
+};
+
+// A cluster of triangles with culling data, in the std430 layout cull.comp
+// reads. The triangles are a contiguous part of one draw range of the index
+// buffer, so a visible meshlet is drawn with one indexed draw of its own. The
+// culling data is in scene space, i.e. already transformed by the part.
+struct Meshlet {
+  glm::vec4 sphere;    // center (xyz) and radius (w), model space
+  glm::vec4 coneApex;  // xyz; w unused
+  // Backface cone: the meshlet faces away from every viewer v with
+  // dot(normalize(coneApex - v), axis) >= cutoff. The axis (xyz) is zero and
+  // the cutoff (w) one when the normals spread too far to ever cull.
+  glm::vec4 coneAxis;
+  uint32_t firstIndex;
+  uint32_t indexCount;
+  int32_t vertexOffset;
+  uint32_t part;
+};
+
+static_assert(sizeof(Meshlet) == 64, "Meshlet must match cull.comp");
+
+// One level of detail: a run of the index buffer together with the draw
+// ranges and meshlets that cover exactly that run.
+struct MeshLod {
+  uint32_t firstIndex{0};
+  uint32_t indexCount{0};
+  uint32_t firstRange{0};
+  uint32_t rangeCount{0};
+  uint32_t firstMeshlet{0};
+  uint32_t meshletCount{0};
+  // Estimated distance to the full mesh, in model units.
+  float error{0.0f};
+  uint32_t padding{0};
+};
+
+// Non-owning view of renderable geometry. Points either into the vectors
+// filled by the importer or straight into a mapped mesh cache.
+struct MeshView {
+  const Vertex* vertices{nullptr};
+  uint32_t vertexCount{0};
+  const void* indices{nullptr};  // uint16_t or uint32_t, see indexSize
+  uint32_t indexCount{0};
+  uint32_t indexSize{sizeof(uint32_t)};
+  const MeshRange* ranges{nullptr};
+  uint32_t rangeCount{0};
+  const Meshlet* meshlets{nullptr};
+  uint32_t meshletCount{0};
+  const MeshLod* lods{nullptr};  // finest first
+  uint32_t lodCount{0};
+  const MeshPart* parts{nullptr};
+  uint32_t partCount{0};
+  MeshBounds bounds{};       // of the vertices, in mesh space
+  MeshBounds sceneBounds{};  // of the parts, in scene space
+
+  [[nodiscard]] VkIndexType indexType() const {
+    return indexSize == sizeof(uint16_t) ? VK_INDEX_TYPE_UINT16
+                                         : VK_INDEX_TYPE_UINT32;
+  }
+  // Index i of the buffer, widened, without the range's vertexOffset.
+  [[nodiscard]] uint32_t index(size_t i) const {
+    if (indexSize == sizeof(uint16_t)) {
+      return static_cast<const uint16_t*>(indices)[i];
+    }
+    return static_cast<const uint32_t*>(indices)[i];
+  }
+  // Level of detail `level`, clamped, or all of the mesh if it has none.
+  [[nodiscard]] MeshLod lod(uint32_t level) const {
+    if (lodCount == 0) {
+      return {0, indexCount, 0, rangeCount, 0, meshletCount, 0.0f, 0};
+    }
+    return lods[level < lodCount ? level : lodCount - 1];
+  }
+};
+
+inline MeshBounds computeBounds(const Vertex* vertices, size_t count) {
+  if (count == 0) {
+    return {};
+  }
+  MeshBounds bounds{vertices[0].pos, vertices[0].pos};
+  for (size_t i{1}; i < count; ++i) {
+    bounds.min = glm::min(bounds.min, vertices[i].pos);
+    bounds.max = glm::max(bounds.max, vertices[i].pos);
+  }
+  return bounds;
+}
+
+#endif  // VULKANTEST_MESH_HPP
@@ -0,0 +1,325 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "MeshCache.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#include "GeometryCodec.hpp"
+
+namespace {
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+void writePadding(std::ofstream& out, uint64_t from, uint64_t to) {
+  static constexpr char zeros[MESH_CACHE_ALIGNMENT]{};
+  out.write(zeros, static_cast<std::streamsize>(to - from));
+}
+
+}  // namespace
+
+bool MeshCache::open(const std::string& cachePath,
+                     const std::string& sourcePath) {
+  close();
+  if (!openStampedFile(file_, cachePath, sourcePath,
+                       offsetof(MeshCacheHeader, source))) {
+    return false;
+  }
+  data_ = file_.data();
+  size_ = file_.size();
+  header_ = reinterpret_cast<const MeshCacheHeader*>(data_);
+  if (!validateLayout() || !decodeStreams() || !validateIndices()) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+bool MeshCache::open(const uint8_t* data, size_t size) {
+  close();
+  data_ = data;
+  size_ = size;
+  header_ = reinterpret_cast<const MeshCacheHeader*>(data_);
+  if (!validateLayout() || !decodeStreams() || !validateIndices()) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+void MeshCache::close() {
+  header_ = nullptr;
+  data_ = nullptr;
+  size_ = 0;
+  releaseGeometry();
+  file_.close();
+}
+
+void MeshCache::releaseGeometry() {
+  std::vector<Vertex>().swap(vertices_);
+  std::vector<uint8_t>().swap(indices_);
+}
+
+MeshView MeshCache::view() const {
+  MeshView view{};
+  if (header_ == nullptr) {
+    return view;
+  }
+  if ((header_->flags & MESH_CACHE_COMPRESSED) != 0) {
+    view.vertices = vertices_.data();
+    view.indices = indices_.data();
+  } else {
+    view.vertices =
+        reinterpret_cast<const Vertex*>(data_ + header_->vertexOffset);
+    view.indices = data_ + header_->indexOffset;
+  }
+  view.vertexCount = header_->vertexCount;
+  view.indexCount = header_->indexCount;
+  view.indexSize = header_->indexSize;
+  view.ranges =
+      reinterpret_cast<const MeshRange*>(data_ + header_->rangeOffset);
+  view.rangeCount = header_->rangeCount;
+  view.meshlets =
+      reinterpret_cast<const Meshlet*>(data_ + header_->meshletOffset);
+  view.meshletCount = header_->meshletCount;
+  view.lods = reinterpret_cast<const MeshLod*>(data_ + header_->lodOffset);
+  view.lodCount = header_->lodCount;
+  view.parts = reinterpret_cast<const MeshPart*>(data_ + header_->partOffset);
+  view.partCount = header_->partCount;
+  view.bounds = header_->bounds;
+  view.sceneBounds = header_->sceneBounds;
+  return view;
+}
+
+bool MeshCache::validateLayout() const {
+  if (size_ < sizeof(MeshCacheHeader)) {
+    return false;
+  }
+  if (header_->magic != MESH_CACHE_MAGIC ||
+      header_->version != MESH_CACHE_VERSION ||
+      header_->vertexStride != sizeof(Vertex) ||
+      (header_->indexSize != sizeof(uint16_t) &&
+       header_->indexSize != sizeof(uint32_t))) {
+    return false;
+  }
+  const bool compressed = (header_->flags & MESH_CACHE_COMPRESSED) != 0;
+  const uint64_t vertexBytes =
+      compressed ? header_->vertexStreamSize
+                 : uint64_t{header_->vertexCount} * sizeof(Vertex);
+  const uint64_t indexBytes =
+      compressed ? header_->indexStreamSize
+                 : uint64_t{header_->indexCount} * header_->indexSize;
+  const uint64_t rangeBytes = uint64_t{header_->rangeCount} * sizeof(MeshRange);
+  const uint64_t meshletBytes =
+      uint64_t{header_->meshletCount} * sizeof(Meshlet);
+  const uint64_t lodBytes = uint64_t{header_->lodCount} * sizeof(MeshLod);
+  const uint64_t partBytes = uint64_t{header_->partCount} * sizeof(MeshPart);
+  if (header_->vertexOffset % MESH_CACHE_ALIGNMENT != 0 ||
+      header_->indexOffset % MESH_CACHE_ALIGNMENT != 0 ||
+      header_->rangeOffset % MESH_CACHE_ALIGNMENT != 0 ||
+      header_->meshletOffset % MESH_CACHE_ALIGNMENT != 0 ||
+      header_->lodOffset % MESH_CACHE_ALIGNMENT != 0 ||
+      header_->partOffset % MESH_CACHE_ALIGNMENT != 0 ||
+      header_->vertexOffset > size_ ||
+      vertexBytes > size_ - header_->vertexOffset ||
+      header_->indexOffset > size_ ||
+      indexBytes > size_ - header_->indexOffset ||
+      header_->rangeOffset > size_ ||
+      rangeBytes > size_ - header_->rangeOffset ||
+      header_->meshletOffset > size_ ||
+      meshletBytes > size_ - header_->meshletOffset ||
+      header_->lodOffset > size_ || lodBytes > size_ - header_->lodOffset ||
+      header_->partOffset > size_ ||
+      partBytes > size_ - header_->partOffset) {
+    return false;
+  }
+  const auto* ranges =
+      reinterpret_cast<const MeshRange*>(data_ + header_->rangeOffset);
+  for (uint32_t i{0}; i < header_->rangeCount; ++i) {
+    if (uint64_t{ranges[i].firstIndex} + ranges[i].indexCount >
+            header_->indexCount ||
+        ranges[i].vertexOffset < 0 ||
+        static_cast<uint32_t>(ranges[i].vertexOffset) > header_->vertexCount ||
+        (header_->partCount != 0 && ranges[i].part >= header_->partCount)) {
+      return false;
+    }
+  }
+  const auto* meshlets =
+      reinterpret_cast<const Meshlet*>(data_ + header_->meshletOffset);
+  for (uint32_t i{0}; i < header_->meshletCount; ++i) {
+    if (uint64_t{meshlets[i].firstIndex} + meshlets[i].indexCount >
+            header_->indexCount ||
+        meshlets[i].vertexOffset < 0 ||
+        static_cast<uint32_t>(meshlets[i].vertexOffset) >
+            header_->vertexCount ||
+        (header_->partCount != 0 && meshlets[i].part >= header_->partCount)) {
+      return false;
+    }
+  }
+  const auto* lods =
+      reinterpret_cast<const MeshLod*>(data_ + header_->lodOffset);
+  for (uint32_t i{0}; i < header_->lodCount; ++i) {
+    if (uint64_t{lods[i].firstIndex} + lods[i].indexCount >
+            header_->indexCount ||
+        uint64_t{lods[i].firstRange} + lods[i].rangeCount >
+            header_->rangeCount ||
+        uint64_t{lods[i].firstMeshlet} + lods[i].meshletCount >
+            header_->meshletCount) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Damaged streams are treated like any other malformed cache. The counts
+// are checked against the streams before anything is allocated for them.
+bool MeshCache::decodeStreams() {
+  if ((header_->flags & MESH_CACHE_COMPRESSED) == 0) {
+    return true;
+  }
+  if (!checkVertexStream(data_ + header_->vertexOffset,
+                         header_->vertexStreamSize, header_->vertexCount,
+                         sizeof(Vertex)) ||
+      !checkIndexStream(data_ + header_->indexOffset,
+                        header_->indexStreamSize, header_->indexCount,
+                        header_->indexSize)) {
+    return false;
+  }
+  vertices_.resize(header_->vertexCount);
+  indices_.resize(size_t{header_->indexCount} * header_->indexSize);
+  return decodeVertexStream(data_ + header_->vertexOffset,
+                            header_->vertexStreamSize, vertices_.data(),
+                            vertices_.size(), sizeof(Vertex)) &&
+         decodeIndexStream(data_ + header_->indexOffset,
+                           header_->indexStreamSize, indices_.data(),
+                           header_->indexCount, header_->indexSize);
+}
+
+// Every index a range or meshlet draws, offset by its vertexOffset, has to
+// be one of the vertices, or the GPU would read past the vertex buffer.
+// validateLayout() has already checked that the ranges are in bounds.
+bool MeshCache::validateIndices() const {
+  const MeshView mesh = view();
+  const auto inBounds = [&mesh](uint32_t firstIndex, uint32_t indexCount,
+                                int32_t vertexOffset) {
+    const auto offset = static_cast<uint64_t>(vertexOffset);
+    for (size_t i{firstIndex}; i < size_t{firstIndex} + indexCount; ++i) {
+      if (offset + mesh.index(i) >= mesh.vertexCount) {
+        return false;
+      }
+    }
+    return true;
+  };
+  for (uint32_t i{0}; i < mesh.rangeCount; ++i) {
+    const MeshRange& range = mesh.ranges[i];
+    if (!inBounds(range.firstIndex, range.indexCount, range.vertexOffset)) {
+      return false;
+    }
+  }
+  for (uint32_t i{0}; i < mesh.meshletCount; ++i) {
+    const Meshlet& meshlet = mesh.meshlets[i];
+    if (!inBounds(meshlet.firstIndex, meshlet.indexCount,
+                  meshlet.vertexOffset)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool MeshCache::write(const std::string& cachePath,
+                      const std::string& sourcePath, const MeshView& mesh,
+                      bool compress) {
+  MeshCacheHeader header{};
+  header.magic = MESH_CACHE_MAGIC;
+  header.version = MESH_CACHE_VERSION;
+  header.source = stampSource(sourcePath);
+  header.vertexStride = sizeof(Vertex);
+  header.vertexCount = mesh.vertexCount;
+  header.indexCount = mesh.indexCount;
+  header.indexSize = mesh.indexSize;
+  header.rangeCount = mesh.rangeCount;
+  header.meshletCount = mesh.meshletCount;
+  header.lodCount = mesh.lodCount;
+  header.partCount = mesh.partCount;
+  header.bounds = mesh.bounds;
+  header.sceneBounds = mesh.sceneBounds;
+
+  const char* vertexData = reinterpret_cast<const char*>(mesh.vertices);
+  const char* indexData = static_cast<const char*>(mesh.indices);
+  uint64_t vertexBytes = uint64_t{mesh.vertexCount} * sizeof(Vertex);
+  uint64_t indexBytes = uint64_t{mesh.indexCount} * mesh.indexSize;
+  std::vector<uint8_t> vertexStream;
+  std::vector<uint8_t> indexStream;
+  if (compress) {
+    vertexStream =
+        encodeVertexStream(mesh.vertices, mesh.vertexCount, sizeof(Vertex));
+    indexStream =
+        encodeIndexStream(mesh.indices, mesh.indexCount, mesh.indexSize);
+    vertexData = reinterpret_cast<const char*>(vertexStream.data());
+    indexData = reinterpret_cast<const char*>(indexStream.data());
+    vertexBytes = vertexStream.size();
+    indexBytes = indexStream.size();
+    header.flags |= MESH_CACHE_COMPRESSED;
+    header.vertexStreamSize = vertexBytes;
+    header.indexStreamSize = indexBytes;
+  }
+  const uint64_t rangeBytes = uint64_t{mesh.rangeCount} * sizeof(MeshRange);
+  const uint64_t meshletBytes = uint64_t{mesh.meshletCount} * sizeof(Meshlet);
+  const uint64_t lodBytes = uint64_t{mesh.lodCount} * sizeof(MeshLod);
+  const uint64_t partBytes = uint64_t{mesh.partCount} * sizeof(MeshPart);
+  header.vertexOffset = alignUp(sizeof(MeshCacheHeader), MESH_CACHE_ALIGNMENT);
+  header.indexOffset =
+      alignUp(header.vertexOffset + vertexBytes, MESH_CACHE_ALIGNMENT);
+  header.rangeOffset =
+      alignUp(header.indexOffset + indexBytes, MESH_CACHE_ALIGNMENT);
+  header.meshletOffset =
+      alignUp(header.rangeOffset + rangeBytes, MESH_CACHE_ALIGNMENT);
+  header.lodOffset =
+      alignUp(header.meshletOffset + meshletBytes, MESH_CACHE_ALIGNMENT);
+  header.partOffset =
+      alignUp(header.lodOffset + lodBytes, MESH_CACHE_ALIGNMENT);
+
+  // Write next to the destination and rename, so a crash or a concurrent
+  // reader never sees a half-written cache.
+  const std::string tempPath = cachePath + ".tmp";
+  {
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writePadding(out, sizeof(header), header.vertexOffset);
+    out.write(vertexData, static_cast<std::streamsize>(vertexBytes));
+    writePadding(out, header.vertexOffset + vertexBytes, header.indexOffset);
+    out.write(indexData, static_cast<std::streamsize>(indexBytes));
+    writePadding(out, header.indexOffset + indexBytes, header.rangeOffset);
+    out.write(reinterpret_cast<const char*>(mesh.ranges),
+              static_cast<std::streamsize>(rangeBytes));
+    writePadding(out, header.rangeOffset + rangeBytes, header.meshletOffset);
+    out.write(reinterpret_cast<const char*>(mesh.meshlets),
+              static_cast<std::streamsize>(meshletBytes));
+    writePadding(out, header.meshletOffset + meshletBytes, header.lodOffset);
+    out.write(reinterpret_cast<const char*>(mesh.lods),
+              static_cast<std::streamsize>(lodBytes));
+    writePadding(out, header.lodOffset + lodBytes, header.partOffset);
+    out.write(reinterpret_cast<const char*>(mesh.parts),
+              static_cast<std::streamsize>(partBytes));
+    if (!out.good()) {
+      return false;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tempPath, cachePath, ec);
+  if (ec) {
+    std::filesystem::remove(tempPath, ec);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,101 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_MESHCACHE_HPP
+#define VULKANTEST_MESHCACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "Mesh.hpp"
+#include "SourceStamp.hpp"
+
+constexpr uint32_t MESH_CACHE_MAGIC = 0x434d5456;  // "VTMC"
+// 2: index buffers are stored after optimizeMesh().
+// 3: 16-bit indices and draw ranges.
+// 4: meshlets.
+// 5: levels of detail.
+// 6: scene parts.
+// 7: optional compressed vertex and index streams.
+constexpr uint32_t MESH_CACHE_VERSION = 7;
+constexpr uint64_t MESH_CACHE_ALIGNMENT = 16;
+
+// MeshCacheHeader::flags
+constexpr uint32_t MESH_CACHE_COMPRESSED = 1u << 0;
+
+// On-disk layout of a mesh cache. The vertex, index, range, meshlet, level of
+// detail and part arrays follow at the given offsets, each aligned to
+// MESH_CACHE_ALIGNMENT; vertices, indices, meshlets and parts are in exactly
+// the layout the GPU buffers use so they can be copied straight into staging
+// memory. With MESH_CACHE_COMPRESSED the vertex and index arrays are instead
+// GeometryCodec streams of vertexStreamSize and indexStreamSize bytes, which
+// open() decodes into memory of its own.
+struct MeshCacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  SourceStamp source;
+  uint32_t vertexStride;
+  uint32_t vertexCount;
+  uint32_t indexCount;
+  uint32_t indexSize;
+  uint32_t rangeCount;
+  uint32_t meshletCount;
+  uint32_t lodCount;
+  uint32_t partCount;
+  uint32_t flags;
+  MeshBounds bounds;
+  MeshBounds sceneBounds;
+  uint64_t vertexOffset;
+  uint64_t indexOffset;
+  uint64_t rangeOffset;
+  uint64_t meshletOffset;
+  uint64_t lodOffset;
+  uint64_t partOffset;
+  uint64_t vertexStreamSize;
+  uint64_t indexStreamSize;
+};
+
+class MeshCache {
+ public:
+  // Maps cachePath and validates it against sourcePath. Returns false if the
+  // cache is missing, malformed, from another version or stale.
+  bool open(const std::string& cachePath, const std::string& sourcePath);
+  // Uses a cache that lives in memory owned by the caller, such as an asset
+  // pack entry, which has to stay valid until close(). There is no source to
+  // check it against. `data` must be MESH_CACHE_ALIGNMENT aligned.
+  bool open(const uint8_t* data, size_t size);
+  void close();
+  // Frees the decoded vertices and indices of a compressed cache once they
+  // are uploaded; view() then has no vertices or indices. An uncompressed
+  // cache keeps its streams in the mapping, where they are clean pages.
+  void releaseGeometry();
+
+  [[nodiscard]] bool isOpen() const { return header_ != nullptr; }
+  [[nodiscard]] MeshView view() const;
+
+  // Cooks the imported geometry for sourcePath into cachePath, compressing
+  // vertices and indices if `compress` is set. Returns false if the cache
+  // could not be written; the caller can carry on without it.
+  static bool write(const std::string& cachePath,
+                    const std::string& sourcePath, const MeshView& mesh,
+                    bool compress = false);
+
+ private:
+  MappedFile file_;
+  const uint8_t* data_{nullptr};
+  size_t size_{0};
+  const MeshCacheHeader* header_{nullptr};
+  // Decoded vertices and indices of a compressed cache.
+  std::vector<Vertex> vertices_;
+  std::vector<uint8_t> indices_;
+
+  bool validateLayout() const;
+  bool decodeStreams();
+  bool validateIndices() const;
+};
+
+#endif  // VULKANTEST_MESHCACHE_HPP
@@ -0,0 +1,349 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+constexpr uint32_t NONE = UINT32_MAX;
+
+// FIFO cache simulated with insertion timestamps: a vertex is cached while
+// fewer than `size` misses happened since it was inserted.
+class FifoCache {
+ public:
+  FifoCache(size_t vertexCount, unsigned int size)
+      : insertedAt_(vertexCount, 0), size_{size}, time_{size + 1} {}
+
+  // Returns true on a miss.
+  bool access(uint32_t vertex) {
+    if (time_ - insertedAt_[vertex] > size_) {
+      insertedAt_[vertex] = time_++;
+      return true;
+    }
+    return false;
+  }
+
+  void flush() { time_ += size_ + 1; }
+
+ private:
+  std::vector<size_t> insertedAt_;
+  size_t size_;
+  size_t time_;
+};
+
+void checkIndices(const std::vector<uint32_t>& indices, size_t vertexCount) {
+  if (indices.size() % 3 != 0) {
+    throw std::runtime_error("index count is not a multiple of three!");
+  }
+  for (uint32_t index : indices) {
+    if (index >= vertexCount) {
+      throw std::runtime_error("index out of range!");
+    }
+  }
+}
+
+// Triangle-vertex adjacency in compressed rows: the triangles using vertex v
+// are triangles[offsets[v]] .. triangles[offsets[v + 1] - 1].
+struct Adjacency {
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> triangles;
+};
+
+Adjacency buildAdjacency(const std::vector<uint32_t>& indices,
+                         size_t vertexCount) {
+  Adjacency adjacency;
+  adjacency.offsets.assign(vertexCount + 1, 0);
+  for (uint32_t index : indices) {
+    ++adjacency.offsets[index + 1];
+  }
+  std::partial_sum(adjacency.offsets.begin(), adjacency.offsets.end(),
+                   adjacency.offsets.begin());
+  adjacency.triangles.resize(indices.size());
+  std::vector<uint32_t> fill(adjacency.offsets.begin(),
+                             adjacency.offsets.end() - 1);
+  for (size_t i{0}; i < indices.size(); ++i) {
+    adjacency.triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+  }
+  return adjacency;
+}
+
+}  // namespace
+
+VertexCacheStats analyzeVertexCache(const std::vector<uint32_t>& indices,
+                                    size_t vertexCount,
+                                    unsigned int cacheSize) {
+  VertexCacheStats stats;
+  if (indices.empty()) {
+    return stats;
+  }
+  FifoCache cache(vertexCount, cacheSize);
+  std::vector<bool> used(vertexCount, false);
+  size_t misses{0};
+  size_t usedVertices{0};
+  for (uint32_t index : indices) {
+    misses += cache.access(index) ? 1 : 0;
+    if (!used[index]) {
+      used[index] = true;
+      ++usedVertices;
+    }
+  }
+  stats.acmr = static_cast<float>(misses) /
+               static_cast<float>(indices.size() / 3);
+  stats.atvr =
+      static_cast<float>(misses) / static_cast<float>(usedVertices);
+  return stats;
+}
+
+VertexCacheStats analyzeVertexCache(const MeshView& mesh, uint32_t lod,
+                                    unsigned int cacheSize) {
+  const MeshLod level = mesh.lod(lod);
+  std::vector<uint32_t> indices;
+  indices.reserve(level.indexCount);
+  for (uint32_t r{level.firstRange}; r < level.firstRange + level.rangeCount;
+       ++r) {
+    const MeshRange& range = mesh.ranges[r];
+    for (uint32_t i{range.firstIndex}; i < range.firstIndex + range.indexCount;
+         ++i) {
+      indices.push_back(mesh.index(i) +
+                        static_cast<uint32_t>(range.vertexOffset));
+    }
+  }
+  return analyzeVertexCache(indices, mesh.vertexCount, cacheSize);
+}
+
+void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount,
+                         std::vector<uint32_t>* clusters) {
+  checkIndices(indices, vertexCount);
+  const size_t triangleCount = indices.size() / 3;
+  if (clusters != nullptr) {
+    clusters->clear();
+  }
+  if (triangleCount == 0) {
+    return;
+  }
+
+  const Adjacency adjacency = buildAdjacency(indices, vertexCount);
+  std::vector<uint32_t> live(vertexCount);
+  for (size_t v{0}; v < vertexCount; ++v) {
+    live[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+  }
+
+  const size_t cacheSize = VERTEX_CACHE_SIZE;
+  std::vector<size_t> insertedAt(vertexCount, 0);
+  size_t time{cacheSize + 1};
+  std::vector<bool> emitted(triangleCount, false);
+  std::vector<uint32_t> deadEnd;
+  deadEnd.reserve(indices.size());
+  std::vector<uint32_t> candidates;
+  std::vector<uint32_t> result;
+  result.reserve(indices.size());
+  uint32_t cursor{0};
+
+  // Vertices that were recently touched and still have triangles left, then
+  // the remaining vertices in input order.
+  const auto skipDeadEnd = [&]() -> uint32_t {
+    while (!deadEnd.empty()) {
+      const uint32_t vertex = deadEnd.back();
+      deadEnd.pop_back();
+      if (live[vertex] > 0) {
+        return vertex;
+      }
+    }
+    while (cursor < vertexCount) {
+      if (live[cursor] > 0) {
+        return cursor;
+      }
+      ++cursor;
+    }
+    return NONE;
+  };
+
+  uint32_t fan = skipDeadEnd();
+  if (clusters != nullptr) {
+    clusters->push_back(0);
+  }
+  while (fan != NONE) {
+    // Emit every remaining triangle around the fanning vertex.
+    candidates.clear();
+    for (uint32_t a{adjacency.offsets[fan]}; a < adjacency.offsets[fan + 1];
+         ++a) {
+      const uint32_t triangle = adjacency.triangles[a];
+      if (emitted[triangle]) {
+        continue;
+      }
+      emitted[triangle] = true;
+      for (size_t corner{0}; corner < 3; ++corner) {
+        const uint32_t vertex = indices[triangle * 3 + corner];
+        result.push_back(vertex);
+        deadEnd.push_back(vertex);
+        candidates.push_back(vertex);
+        --live[vertex];
+        if (time - insertedAt[vertex] > cacheSize) {
+          insertedAt[vertex] = time++;
+        }
+      }
+    }
+
+    // Fan next around the oldest candidate that will still be cached after
+    // its remaining triangles are emitted.
+    uint32_t next{NONE};
+    size_t bestPriority{0};
+    bool found{false};
+    for (uint32_t vertex : candidates) {
+      if (live[vertex] == 0) {
+        continue;
+      }
+      const size_t age = time - insertedAt[vertex];
+      const size_t priority = age + 2 * live[vertex] <= cacheSize ? age : 0;
+      if (!found || priority > bestPriority) {
+        next = vertex;
+        bestPriority = priority;
+        found = true;
+      }
+    }
+    if (next == NONE) {
+      next = skipDeadEnd();
+      if (next != NONE && clusters != nullptr &&
+          time - insertedAt[next] > cacheSize) {
+        clusters->push_back(static_cast<uint32_t>(result.size() / 3));
+      }
+    }
+    fan = next;
+  }
+
+  indices.swap(result);
+}
+
+void optimizeOverdraw(std::vector<uint32_t>& indices,
+                      const std::vector<Vertex>& vertices,
+                      const std::vector<uint32_t>& clusters, float threshold) {
+  checkIndices(indices, vertices.size());
+  const size_t triangleCount = indices.size() / 3;
+  if (triangleCount == 0) {
+    return;
+  }
+
+  // Split each cluster wherever the ACMR of the part so far, simulated from
+  // a cold cache, is within `threshold` of the whole cluster's.
+  const std::vector<uint32_t> hard =
+      clusters.empty() ? std::vector<uint32_t>{0} : clusters;
+  std::vector<uint32_t> starts;
+  FifoCache cache(vertices.size(), VERTEX_CACHE_SIZE);
+  const auto missesOf = [&](size_t triangle) {
+    size_t misses{0};
+    for (size_t corner{0}; corner < 3; ++corner) {
+      misses += cache.access(indices[triangle * 3 + corner]) ? 1 : 0;
+    }
+    return misses;
+  };
+  for (size_t c{0}; c < hard.size(); ++c) {
+    const size_t begin = hard[c];
+    const size_t end = c + 1 < hard.size() ? hard[c + 1] : triangleCount;
+    cache.flush();
+    size_t clusterMisses{0};
+    for (size_t t{begin}; t < end; ++t) {
+      clusterMisses += missesOf(t);
+    }
+    const float clusterAcmr = static_cast<float>(clusterMisses) /
+                              static_cast<float>(end - begin);
+
+    cache.flush();
+    starts.push_back(static_cast<uint32_t>(begin));
+    size_t partBegin{begin};
+    size_t partMisses{0};
+    for (size_t t{begin}; t + 1 < end; ++t) {
+      partMisses += missesOf(t);
+      if (static_cast<float>(partMisses) <=
+          threshold * clusterAcmr * static_cast<float>(t + 1 - partBegin)) {
+        starts.push_back(static_cast<uint32_t>(t + 1));
+        partBegin = t + 1;
+        partMisses = 0;
+        cache.flush();
+      }
+    }
+  }
+
+  // Area-weighted centroid and normal of every cluster and of the mesh.
+  const size_t clusterCount = starts.size();
+  std::vector<glm::vec3> centroids(clusterCount, glm::vec3(0.0f));
+  std::vector<glm::vec3> normals(clusterCount, glm::vec3(0.0f));
+  std::vector<float> areas(clusterCount, 0.0f);
+  glm::vec3 meshCentroid(0.0f);
+  float meshArea{0.0f};
+  for (size_t c{0}; c < clusterCount; ++c) {
+    const size_t end = c + 1 < clusterCount ? starts[c + 1] : triangleCount;
+    for (size_t t{starts[c]}; t < end; ++t) {
+      const glm::vec3& p0 = vertices[indices[t * 3]].pos;
+      const glm::vec3& p1 = vertices[indices[t * 3 + 1]].pos;
+      const glm::vec3& p2 = vertices[indices[t * 3 + 2]].pos;
+      const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+      const float area = glm::length(normal);
+      centroids[c] += (p0 + p1 + p2) * (area / 3.0f);
+      normals[c] += normal;
+      areas[c] += area;
+    }
+    meshCentroid += centroids[c];
+    meshArea += areas[c];
+    if (areas[c] > 0.0f) {
+      centroids[c] /= areas[c];
+    }
+  }
+  if (meshArea > 0.0f) {
+    meshCentroid /= meshArea;
+  }
+
+  std::vector<float> keys(clusterCount, 0.0f);
+  for (size_t c{0}; c < clusterCount; ++c) {
+    const float length = glm::length(normals[c]);
+    if (length > 0.0f) {
+      keys[c] = glm::dot(centroids[c] - meshCentroid, normals[c] / length);
+    }
+  }
+  std::vector<uint32_t> order(clusterCount);
+  std::iota(order.begin(), order.end(), 0u);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](uint32_t a, uint32_t b) { return keys[a] > keys[b]; });
+
+  std::vector<uint32_t> result;
+  result.reserve(indices.size());
+  for (uint32_t c : order) {
+    const size_t end = c + 1 < clusterCount ? starts[c + 1] : triangleCount;
+    result.insert(result.end(),
+                  indices.begin() + static_cast<std::ptrdiff_t>(starts[c] * 3),
+                  indices.begin() + static_cast<std::ptrdiff_t>(end * 3));
+  }
+  indices.swap(result);
+}
+
+void optimizeVertexFetch(std::vector<Vertex>& vertices,
+                         std::vector<uint32_t>& indices) {
+  checkIndices(indices, vertices.size());
+  std::vector<uint32_t> remap(vertices.size(), NONE);
+  std::vector<Vertex> result;
+  result.reserve(vertices.size());
+  for (uint32_t& index : indices) {
+    if (remap[index] == NONE) {
+      remap[index] = static_cast<uint32_t>(result.size());
+      result.push_back(vertices[index]);
+    }
+    index = remap[index];
+  }
+  vertices.swap(result);
+}
+
+MeshOptimizationStats optimizeMesh(std::vector<Vertex>& vertices,
+                                   std::vector<uint32_t>& indices) {
+  MeshOptimizationStats stats;
+  stats.before = analyzeVertexCache(indices, vertices.size());
+  std::vector<uint32_t> clusters;
+  optimizeVertexCache(indices, vertices.size(), &clusters);
+  optimizeOverdraw(indices, vertices, clusters);
+  optimizeVertexFetch(vertices, indices);
+  stats.after = analyzeVertexCache(indices, vertices.size());
+  return stats;
+}
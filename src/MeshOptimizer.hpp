@@ -0,0 +1,68 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_MESHOPTIMIZER_HPP
+#define VULKANTEST_MESHOPTIMIZER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.hpp"
+
+// Entries in the simulated post-transform cache. 16 is a conservative
+// figure for the FIFO-like caches (or batch sizes) of current GPUs.
+constexpr unsigned int VERTEX_CACHE_SIZE = 16;
+
+struct VertexCacheStats {
+  // Vertex shader invocations per triangle (0.5 at best, 3 at worst).
+  float acmr{0.0f};
+  // Vertex shader invocations per referenced vertex (1 at best).
+  float atvr{0.0f};
+};
+
+struct MeshOptimizationStats {
+  VertexCacheStats before;
+  VertexCacheStats after;
+};
+
+// Simulates a FIFO post-transform cache of `cacheSize` entries over the
+// triangle list.
+VertexCacheStats analyzeVertexCache(const std::vector<uint32_t>& indices,
+                                    size_t vertexCount,
+                                    unsigned int cacheSize = VERTEX_CACHE_SIZE);
+
+// Same for the draw ranges of one level of detail of a mesh, in draw order,
+// e.g. after splitting or meshlet building changed the order optimizeMesh()
+// produced.
+VertexCacheStats analyzeVertexCache(const MeshView& mesh, uint32_t lod = 0,
+                                    unsigned int cacheSize = VERTEX_CACHE_SIZE);
+
+// Reorders triangles for vertex cache locality with Tipsify (Sander et al.,
+// "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw").
+// Triangles keep their winding. If `clusters` is given it receives the first
+// triangle of every run that starts at a dead end, where the cache is mostly
+// cold and the draw order can change without losing much.
+void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount,
+                         std::vector<uint32_t>* clusters = nullptr);
+
+// Splits the clusters from optimizeVertexCache() (or the whole mesh, if
+// there are none) further wherever that costs at most `threshold` times their
+// ACMR, then sorts them so that outward facing clusters are drawn first and
+// occlude the rest.
+void optimizeOverdraw(std::vector<uint32_t>& indices,
+                      const std::vector<Vertex>& vertices,
+                      const std::vector<uint32_t>& clusters,
+                      float threshold = 1.05f);
+
+// Renumbers vertices in order of first use so vertex fetch walks memory
+// linearly. Unreferenced vertices are dropped.
+void optimizeVertexFetch(std::vector<Vertex>& vertices,
+                         std::vector<uint32_t>& indices);
+
+// Runs the three passes above in order.
+MeshOptimizationStats optimizeMesh(std::vector<Vertex>& vertices,
+                                   std::vector<uint32_t>& indices);
+
+#endif  // VULKANTEST_MESHOPTIMIZER_HPP
@@ -0,0 +1,569 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "MeshSimplifier.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "MeshOptimizer.hpp"
+
+namespace {
+
+constexpr uint32_t NONE = UINT32_MAX;
+
+// Weight of the planes that keep border vertices on the border line, relative
+// to the triangle planes.
+constexpr double BORDER_WEIGHT = 10.0;
+
+// Each pass collapses edges from the cheapest 1 / PASS_FRACTION candidates.
+constexpr size_t PASS_FRACTION = 3;
+
+// Weighted sum of squared distances to a set of planes, as the upper
+// triangle of a symmetric 4x4 matrix, and the total weight.
+struct Quadric {
+  double xx{0.0}, xy{0.0}, xz{0.0}, xw{0.0};
+  double yy{0.0}, yz{0.0}, yw{0.0};
+  double zz{0.0}, zw{0.0};
+  double ww{0.0};
+  double totalWeight{0.0};
+
+  void addPlane(const glm::vec3& normal, float d, double weight = 1.0) {
+    const double x = normal.x;
+    const double y = normal.y;
+    const double z = normal.z;
+    const double w = d;
+    xx += weight * x * x, xy += weight * x * y, xz += weight * x * z;
+    xw += weight * x * w, yy += weight * y * y, yz += weight * y * z;
+    yw += weight * y * w, zz += weight * z * z, zw += weight * z * w;
+    ww += weight * w * w;
+    totalWeight += weight;
+  }
+
+  Quadric& operator+=(const Quadric& other) {
+    xx += other.xx, xy += other.xy, xz += other.xz, xw += other.xw;
+    yy += other.yy, yz += other.yz, yw += other.yw;
+    zz += other.zz, zw += other.zw;
+    ww += other.ww;
+    totalWeight += other.totalWeight;
+    return *this;
+  }
+
+  // Mean squared distance of point to the planes.
+  [[nodiscard]] double evaluate(const glm::vec3& point) const {
+    const double x = point.x;
+    const double y = point.y;
+    const double z = point.z;
+    const double error = xx * x * x + 2.0 * xy * x * y + 2.0 * xz * x * z +
+                         2.0 * xw * x + yy * y * y + 2.0 * yz * y * z +
+                         2.0 * yw * y + zz * z * z + 2.0 * zw * z + ww;
+    return totalWeight > 0.0 ? std::max(error, 0.0) / totalWeight : 0.0;
+  }
+};
+
+glm::vec3 triangleNormal(const glm::vec3& p0, const glm::vec3& p1,
+                         const glm::vec3& p2) {
+  return glm::cross(p1 - p0, p2 - p0);
+}
+
+std::vector<uint64_t> sortedEdges(const std::vector<uint32_t>& indices,
+                                  const std::vector<uint32_t>& remap) {
+  std::vector<uint64_t> edges;
+  edges.reserve(indices.size());
+  for (size_t t{0}; t < indices.size(); t += 3) {
+    for (size_t c{0}; c < 3; ++c) {
+      const uint64_t a = remap[indices[t + c]];
+      const uint64_t b = remap[indices[t + (c + 1) % 3]];
+      edges.push_back(a << 32 | b);
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+  return edges;
+}
+
+size_t countEdge(const std::vector<uint64_t>& edges, uint64_t a, uint64_t b) {
+  const auto range = std::equal_range(edges.begin(), edges.end(), a << 32 | b);
+  return static_cast<size_t>(range.second - range.first);
+}
+
+// An edge with a single triangle running along it, none the other way.
+bool isBorderEdge(const std::vector<uint64_t>& edges, uint64_t a, uint64_t b) {
+  return countEdge(edges, a, b) == 1 && countEdge(edges, b, a) == 0;
+}
+
+// Exactly one triangle runs along the edge each way.
+bool isManifoldEdge(const std::vector<uint64_t>& edges, uint64_t a,
+                    uint64_t b) {
+  return countEdge(edges, a, b) == 1 && countEdge(edges, b, a) == 1;
+}
+
+enum class VertexKind : uint8_t {
+  Manifold,
+  // The only vertex at its position, on the open border of the mesh. It may
+  // only slide along the border.
+  Border,
+  // One of two vertices that share a position along a texture seam. It may
+  // only slide along the seam, together with its twin.
+  Seam,
+  // Corners where borders or seams meet, and non-manifold geometry.
+  Locked,
+};
+
+struct Topology {
+  std::vector<uint32_t> position;  // first vertex with the same position
+  std::vector<uint32_t> twin;      // other vertex at a seam position
+  std::vector<VertexKind> kind;
+};
+
+Topology classifyVertices(const std::vector<Vertex>& vertices,
+                          const std::vector<uint32_t>& indices) {
+  const size_t vertexCount = vertices.size();
+  Topology topology;
+  topology.position.resize(vertexCount);
+  topology.twin.assign(vertexCount, NONE);
+  topology.kind.assign(vertexCount, VertexKind::Manifold);
+
+  std::unordered_map<glm::vec3, uint32_t> first;
+  first.reserve(vertexCount);
+  for (uint32_t v{0}; v < vertexCount; ++v) {
+    topology.position[v] = first.emplace(vertices[v].pos, v).first->second;
+  }
+
+  // Pair up the vertices of positions that exactly two vertices share.
+  std::vector<bool> used(vertexCount, false);
+  for (uint32_t index : indices) {
+    used[index] = true;
+  }
+  std::vector<uint32_t> wedges(vertexCount, 0);
+  std::vector<uint32_t> other(vertexCount, NONE);
+  for (uint32_t v{0}; v < vertexCount; ++v) {
+    if (used[v]) {
+      const uint32_t position = topology.position[v];
+      if (++wedges[position] == 2) {
+        other[position] = v;
+      }
+    }
+  }
+  for (uint32_t v{0}; v < vertexCount; ++v) {
+    const uint32_t position = topology.position[v];
+    if (used[v] && wedges[position] == 2) {
+      topology.twin[v] = v == position ? other[position] : position;
+    }
+  }
+
+  std::vector<uint32_t> identity(vertexCount);
+  std::iota(identity.begin(), identity.end(), 0);
+  const std::vector<uint64_t> edges = sortedEdges(indices, identity);
+  const std::vector<uint64_t> positionEdges =
+      sortedEdges(indices, topology.position);
+  std::vector<bool> onBorder(vertexCount, false);
+  std::vector<bool> onSeam(vertexCount, false);
+  std::vector<bool> locked(vertexCount, false);
+  for (size_t t{0}; t < indices.size(); t += 3) {
+    for (size_t c{0}; c < 3; ++c) {
+      const uint32_t a = indices[t + c];
+      const uint32_t b = indices[t + (c + 1) % 3];
+      const uint32_t pa = topology.position[a];
+      const uint32_t pb = topology.position[b];
+      std::vector<bool>* flags{nullptr};
+      if (isBorderEdge(positionEdges, pa, pb)) {
+        flags = &onBorder;
+      } else if (!isManifoldEdge(positionEdges, pa, pb)) {
+        flags = &locked;
+      } else if (!isManifoldEdge(edges, a, b)) {
+        flags = &onSeam;
+      } else {
+        continue;
+      }
+      (*flags)[a] = true;
+      (*flags)[b] = true;
+    }
+  }
+  for (uint32_t v{0}; v < vertexCount; ++v) {
+    const bool single = wedges[topology.position[v]] == 1;
+    const bool pair = topology.twin[v] != NONE;
+    if (locked[v] || (onBorder[v] && (onSeam[v] || !single)) ||
+        (onSeam[v] && !pair)) {
+      topology.kind[v] = VertexKind::Locked;
+    } else if (onBorder[v]) {
+      topology.kind[v] = VertexKind::Border;
+    } else if (onSeam[v]) {
+      topology.kind[v] = VertexKind::Seam;
+    }
+  }
+  return topology;
+}
+
+// Triangle lists of the current mesh around every vertex.
+struct Adjacency {
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> triangles;
+
+  void build(const std::vector<uint32_t>& indices, size_t vertexCount) {
+    offsets.assign(vertexCount + 1, 0);
+    for (uint32_t index : indices) {
+      ++offsets[index + 1];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    triangles.resize(indices.size());
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t i{0}; i < indices.size(); ++i) {
+      triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+  }
+};
+
+// Checks moving `from` onto `to` in the triangle list: no triangle may flip,
+// and the two vertices may only share the neighbours of the triangles on
+// their common edge, or the collapse would pinch the surface. On success
+// `neighbours` holds the vertices around `from` and `shared` the number of
+// triangles that disappear.
+bool canCollapse(const std::vector<Vertex>& vertices,
+                 const std::vector<uint32_t>& indices,
+                 const Adjacency& adjacency, uint32_t from, uint32_t to,
+                 std::vector<uint32_t>& neighbours, size_t& shared) {
+  shared = 0;
+  neighbours.clear();
+  for (uint32_t a{adjacency.offsets[from]}; a < adjacency.offsets[from + 1];
+       ++a) {
+    const uint32_t* corner = &indices[size_t{adjacency.triangles[a]} * 3];
+    if (corner[0] == to || corner[1] == to || corner[2] == to) {
+      ++shared;
+      continue;
+    }
+    glm::vec3 moved[3];
+    for (size_t c{0}; c < 3; ++c) {
+      moved[c] = vertices[corner[c] == from ? to : corner[c]].pos;
+      if (corner[c] != from) {
+        neighbours.push_back(corner[c]);
+      }
+    }
+    const glm::vec3 before =
+        triangleNormal(vertices[corner[0]].pos, vertices[corner[1]].pos,
+                       vertices[corner[2]].pos);
+    if (glm::dot(before, triangleNormal(moved[0], moved[1], moved[2])) <=
+        0.0f) {
+      return false;
+    }
+  }
+  std::sort(neighbours.begin(), neighbours.end());
+  neighbours.erase(std::unique(neighbours.begin(), neighbours.end()),
+                   neighbours.end());
+
+  // Every common neighbour of a manifold edge shows up in two of the
+  // triangles around `to`.
+  size_t common{0};
+  for (uint32_t a{adjacency.offsets[to]}; a < adjacency.offsets[to + 1]; ++a) {
+    const uint32_t* corner = &indices[size_t{adjacency.triangles[a]} * 3];
+    for (size_t c{0}; c < 3; ++c) {
+      if (corner[c] != to && corner[c] != from &&
+          std::binary_search(neighbours.begin(), neighbours.end(),
+                             corner[c])) {
+        ++common;
+      }
+    }
+  }
+  return shared > 0 && common <= shared * 2;
+}
+
+// The vertex at the position of `to` that `from` has an edge to.
+uint32_t findNeighbourAt(const std::vector<uint32_t>& indices,
+                         const Adjacency& adjacency, const Topology& topology,
+                         uint32_t from, uint32_t to) {
+  for (uint32_t a{adjacency.offsets[from]}; a < adjacency.offsets[from + 1];
+       ++a) {
+    const uint32_t* corner = &indices[size_t{adjacency.triangles[a]} * 3];
+    for (size_t c{0}; c < 3; ++c) {
+      if (topology.position[corner[c]] == topology.position[to]) {
+        return corner[c];
+      }
+    }
+  }
+  return NONE;
+}
+
+}  // namespace
+
+std::vector<uint32_t> simplifyMesh(const std::vector<Vertex>& vertices,
+                                   const std::vector<uint32_t>& indices,
+                                   size_t targetIndexCount, float* error) {
+  if (indices.size() % 3 != 0) {
+    throw std::runtime_error("index count is not a multiple of three!");
+  }
+  for (uint32_t index : indices) {
+    if (index >= vertices.size()) {
+      throw std::runtime_error("index out of range!");
+    }
+  }
+
+  const size_t vertexCount = vertices.size();
+  const Topology topology = classifyVertices(vertices, indices);
+
+  // Quadrics are kept per position so both sides of a seam see all planes.
+  // Border edges add a plane through the edge, perpendicular to the
+  // triangle, so that borders keep their shape.
+  std::vector<Quadric> quadrics(vertexCount);
+  const std::vector<uint64_t> inputEdges =
+      sortedEdges(indices, topology.position);
+  for (size_t t{0}; t < indices.size(); t += 3) {
+    const glm::vec3& p0 = vertices[indices[t]].pos;
+    glm::vec3 normal = triangleNormal(p0, vertices[indices[t + 1]].pos,
+                                      vertices[indices[t + 2]].pos);
+    const float length = glm::length(normal);
+    if (length == 0.0f) {
+      continue;
+    }
+    normal /= length;
+    const float d = -glm::dot(normal, p0);
+    for (size_t c{0}; c < 3; ++c) {
+      quadrics[topology.position[indices[t + c]]].addPlane(normal, d);
+    }
+    for (size_t c{0}; c < 3; ++c) {
+      const uint32_t a = topology.position[indices[t + c]];
+      const uint32_t b = topology.position[indices[t + (c + 1) % 3]];
+      if (!isBorderEdge(inputEdges, a, b)) {
+        continue;
+      }
+      const glm::vec3 edge = vertices[b].pos - vertices[a].pos;
+      const glm::vec3 side = glm::cross(edge, normal);
+      const float sideLength = glm::length(side);
+      if (sideLength == 0.0f) {
+        continue;
+      }
+      const glm::vec3 sideNormal = side / sideLength;
+      const float sideD = -glm::dot(sideNormal, vertices[a].pos);
+      quadrics[a].addPlane(sideNormal, sideD, BORDER_WEIGHT);
+      quadrics[b].addPlane(sideNormal, sideD, BORDER_WEIGHT);
+    }
+  }
+  const auto collapseCost = [&](uint32_t from, uint32_t to) {
+    Quadric merged = quadrics[topology.position[from]];
+    merged += quadrics[topology.position[to]];
+    return merged.evaluate(vertices[to].pos);
+  };
+
+  std::vector<uint32_t> result = indices;
+  std::vector<uint32_t> identity(vertexCount);
+  std::iota(identity.begin(), identity.end(), 0);
+  Adjacency adjacency;
+  std::vector<uint32_t> target(vertexCount);
+  std::vector<double> cost(vertexCount);
+  std::vector<uint32_t> order;
+  std::vector<bool> touched(vertexCount);
+  std::vector<uint32_t> remap(vertexCount);
+  std::vector<uint32_t> neighbours;
+  std::vector<uint32_t> twinNeighbours;
+  double maxError{0.0};
+
+  // Each pass collapses the cheapest edges it can without two collapses
+  // touching the same triangles, then compacts the triangle list.
+  while (result.size() > targetIndexCount) {
+    adjacency.build(result, vertexCount);
+    const std::vector<uint64_t> edges = sortedEdges(result, identity);
+    const std::vector<uint64_t> positionEdges =
+        sortedEdges(result, topology.position);
+
+    std::fill(target.begin(), target.end(), NONE);
+    for (size_t t{0}; t < result.size(); t += 3) {
+      for (size_t c{0}; c < 3; ++c) {
+        const uint32_t a = result[t + c];
+        const uint32_t b = result[t + (c + 1) % 3];
+        for (const auto& [from, to] : {std::pair{a, b}, std::pair{b, a}}) {
+          const VertexKind kind = topology.kind[from];
+          if (kind == VertexKind::Locked) {
+            continue;
+          }
+          // Border and seam vertices only slide along their own kind of
+          // edge.
+          if (kind != VertexKind::Manifold) {
+            const uint32_t pa = topology.position[a];
+            const uint32_t pb = topology.position[b];
+            const bool along =
+                kind == VertexKind::Border
+                    ? isBorderEdge(positionEdges, pa, pb)
+                    : isManifoldEdge(positionEdges, pa, pb) &&
+                          !isManifoldEdge(edges, a, b);
+            if (!along || topology.kind[to] == VertexKind::Manifold) {
+              continue;
+            }
+          }
+          const double edgeCost = collapseCost(from, to);
+          if (target[from] == NONE || edgeCost < cost[from]) {
+            target[from] = to;
+            cost[from] = edgeCost;
+          }
+        }
+      }
+    }
+    order.clear();
+    for (uint32_t v{0}; v < vertexCount; ++v) {
+      if (target[v] != NONE) {
+        order.push_back(v);
+      }
+    }
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+      return cost[a] < cost[b] || (cost[a] == cost[b] && a < b);
+    });
+
+    std::fill(touched.begin(), touched.end(), false);
+    std::iota(remap.begin(), remap.end(), 0);
+    const size_t trianglesToRemove =
+        (result.size() - targetIndexCount + 2) / 3;
+    size_t removed{0};
+    size_t collapses{0};
+    if (order.empty()) {
+      break;
+    }
+    // Only the cheaper part of the candidates is considered per pass; what is
+    // left is re-evaluated on the smaller mesh.
+    const double passLimit = cost[order[(order.size() - 1) / PASS_FRACTION]];
+    for (uint32_t from : order) {
+      const uint32_t to = target[from];
+      if (cost[from] > passLimit) {
+        break;
+      }
+      if (touched[from] || touched[to]) {
+        continue;
+      }
+      size_t shared{0};
+      if (!canCollapse(vertices, result, adjacency, from, to, neighbours,
+                       shared)) {
+        continue;
+      }
+
+      // A seam vertex takes its twin along to the twin of `to`.
+      uint32_t twinFrom{NONE};
+      uint32_t twinTo{NONE};
+      size_t twinShared{0};
+      if (topology.kind[from] == VertexKind::Seam) {
+        twinFrom = topology.twin[from];
+        twinTo = findNeighbourAt(result, adjacency, topology, twinFrom, to);
+        if (twinTo == NONE || touched[twinFrom] || touched[twinTo] ||
+            !canCollapse(vertices, result, adjacency, twinFrom, twinTo,
+                         twinNeighbours, twinShared)) {
+          continue;
+        }
+      }
+
+      const auto apply = [&](uint32_t source, uint32_t destination,
+                             const std::vector<uint32_t>& around) {
+        remap[source] = destination;
+        touched[source] = true;
+        touched[destination] = true;
+        for (uint32_t neighbour : around) {
+          touched[neighbour] = true;
+        }
+      };
+      apply(from, to, neighbours);
+      if (twinFrom != NONE) {
+        apply(twinFrom, twinTo, twinNeighbours);
+      }
+      quadrics[topology.position[to]] += quadrics[topology.position[from]];
+      maxError = std::max(maxError, cost[from]);
+      ++collapses;
+      removed += shared + twinShared;
+      if (removed >= trianglesToRemove) {
+        break;
+      }
+    }
+    if (collapses == 0) {
+      break;
+    }
+
+    size_t kept{0};
+    for (size_t t{0}; t < result.size(); t += 3) {
+      const uint32_t a = remap[result[t]];
+      const uint32_t b = remap[result[t + 1]];
+      const uint32_t c = remap[result[t + 2]];
+      if (a != b && b != c && c != a) {
+        result[kept++] = a;
+        result[kept++] = b;
+        result[kept++] = c;
+      }
+    }
+    result.resize(kept);
+  }
+
+  if (error != nullptr) {
+    *error = static_cast<float>(std::sqrt(maxError));
+  }
+  return result;
+}
+
+std::vector<LodLevel> buildLodChain(const std::vector<Vertex>& vertices,
+                                    const std::vector<uint32_t>& indices,
+                                    size_t maxLods) {
+  std::vector<LodLevel> chain;
+  chain.push_back({indices, 0.0f});
+  double fraction{1.0};
+  while (chain.size() < maxLods) {
+    fraction *= LOD_REDUCTION;
+    const auto targetTriangles = static_cast<size_t>(
+        static_cast<double>(indices.size() / 3) * fraction);
+    LodLevel level;
+    level.indices =
+        simplifyMesh(vertices, indices, targetTriangles * 3, &level.error);
+    const size_t previous = chain.back().indices.size();
+    if (level.indices.empty() ||
+        static_cast<double>(level.indices.size()) >
+            static_cast<double>(previous) * MIN_LOD_REDUCTION) {
+      break;
+    }
+    // Every level is simplified from the full mesh, so errors only grow with
+    // the level up to rounding; keep them monotonic for selectLod().
+    level.error = std::max(level.error, chain.back().error);
+    optimizeVertexCache(level.indices, vertices.size());
+    chain.push_back(std::move(level));
+  }
+  return chain;
+}
+
+void assignLodSpans(std::vector<MeshLod>& lods,
+                    const std::vector<MeshRange>& ranges,
+                    const std::vector<Meshlet>& meshlets) {
+  for (MeshLod& lod : lods) {
+    const uint32_t end = lod.firstIndex + lod.indexCount;
+    const auto firstRange = std::lower_bound(
+        ranges.begin(), ranges.end(), lod.firstIndex,
+        [](const MeshRange& range, uint32_t index) {
+          return range.firstIndex < index;
+        });
+    const auto endRange = std::lower_bound(
+        firstRange, ranges.end(), end,
+        [](const MeshRange& range, uint32_t index) {
+          return range.firstIndex < index;
+        });
+    lod.firstRange = static_cast<uint32_t>(firstRange - ranges.begin());
+    lod.rangeCount = static_cast<uint32_t>(endRange - firstRange);
+
+    const auto firstMeshlet = std::lower_bound(
+        meshlets.begin(), meshlets.end(), lod.firstIndex,
+        [](const Meshlet& meshlet, uint32_t index) {
+          return meshlet.firstIndex < index;
+        });
+    const auto endMeshlet = std::lower_bound(
+        firstMeshlet, meshlets.end(), end,
+        [](const Meshlet& meshlet, uint32_t index) {
+          return meshlet.firstIndex < index;
+        });
+    lod.firstMeshlet = static_cast<uint32_t>(firstMeshlet - meshlets.begin());
+    lod.meshletCount = static_cast<uint32_t>(endMeshlet - firstMeshlet);
+  }
+}
+
+uint32_t selectLod(const MeshLod* lods, uint32_t lodCount, float distance,
+                   float pixelsPerUnit, float pixelError) {
+  if (distance <= 0.0f) {
+    return 0;
+  }
+  for (uint32_t lod{lodCount}; lod > 1; --lod) {
+    if (lods[lod - 1].error * pixelsPerUnit / distance <= pixelError) {
+      return lod - 1;
+    }
+  }
+  return 0;
+}
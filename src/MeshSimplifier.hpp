@@ -0,0 +1,62 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_MESHSIMPLIFIER_HPP
+#define VULKANTEST_MESHSIMPLIFIER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.hpp"
+
+// Levels of detail including the full mesh.
+constexpr size_t MAX_MESH_LODS = 6;
+// Each level aims for this fraction of the triangles of the previous one.
+constexpr float LOD_REDUCTION = 0.5f;
+// A level that does not get below this fraction of the previous one (because
+// most of what is left is locked) ends the chain.
+constexpr float MIN_LOD_REDUCTION = 0.9f;
+// Screen-space error, in pixels, the selected level may have.
+constexpr float LOD_PIXEL_ERROR = 1.0f;
+
+// Reduces the triangle list to at most targetIndexCount indices, or as close
+// as it gets, by collapsing edges onto one of their end points in order of
+// quadric error (Garland and Heckbert, "Surface Simplification Using Quadric
+// Error Metrics"). The result indexes the same vertices, so every level can
+// share one vertex buffer. Vertices on the open border of the mesh or on a
+// texture seam only move along that border or seam, a seam vertex together
+// with its twin; only corners, where borders or seams meet, and non-manifold
+// vertices never move. If `error` is given it receives an upper bound of the
+// distance between the result and the input, in model units.
+std::vector<uint32_t> simplifyMesh(const std::vector<Vertex>& vertices,
+                                   const std::vector<uint32_t>& indices,
+                                   size_t targetIndexCount,
+                                   float* error = nullptr);
+
+struct LodLevel {
+  std::vector<uint32_t> indices;
+  float error{0.0f};
+};
+
+// The full mesh followed by up to maxLods - 1 simplified levels, each
+// optimized for the vertex cache.
+std::vector<LodLevel> buildLodChain(const std::vector<Vertex>& vertices,
+                                    const std::vector<uint32_t>& indices,
+                                    size_t maxLods = MAX_MESH_LODS);
+
+// Fills the range and meshlet spans of levels whose firstIndex and indexCount
+// are set, from ranges and meshlets sorted by firstIndex that do not straddle
+// level boundaries.
+void assignLodSpans(std::vector<MeshLod>& lods,
+                    const std::vector<MeshRange>& ranges,
+                    const std::vector<Meshlet>& meshlets);
+
+// The coarsest level whose error, projected at `distance` from the camera,
+// stays within pixelError. pixelsPerUnit is the size in pixels of one model
+// unit at distance one.
+uint32_t selectLod(const MeshLod* lods, uint32_t lodCount, float distance,
+                   float pixelsPerUnit, float pixelError = LOD_PIXEL_ERROR);
+
+#endif  // VULKANTEST_MESHSIMPLIFIER_HPP
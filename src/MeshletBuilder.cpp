@@ -0,0 +1,261 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "MeshletBuilder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+constexpr uint32_t NONE = UINT32_MAX;
+
+// Triangles facing away from the meshlet's average normal by more than 90
+// degrees are not added to it. Tighter limits give better cones but, on
+// low-poly models, meshlets of only a handful of triangles.
+constexpr float MESHLET_CONE_SPLIT = 0.0f;
+
+// Below this the normals spread over more than ~84 degrees from the axis and
+// the cone would hardly ever cull.
+constexpr float MIN_CONE_SPREAD = 0.1f;
+
+// Sphere and normal cone of the triangles in corners, three per triangle.
+void computeMeshletBounds(const std::vector<glm::vec3>& corners,
+                          Meshlet& meshlet) {
+  glm::vec3 min = corners.front();
+  glm::vec3 max = min;
+  for (const glm::vec3& corner : corners) {
+    min = glm::min(min, corner);
+    max = glm::max(max, corner);
+  }
+  const glm::vec3 center = (min + max) * 0.5f;
+  float radius{0.0f};
+  for (const glm::vec3& corner : corners) {
+    radius = std::max(radius, glm::length(corner - center));
+  }
+  meshlet.sphere = glm::vec4(center, radius);
+
+  std::vector<glm::vec3> normals;
+  std::vector<glm::vec3> origins;
+  glm::vec3 axis(0.0f);
+  for (size_t t{0}; t + 2 < corners.size(); t += 3) {
+    const glm::vec3 normal = glm::cross(corners[t + 1] - corners[t],
+                                        corners[t + 2] - corners[t]);
+    const float length = glm::length(normal);
+    if (length > 0.0f) {
+      normals.push_back(normal / length);
+      origins.push_back(corners[t]);
+      axis += normal / length;
+    }
+  }
+
+  meshlet.coneApex = glm::vec4(center, 0.0f);
+  meshlet.coneAxis = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+  const float axisLength = glm::length(axis);
+  if (axisLength == 0.0f) {
+    return;
+  }
+  axis /= axisLength;
+  float minDot{1.0f};
+  for (const glm::vec3& normal : normals) {
+    minDot = std::min(minDot, glm::dot(normal, axis));
+  }
+  if (minDot <= MIN_CONE_SPREAD) {
+    return;
+  }
+
+  // Move the apex back along the axis until it lies behind every triangle's
+  // plane, so the test holds for all points of the meshlet, not just the
+  // center.
+  float maxT{0.0f};
+  for (size_t t{0}; t < normals.size(); ++t) {
+    const float distance = glm::dot(center - origins[t], normals[t]);
+    maxT = std::max(maxT, distance / glm::dot(axis, normals[t]));
+  }
+  meshlet.coneApex = glm::vec4(center - axis * maxT, 0.0f);
+  meshlet.coneAxis = glm::vec4(axis, std::sqrt(1.0f - minDot * minDot));
+}
+
+// Builds the meshlets of one range and writes its triangles back in meshlet
+// order.
+void buildRangeMeshlets(const std::vector<Vertex>& vertices,
+                        std::vector<uint16_t>& indices, const MeshRange& range,
+                        uint32_t maxVertices, uint32_t maxTriangles,
+                        std::vector<Meshlet>& meshlets) {
+  const uint32_t triangleCount = range.indexCount / 3;
+  const uint16_t* rangeIndices = indices.data() + range.firstIndex;
+  const auto position = [&](uint32_t local) -> const glm::vec3& {
+    return vertices[static_cast<size_t>(range.vertexOffset) + local].pos;
+  };
+
+  uint32_t localCount{0};
+  for (uint32_t i{0}; i < triangleCount * 3; ++i) {
+    localCount = std::max(localCount, uint32_t{rangeIndices[i]} + 1);
+    if (static_cast<size_t>(range.vertexOffset) + rangeIndices[i] >=
+        vertices.size()) {
+      throw std::runtime_error("index out of range!");
+    }
+  }
+
+  // Vertices split along texture seams share a position but not an index;
+  // adjacency goes through the first vertex at each position so meshlets can
+  // grow across seams.
+  std::vector<uint32_t> positionId(localCount);
+  {
+    std::unordered_map<glm::vec3, uint32_t> first;
+    first.reserve(localCount);
+    for (uint32_t vertex{0}; vertex < localCount; ++vertex) {
+      positionId[vertex] =
+          first.emplace(position(vertex), vertex).first->second;
+    }
+  }
+
+  // Triangles around each position, in compressed rows.
+  std::vector<uint32_t> offsets(localCount + 1, 0);
+  for (uint32_t i{0}; i < triangleCount * 3; ++i) {
+    ++offsets[positionId[rangeIndices[i]] + 1u];
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<uint32_t> adjacency(offsets[localCount]);
+  {
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (uint32_t i{0}; i < triangleCount * 3; ++i) {
+      adjacency[fill[positionId[rangeIndices[i]]]++] = i / 3;
+    }
+  }
+
+  std::vector<glm::vec3> normals(triangleCount, glm::vec3(0.0f));
+  for (uint32_t t{0}; t < triangleCount; ++t) {
+    const glm::vec3& p0 = position(rangeIndices[t * 3]);
+    const glm::vec3 normal =
+        glm::cross(position(rangeIndices[t * 3 + 1]) - p0,
+                   position(rangeIndices[t * 3 + 2]) - p0);
+    const float length = glm::length(normal);
+    if (length > 0.0f) {
+      normals[t] = normal / length;
+    }
+  }
+
+  std::vector<bool> emitted(triangleCount, false);
+  std::vector<uint32_t> owner(localCount, NONE);
+  std::vector<uint16_t> result;
+  result.reserve(triangleCount * 3);
+  std::vector<uint32_t> meshletVertices;
+  std::vector<glm::vec3> corners;
+  uint32_t cursor{0};
+
+  while (result.size() < triangleCount * 3) {
+    while (emitted[cursor]) {
+      ++cursor;
+    }
+    const auto id = static_cast<uint32_t>(meshlets.size());
+    Meshlet meshlet{};
+    meshlet.firstIndex =
+        range.firstIndex + static_cast<uint32_t>(result.size());
+    meshlet.vertexOffset = range.vertexOffset;
+    meshlet.part = range.part;
+    meshletVertices.clear();
+    corners.clear();
+    glm::vec3 axis(0.0f);
+
+    const auto newVertices = [&](uint32_t triangle) {
+      const uint16_t* corner = rangeIndices + triangle * 3;
+      return (owner[corner[0]] != id ? 1u : 0u) +
+             (owner[corner[1]] != id && corner[1] != corner[0] ? 1u : 0u) +
+             (owner[corner[2]] != id && corner[2] != corner[0] &&
+                      corner[2] != corner[1]
+                  ? 1u
+                  : 0u);
+    };
+    const auto add = [&](uint32_t triangle) {
+      emitted[triangle] = true;
+      for (uint32_t c{0}; c < 3; ++c) {
+        const uint16_t vertex = rangeIndices[triangle * 3 + c];
+        if (owner[vertex] != id) {
+          owner[vertex] = id;
+          meshletVertices.push_back(vertex);
+        }
+        result.push_back(vertex);
+        corners.push_back(position(vertex));
+      }
+      axis += normals[triangle];
+    };
+
+    add(cursor);
+    for (uint32_t triangles{1}; triangles < maxTriangles; ++triangles) {
+      const float axisLength = glm::length(axis);
+      const glm::vec3 direction =
+          axisLength > 0.0f ? axis / axisLength : glm::vec3(0.0f);
+      uint32_t best{NONE};
+      uint32_t bestNew{4};
+      float bestDot{-2.0f};
+      for (uint32_t vertex : meshletVertices) {
+        const uint32_t shared = positionId[vertex];
+        for (uint32_t a{offsets[shared]}; a < offsets[shared + 1]; ++a) {
+          const uint32_t triangle = adjacency[a];
+          if (emitted[triangle]) {
+            continue;
+          }
+          const uint32_t added = newVertices(triangle);
+          if (meshletVertices.size() + added > maxVertices) {
+            continue;
+          }
+          // Degenerate triangles (and a meshlet of them) have no normal and
+          // fit anywhere.
+          const float dot = normals[triangle] == glm::vec3(0.0f) ||
+                                    axisLength == 0.0f
+                                ? 1.0f
+                                : glm::dot(normals[triangle], direction);
+          if (dot < MESHLET_CONE_SPLIT) {
+            continue;
+          }
+          if (added < bestNew || (added == bestNew && dot > bestDot)) {
+            best = triangle;
+            bestNew = added;
+            bestDot = dot;
+          }
+        }
+      }
+      if (best == NONE) {
+        break;
+      }
+      add(best);
+    }
+
+    meshlet.indexCount = range.firstIndex +
+                         static_cast<uint32_t>(result.size()) -
+                         meshlet.firstIndex;
+    computeMeshletBounds(corners, meshlet);
+    meshlets.push_back(meshlet);
+  }
+
+  std::copy(result.begin(), result.end(),
+            indices.begin() + static_cast<std::ptrdiff_t>(range.firstIndex));
+}
+
+}  // namespace
+
+std::vector<Meshlet> buildMeshlets(const std::vector<Vertex>& vertices,
+                                   std::vector<uint16_t>& indices,
+                                   const std::vector<MeshRange>& ranges,
+                                   uint32_t maxVertices,
+                                   uint32_t maxTriangles) {
+  if (maxVertices < 3 || maxTriangles < 1) {
+    throw std::runtime_error("invalid meshlet limits!");
+  }
+
+  std::vector<Meshlet> meshlets;
+  for (const MeshRange& range : ranges) {
+    if (uint64_t{range.firstIndex} + range.indexCount > indices.size() ||
+        range.indexCount % 3 != 0 || range.vertexOffset < 0) {
+      throw std::runtime_error("invalid mesh range!");
+    }
+    buildRangeMeshlets(vertices, indices, range, maxVertices, maxTriangles,
+                       meshlets);
+  }
+  return meshlets;
+}
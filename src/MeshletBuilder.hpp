@@ -0,0 +1,30 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_MESHLETBUILDER_HPP
+#define VULKANTEST_MESHLETBUILDER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.hpp"
+
+constexpr uint32_t MESHLET_MAX_VERTICES = 64;
+constexpr uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+// Groups the triangles of every draw range into meshlets of at most
+// maxVertices unique vertices and maxTriangles triangles, and reorders the
+// range's triangles so that each meshlet is contiguous. Meshlets are grown
+// greedily from the first remaining triangle in index order, preferring
+// neighbours that add the fewest vertices and staying within a cone of
+// normals so that backface culling has something to work with. Culling data
+// is computed from `vertices` as given, so pass them in scene space; each
+// meshlet keeps the part of its range.
+std::vector<Meshlet> buildMeshlets(
+    const std::vector<Vertex>& vertices, std::vector<uint16_t>& indices,
+    const std::vector<MeshRange>& ranges,
+    uint32_t maxVertices = MESHLET_MAX_VERTICES,
+    uint32_t maxTriangles = MESHLET_MAX_TRIANGLES);
+
+#endif  // VULKANTEST_MESHLETBUILDER_HPP
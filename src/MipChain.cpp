@@ -0,0 +1,321 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "MipChain.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VULKANTEST_MIPCHAIN_SSE2
+#endif
+
+#include "Parallel.hpp"
+#include "TextureCache.hpp"
+
+namespace {
+
+// Linear values are encoded through a table with this many steps. A step is
+// at most 1/20 of an 8-bit sRGB step, so the table rounds like the exact
+// encoding except right at a rounding boundary.
+constexpr size_t ENCODE_STEPS = 65535;
+constexpr float ENCODE_SCALE = static_cast<float>(ENCODE_STEPS);
+// Texels per task when converting between 8-bit and linear.
+constexpr size_t CONVERT_CHUNK = 16384;
+
+float decodeSrgb(uint8_t value) {
+  const float c = static_cast<float>(value) / 255.0f;
+  return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+uint8_t encodeSrgb(float linear) {
+  const float c = linear <= 0.0031308f
+                      ? linear * 12.92f
+                      : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+  return static_cast<uint8_t>(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+const std::array<float, 256>& srgbToLinear() {
+  static const std::array<float, 256> table = [] {
+    std::array<float, 256> values{};
+    for (size_t i{0}; i < values.size(); ++i) {
+      values[i] = decodeSrgb(static_cast<uint8_t>(i));
+    }
+    return values;
+  }();
+  return table;
+}
+
+const std::vector<uint8_t>& linearToSrgb() {
+  static const std::vector<uint8_t> table = [] {
+    std::vector<uint8_t> values(ENCODE_STEPS + 1);
+    for (size_t i{0}; i < values.size(); ++i) {
+      values[i] = encodeSrgb(static_cast<float>(i) / ENCODE_SCALE);
+    }
+    return values;
+  }();
+  return table;
+}
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+// The source texels (up to three) one destination texel covers along an
+// axis, with their share of it.
+struct Taps {
+  uint32_t first;
+  uint32_t count;
+  std::array<float, 3> weights;
+};
+
+Taps axisTaps(uint32_t extent, uint32_t index) {
+  if (extent == 1) {
+    return {0, 1, {1.0f, 0.0f, 0.0f}};
+  }
+  if (extent % 2 == 0) {
+    return {2 * index, 2, {0.5f, 0.5f, 0.0f}};
+  }
+  // Texel i of n spans source texels [i (2n + 1) / n, (i + 1) (2n + 1) / n).
+  const auto n = static_cast<float>(extent / 2);
+  const auto i = static_cast<float>(index);
+  const float span = 2.0f * n + 1.0f;
+  return {2 * index, 3, {(n - i) / span, n / span, (i + 1.0f) / span}};
+}
+
+void linearize(const uint8_t* pixels, size_t texels, float* linear,
+               unsigned int threadCount) {
+  const std::array<float, 256>& table = srgbToLinear();
+  const size_t chunks = (texels + CONVERT_CHUNK - 1) / CONVERT_CHUNK;
+  parallelFor(
+      chunks,
+      [&](size_t chunk) {
+        const size_t end = std::min(texels, (chunk + 1) * CONVERT_CHUNK);
+        for (size_t t{chunk * CONVERT_CHUNK}; t < end; ++t) {
+          for (size_t c{0}; c < 3; ++c) {
+            linear[t * 4 + c] = table[pixels[t * 4 + c]];
+          }
+          linear[t * 4 + 3] = static_cast<float>(pixels[t * 4 + 3]) / 255.0f;
+        }
+      },
+      threadCount);
+}
+
+void encodeTexels(const float* linear, size_t texels, uint8_t* pixels,
+                  [[maybe_unused]] MipKernel kernel, unsigned int threadCount) {
+  const std::vector<uint8_t>& table = linearToSrgb();
+  const size_t chunks = (texels + CONVERT_CHUNK - 1) / CONVERT_CHUNK;
+  parallelFor(
+      chunks,
+      [&](size_t chunk) {
+        size_t t{chunk * CONVERT_CHUNK};
+        const size_t end = std::min(texels, t + CONVERT_CHUNK);
+#ifdef VULKANTEST_MIPCHAIN_SSE2
+        if (kernel == MipKernel::Simd) {
+          const __m128 scale =
+              _mm_setr_ps(ENCODE_SCALE, ENCODE_SCALE, ENCODE_SCALE, 255.0f);
+          const __m128 zero = _mm_setzero_ps();
+          const __m128 one = _mm_set1_ps(1.0f);
+          const __m128 half = _mm_set1_ps(0.5f);
+          alignas(16) int32_t steps[4];
+          for (; t < end; ++t) {
+            const __m128 value = _mm_min_ps(
+                _mm_max_ps(_mm_loadu_ps(linear + t * 4), zero), one);
+            _mm_store_si128(
+                reinterpret_cast<__m128i*>(steps),
+                _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, scale), half)));
+            pixels[t * 4 + 0] = table[static_cast<size_t>(steps[0])];
+            pixels[t * 4 + 1] = table[static_cast<size_t>(steps[1])];
+            pixels[t * 4 + 2] = table[static_cast<size_t>(steps[2])];
+            pixels[t * 4 + 3] = static_cast<uint8_t>(steps[3]);
+          }
+        }
+#endif
+        for (; t < end; ++t) {
+          for (size_t c{0}; c < 3; ++c) {
+            const float value = std::clamp(linear[t * 4 + c], 0.0f, 1.0f);
+            pixels[t * 4 + c] =
+                table[static_cast<size_t>(value * ENCODE_SCALE + 0.5f)];
+          }
+          const float alpha = std::clamp(linear[t * 4 + 3], 0.0f, 1.0f);
+          pixels[t * 4 + 3] = static_cast<uint8_t>(alpha * 255.0f + 0.5f);
+        }
+      },
+      threadCount);
+}
+
+// out = sum of rows[r] * weights[r] over `length` floats.
+void blendRows(const float* const* rows, const float* weights, uint32_t count,
+               size_t length, float* out, [[maybe_unused]] MipKernel kernel) {
+  size_t i{0};
+#if defined(__AVX2__)
+  if (kernel == MipKernel::Simd) {
+    for (; i + 8 <= length; i += 8) {
+      __m256 sum = _mm256_mul_ps(_mm256_loadu_ps(rows[0] + i),
+                                 _mm256_set1_ps(weights[0]));
+      for (uint32_t r{1}; r < count; ++r) {
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(rows[r] + i),
+                                               _mm256_set1_ps(weights[r])));
+      }
+      _mm256_storeu_ps(out + i, sum);
+    }
+  }
+#endif
+#ifdef VULKANTEST_MIPCHAIN_SSE2
+  if (kernel == MipKernel::Simd) {
+    for (; i + 4 <= length; i += 4) {
+      __m128 sum =
+          _mm_mul_ps(_mm_loadu_ps(rows[0] + i), _mm_set1_ps(weights[0]));
+      for (uint32_t r{1}; r < count; ++r) {
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(rows[r] + i),
+                                         _mm_set1_ps(weights[r])));
+      }
+      _mm_storeu_ps(out + i, sum);
+    }
+  }
+#endif
+  for (; i < length; ++i) {
+    float sum = rows[0][i] * weights[0];
+    for (uint32_t r{1}; r < count; ++r) {
+      sum += rows[r][i] * weights[r];
+    }
+    out[i] = sum;
+  }
+}
+
+// Filters one row of RGBA texels horizontally; a texel is one SSE register.
+void blendColumns(const float* row, const Taps* columns, uint32_t width,
+                  float* out, [[maybe_unused]] MipKernel kernel) {
+  uint32_t x{0};
+#ifdef VULKANTEST_MIPCHAIN_SSE2
+  if (kernel == MipKernel::Simd) {
+    for (; x < width; ++x) {
+      const Taps& taps = columns[x];
+      const float* texel = row + size_t{taps.first} * 4;
+      __m128 sum =
+          _mm_mul_ps(_mm_loadu_ps(texel), _mm_set1_ps(taps.weights[0]));
+      for (uint32_t k{1}; k < taps.count; ++k) {
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(texel + k * 4),
+                                         _mm_set1_ps(taps.weights[k])));
+      }
+      _mm_storeu_ps(out + size_t{x} * 4, sum);
+    }
+  }
+#endif
+  for (; x < width; ++x) {
+    const Taps& taps = columns[x];
+    const float* texel = row + size_t{taps.first} * 4;
+    for (size_t c{0}; c < 4; ++c) {
+      float sum = texel[c] * taps.weights[0];
+      for (uint32_t k{1}; k < taps.count; ++k) {
+        sum += texel[k * 4 + c] * taps.weights[k];
+      }
+      out[size_t{x} * 4 + c] = sum;
+    }
+  }
+}
+
+// Filters the rows first, so the weighted sum over the source rows runs
+// over long contiguous runs, then the columns of the blended row.
+void downsampleLinear(const float* source, uint32_t width, uint32_t height,
+                      float* destination, MipKernel kernel,
+                      unsigned int threadCount) {
+  const uint32_t halfWidth = mipExtent(width, 1);
+  const uint32_t halfHeight = mipExtent(height, 1);
+  std::vector<Taps> columns(halfWidth);
+  for (uint32_t x{0}; x < halfWidth; ++x) {
+    columns[x] = axisTaps(width, x);
+  }
+
+  const size_t parts = std::min<size_t>(halfHeight, workerCount(threadCount));
+  parallelFor(
+      parts,
+      [&](size_t part) {
+        const auto [begin, end] = partRange(halfHeight, parts, part);
+        std::vector<float> blended(size_t{width} * 4);
+        for (size_t y{begin}; y < end; ++y) {
+          const Taps rows = axisTaps(height, static_cast<uint32_t>(y));
+          std::array<const float*, 3> sources{};
+          for (uint32_t r{0}; r < rows.count; ++r) {
+            sources[r] = source + size_t{rows.first + r} * width * 4;
+          }
+          blendRows(sources.data(), rows.weights.data(), rows.count,
+                    blended.size(), blended.data(), kernel);
+          blendColumns(blended.data(), columns.data(), halfWidth,
+                       destination + y * halfWidth * 4, kernel);
+        }
+      },
+      threadCount);
+}
+
+}  // namespace
+
+void downsampleSrgba(const uint8_t* source, uint32_t width, uint32_t height,
+                     uint8_t* destination, MipKernel kernel,
+                     unsigned int threadCount) {
+  const size_t texels = size_t{width} * height;
+  const size_t halfTexels = size_t{mipExtent(width, 1)} * mipExtent(height, 1);
+  std::vector<float> linear(texels * 4);
+  std::vector<float> half(halfTexels * 4);
+  linearize(source, texels, linear.data(), threadCount);
+  downsampleLinear(linear.data(), width, height, half.data(), kernel,
+                   threadCount);
+  encodeTexels(half.data(), halfTexels, destination, kernel, threadCount);
+}
+
+CookedTexture cookTexture(const uint8_t* pixels, uint32_t width,
+                          uint32_t height, MipKernel kernel,
+                          unsigned int threadCount) {
+  CookedTexture texture = allocateTexture(width, height);
+  std::memcpy(texture.data.data(), pixels, texture.levels[0].size);
+  cookMips(texture, kernel, threadCount);
+  return texture;
+}
+
+CookedTexture allocateTexture(uint32_t width, uint32_t height) {
+  CookedTexture texture;
+  texture.format = VK_FORMAT_R8G8B8A8_SRGB;
+  texture.width = width;
+  texture.height = height;
+  const uint32_t levelCount = mipLevelCount(width, height);
+  uint64_t size{0};
+  for (uint32_t level{0}; level < levelCount; ++level) {
+    TextureLevel entry{};
+    entry.offset = size;
+    entry.width = mipExtent(width, level);
+    entry.height = mipExtent(height, level);
+    entry.size = textureLevelSize(texture.format, entry.width, entry.height);
+    texture.levels.push_back(entry);
+    size = alignUp(entry.offset + entry.size, TEXTURE_CACHE_ALIGNMENT);
+  }
+  texture.data.resize(size);
+  return texture;
+}
+
+void cookMips(CookedTexture& texture, MipKernel kernel,
+              unsigned int threadCount) {
+  std::vector<float> linear(size_t{texture.width} * texture.height * 4);
+  std::vector<float> next;
+  linearize(texture.data.data(), size_t{texture.width} * texture.height,
+            linear.data(), threadCount);
+  for (size_t level{1}; level < texture.levels.size(); ++level) {
+    const TextureLevel& parent = texture.levels[level - 1];
+    const TextureLevel& child = texture.levels[level];
+    const size_t texels = size_t{child.width} * child.height;
+    next.resize(texels * 4);
+    downsampleLinear(linear.data(), parent.width, parent.height, next.data(),
+                     kernel, threadCount);
+    encodeTexels(next.data(), texels, texture.data.data() + child.offset,
+                 kernel, threadCount);
+    std::swap(linear, next);
+  }
+}
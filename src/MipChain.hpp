@@ -0,0 +1,45 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_MIPCHAIN_HPP
+#define VULKANTEST_MIPCHAIN_HPP
+
+#include <cstdint>
+
+#include "Texture.hpp"
+
+// Which code filters and converts the texels. Simd uses AVX2 when the build
+// targets it (ENABLE_AVX2), SSE2 on any other x86-64 build and the scalar
+// code elsewhere; Scalar is kept as the reference both are tested against.
+enum class MipKernel {
+  Scalar,
+  Simd,
+};
+
+// Halves an RGBA8 sRGB image with a box filter. Color is averaged in linear
+// space, as a linear blit of an sRGB image does, alpha as stored. An odd
+// extent of 2n + 1 texels maps to n texels that each cover 2 + 1/n source
+// texels, so the last row or column is blended in rather than dropped.
+// `destination` holds mipExtent(width, 1) x mipExtent(height, 1) pixels.
+// Rows are filtered in parallel.
+void downsampleSrgba(const uint8_t* source, uint32_t width, uint32_t height,
+                     uint8_t* destination, MipKernel kernel = MipKernel::Simd,
+                     unsigned int threadCount = 0);
+
+// The full mip chain of an RGBA8 sRGB image, ready to be uploaded or written
+// to a texture cache. The image is converted to linear floats once and every
+// level is filtered from the previous one at that precision, so rounding to
+// 8 bits does not accumulate down the chain.
+CookedTexture cookTexture(const uint8_t* pixels, uint32_t width,
+                          uint32_t height, MipKernel kernel = MipKernel::Simd,
+                          unsigned int threadCount = 0);
+
+// An RGBA8 sRGB texture with storage for its full mip chain. Level 0 starts
+// at offset 0, for the caller to fill in, e.g. by decoding straight into it;
+// cookMips() then fills in the other levels.
+CookedTexture allocateTexture(uint32_t width, uint32_t height);
+void cookMips(CookedTexture& texture, MipKernel kernel = MipKernel::Simd,
+              unsigned int threadCount = 0);
+
+#endif  // VULKANTEST_MIPCHAIN_HPP
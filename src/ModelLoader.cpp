@@ -0,0 +1,160 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "ModelLoader.hpp"
+
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <assimp/Importer.hpp>
+#include <cctype>
+#include <filesystem>
+#include <stdexcept>
+
+#include "ObjParser.hpp"
+
+namespace {
+
+bool hasExtension(const std::string& path, const std::string& extension) {
+  std::string actual = std::filesystem::path(path).extension().string();
+  std::transform(actual.begin(), actual.end(), actual.begin(), [](char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  });
+  return actual == extension;
+}
+
+constexpr unsigned int IMPORT_FLAGS = aiProcess_Triangulate | aiProcess_FlipUVs;
+
+const aiScene* checkScene(const Assimp::Importer& importer,
+                          const aiScene* scene) {
+  if (scene == nullptr || ((scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) != 0u) ||
+      scene->mRootNode == nullptr) {
+    throw std::runtime_error("Error::Assimp::" +
+                             std::string(importer.GetErrorString()));
+  }
+  if (!scene->HasMeshes()) {
+    throw std::runtime_error("Error::Assimp::" +
+                             std::string(importer.GetErrorString()));
+  }
+  return scene;
+}
+
+const aiScene* readScene(Assimp::Importer& importer, const std::string& path) {
+  return checkScene(importer, importer.ReadFile(path.data(), IMPORT_FLAGS));
+}
+
+void appendCorners(const aiMesh* mesh, std::vector<Vertex>& corners) {
+  for (unsigned int f{0}; f < mesh->mNumFaces; ++f) {
+    const aiFace& face = mesh->mFaces[f];
+    // Triangulation leaves points and lines alone; they are not drawn.
+    if (face.mNumIndices != 3) {
+      continue;
+    }
+    for (unsigned int k{0}; k < 3; ++k) {
+      const unsigned int j = face.mIndices[k];
+      auto mVertex = mesh->mVertices[j];
+      Vertex vertex{};
+      vertex.color = {1.0f, 1.0f, 1.0f};
+      vertex.pos = {mVertex.x, mVertex.y, mVertex.z};
+      if (mesh->mTextureCoords[0] == nullptr) {
+        vertex.texCoord = {0.0f, 0.0f};
+      } else {
+        vertex.texCoord = {mesh->mTextureCoords[0][j].x,
+                           mesh->mTextureCoords[0][j].y};
+      }
+      corners.push_back(vertex);
+    }
+  }
+}
+
+// Assimp matrices are row-major, glm's are column-major.
+glm::mat4 toGlm(const aiMatrix4x4& m) {
+  return glm::mat4(m.a1, m.b1, m.c1, m.d1, m.a2, m.b2, m.c2, m.d2, m.a3, m.b3,
+                   m.c3, m.d3, m.a4, m.b4, m.c4, m.d4);
+}
+
+void collectParts(const aiScene* scene, const aiNode* node,
+                  const glm::mat4& parentTransform,
+                  std::vector<ImportedPart>& parts) {
+  const glm::mat4 transform = parentTransform * toGlm(node->mTransformation);
+  for (unsigned int i{0}; i < node->mNumMeshes; ++i) {
+    const aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
+    ImportedPart part;
+    appendCorners(mesh, part.corners);
+    if (part.corners.empty()) {
+      continue;
+    }
+    part.transform = transform;
+    part.material = mesh->mMaterialIndex;
+    parts.push_back(std::move(part));
+  }
+  for (unsigned int i{0}; i < node->mNumChildren; ++i) {
+    collectParts(scene, node->mChildren[i], transform, parts);
+  }
+}
+
+std::vector<ImportedPart> collectScene(const aiScene* scene) {
+  std::vector<ImportedPart> parts;
+  collectParts(scene, scene->mRootNode, glm::mat4(1.0f), parts);
+  if (parts.empty()) {
+    throw std::runtime_error("model has no triangles!");
+  }
+  return parts;
+}
+
+}  // namespace
+
+std::vector<Vertex> importCorners(const std::string& path,
+                                  ModelImporter importer) {
+  if (importer == ModelImporter::Native && hasExtension(path, ".obj")) {
+    return parseObj(path);
+  }
+  return importCornersAssimp(path);
+}
+
+std::vector<Vertex> importCornersAssimp(const std::string& path) {
+  Assimp::Importer importer;
+  const aiScene* scene = readScene(importer, path);
+
+  std::vector<Vertex> corners;
+  for (unsigned int i{0}; i < scene->mNumMeshes; ++i) {
+    appendCorners(scene->mMeshes[i], corners);
+  }
+  return corners;
+}
+
+std::vector<ImportedPart> importScene(const std::string& path,
+                                      ModelImporter importer) {
+  if (importer == ModelImporter::Native && hasExtension(path, ".obj")) {
+    ImportedPart part;
+    part.corners = parseObj(path);
+    return {std::move(part)};
+  }
+  return importSceneAssimp(path);
+}
+
+std::vector<ImportedPart> importScene(const uint8_t* data, size_t size,
+                                      const std::string& name,
+                                      ModelImporter importer) {
+  if (importer == ModelImporter::Native && hasExtension(name, ".obj")) {
+    ImportedPart part;
+    part.corners = parseObj(reinterpret_cast<const char*>(data), size);
+    return {std::move(part)};
+  }
+  Assimp::Importer assimp;
+  // Assimp picks the format from the hint, an extension without the dot.
+  std::string hint = std::filesystem::path(name).extension().string();
+  if (!hint.empty()) {
+    hint.erase(0, 1);
+  }
+  return collectScene(checkScene(
+      assimp, assimp.ReadFileFromMemory(data, size, IMPORT_FLAGS,
+                                        hint.c_str())));
+}
+
+std::vector<ImportedPart> importSceneAssimp(const std::string& path) {
+  Assimp::Importer importer;
+  return collectScene(readScene(importer, path));
+}
@@ -0,0 +1,45 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_MODELLOADER_HPP
+#define VULKANTEST_MODELLOADER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Mesh.hpp"
+
+enum class ModelImporter {
+  Native,  // built-in parser for formats that have one (OBJ), else Assimp
+  Assimp,
+};
+
+// One mesh of a scene as placed by a node; a mesh used by several nodes is
+// imported once per node.
+struct ImportedPart {
+  std::vector<Vertex> corners;  // mesh space, not yet welded
+  glm::mat4 transform{1.0f};    // mesh space to scene space
+  uint32_t material{0};
+};
+
+// Triangle corners of every mesh in the file, in draw order, not yet welded.
+std::vector<Vertex> importCorners(const std::string& path,
+                                  ModelImporter importer);
+std::vector<Vertex> importCornersAssimp(const std::string& path);
+
+// Every mesh instance of the scene graph with its accumulated node transform
+// and material, in depth-first node order. The native OBJ parser has no
+// groups or materials and yields a single part.
+std::vector<ImportedPart> importScene(const std::string& path,
+                                      ModelImporter importer);
+// The same for a file that is already in memory, such as an asset pack
+// entry. `name` only selects the format, by its extension.
+std::vector<ImportedPart> importScene(const uint8_t* data, size_t size,
+                                      const std::string& name,
+                                      ModelImporter importer);
+std::vector<ImportedPart> importSceneAssimp(const std::string& path);
+
+#endif  // VULKANTEST_MODELLOADER_HPP
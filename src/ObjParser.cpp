@@ -0,0 +1,404 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "ObjParser.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "MappedFile.hpp"
+#include "Parallel.hpp"
+
+namespace {
+
+// Chunks smaller than this are not worth a thread of their own.
+constexpr size_t MIN_CHUNK_SIZE = 64 * 1024;
+constexpr int32_t NO_TEX_COORD = std::numeric_limits<int32_t>::min();
+constexpr uint8_t RELATIVE_POSITION = 1;
+constexpr uint8_t RELATIVE_TEX_COORD = 2;
+
+// Assimp's fast_atof_table.
+constexpr double FRACTION_SCALE[16] = {0.0,
+                                       0.1,
+                                       0.01,
+                                       0.001,
+                                       0.0001,
+                                       0.00001,
+                                       0.000001,
+                                       0.0000001,
+                                       0.00000001,
+                                       0.000000001,
+                                       0.0000000001,
+                                       0.00000000001,
+                                       0.000000000001,
+                                       0.0000000000001,
+                                       0.00000000000001,
+                                       0.000000000000001};
+constexpr unsigned int MAX_FRACTION_DIGITS = 15;
+
+// A face corner as written in the file. Negative OBJ indices count back from
+// the last vertex seen so far; since that count is only known per chunk
+// during the parallel pass, they are stored chunk-relative and flagged.
+struct RawCorner {
+  int32_t position;
+  int32_t texCoord;
+  uint8_t relative;
+};
+
+struct ObjChunk {
+  const char* begin{nullptr};
+  const char* end{nullptr};
+
+  std::vector<glm::vec3> positions;
+  std::vector<glm::vec2> texCoords;
+  std::vector<RawCorner> corners;
+  std::vector<uint32_t> faceSizes;
+  size_t triangleCount{0};
+
+  size_t positionBase{0};
+  size_t texCoordBase{0};
+  size_t outputBase{0};
+};
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+const char* skipBlanks(const char* c, const char* end) {
+  while (c < end && isBlank(*c)) {
+    ++c;
+  }
+  return c;
+}
+
+uint64_t parseDigits(const char*& c, const char* end, unsigned int* count,
+                     unsigned int maxCount) {
+  uint64_t value{0};
+  unsigned int digits{0};
+  while (c < end && isDigit(*c)) {
+    if (digits < maxCount) {
+      value = value * 10 + static_cast<uint64_t>(*c - '0');
+      ++digits;
+    }
+    ++c;
+  }
+  if (count != nullptr) {
+    *count = digits;
+  }
+  return value;
+}
+
+int32_t parseIndex(const char*& c, const char* end) {
+  const bool negative = c < end && *c == '-';
+  if (negative || (c < end && *c == '+')) {
+    ++c;
+  }
+  if (c >= end || !isDigit(*c)) {
+    throw std::runtime_error("invalid face index in OBJ file!");
+  }
+  const uint64_t value = parseDigits(c, end, nullptr, 10);
+  if (value == 0 || value > static_cast<uint64_t>(
+                                 std::numeric_limits<int32_t>::max())) {
+    throw std::runtime_error("invalid face index in OBJ file!");
+  }
+  return negative ? -static_cast<int32_t>(value) : static_cast<int32_t>(value);
+}
+
+// Reads up to `maxCount` numbers from the rest of the line.
+size_t parseFloats(const char*& c, const char* end, float* values,
+                   size_t maxCount) {
+  size_t count{0};
+  c = skipBlanks(c, end);
+  while (c < end && count < maxCount) {
+    values[count++] = parseObjFloat(c, end);
+    c = skipBlanks(c, end);
+  }
+  return count;
+}
+
+int32_t resolveIndex(int32_t index, size_t localCount, bool& relative) {
+  relative = index < 0;
+  return relative ? static_cast<int32_t>(localCount) + index : index - 1;
+}
+
+void parseFace(ObjChunk& chunk, const char* c, const char* end) {
+  uint32_t size{0};
+  c = skipBlanks(c, end);
+  while (c < end) {
+    RawCorner corner{0, NO_TEX_COORD, 0};
+    bool relative{false};
+    corner.position =
+        resolveIndex(parseIndex(c, end), chunk.positions.size(), relative);
+    if (relative) {
+      corner.relative |= RELATIVE_POSITION;
+    }
+    if (c < end && *c == '/') {
+      ++c;
+      if (c < end && *c != '/') {
+        corner.texCoord =
+            resolveIndex(parseIndex(c, end), chunk.texCoords.size(), relative);
+        if (relative) {
+          corner.relative |= RELATIVE_TEX_COORD;
+        }
+      }
+    }
+    // Normals are not used by the renderer.
+    while (c < end && !isBlank(*c)) {
+      ++c;
+    }
+    chunk.corners.push_back(corner);
+    ++size;
+    c = skipBlanks(c, end);
+  }
+
+  if (size < 3) {
+    chunk.corners.resize(chunk.corners.size() - size);
+    return;
+  }
+  chunk.faceSizes.push_back(size);
+  chunk.triangleCount += size - 2;
+}
+
+void parseLine(ObjChunk& chunk, const char* c, const char* end) {
+  c = skipBlanks(c, end);
+  if (end - c < 2) {
+    return;
+  }
+  if (c[0] == 'v' && isBlank(c[1])) {
+    c += 2;
+    float values[6]{};
+    const size_t count = parseFloats(c, end, values, 6);
+    if (count == 4) {
+      if (values[3] == 0.0f) {
+        throw std::runtime_error("invalid homogeneous vertex in OBJ file!");
+      }
+      chunk.positions.emplace_back(values[0] / values[3], values[1] / values[3],
+                                   values[2] / values[3]);
+    } else if (count >= 3) {
+      chunk.positions.emplace_back(values[0], values[1], values[2]);
+    } else {
+      throw std::runtime_error("invalid vertex in OBJ file!");
+    }
+  } else if (c[0] == 'v' && c[1] == 't' && end - c > 2 && isBlank(c[2])) {
+    c += 3;
+    float values[3]{};
+    parseFloats(c, end, values, 3);
+    for (float& value : values) {
+      if (!std::isfinite(value)) {
+        value = 0.0f;
+      }
+    }
+    chunk.texCoords.emplace_back(values[0], values[1]);
+  } else if (c[0] == 'f' && isBlank(c[1])) {
+    parseFace(chunk, c + 2, end);
+  }
+}
+
+void parseChunk(ObjChunk& chunk) {
+  const char* c = chunk.begin;
+  while (c < chunk.end) {
+    const auto* newline = static_cast<const char*>(
+        std::memchr(c, '\n', static_cast<size_t>(chunk.end - c)));
+    const char* lineEnd = newline != nullptr ? newline : chunk.end;
+    parseLine(chunk, c, lineEnd);
+    c = lineEnd + 1;
+  }
+}
+
+// Same rule as Assimp's TriangulateProcess: a quad has at most one concave
+// corner, and the fan has to start there.
+uint32_t quadFanStart(const Vertex* quad) {
+  for (uint32_t i{0}; i < 4; ++i) {
+    const glm::vec3& v = quad[i].pos;
+    const glm::vec3 left = glm::normalize(quad[(i + 3) % 4].pos - v);
+    const glm::vec3 diag = glm::normalize(quad[(i + 2) % 4].pos - v);
+    const glm::vec3 right = glm::normalize(quad[(i + 1) % 4].pos - v);
+    const float angle = std::acos(glm::dot(left, diag)) +
+                        std::acos(glm::dot(right, diag));
+    if (angle > 3.1415926538f) {
+      return i;
+    }
+  }
+  return 0;
+}
+
+void emitTriangles(const ObjChunk& chunk,
+                   const std::vector<glm::vec3>& positions,
+                   const std::vector<glm::vec2>& texCoords, Vertex* out) {
+  std::vector<Vertex> face;
+  size_t cornerIndex{0};
+  for (uint32_t faceSize : chunk.faceSizes) {
+    face.clear();
+    for (uint32_t i{0}; i < faceSize; ++i) {
+      const RawCorner& corner = chunk.corners[cornerIndex++];
+      int64_t position = corner.position;
+      if ((corner.relative & RELATIVE_POSITION) != 0) {
+        position += static_cast<int64_t>(chunk.positionBase);
+      }
+      if (position < 0 || position >= static_cast<int64_t>(positions.size())) {
+        throw std::runtime_error("face index out of range in OBJ file!");
+      }
+
+      Vertex vertex{};
+      vertex.color = {1.0f, 1.0f, 1.0f};
+      vertex.pos = positions[static_cast<size_t>(position)];
+      if (corner.texCoord != NO_TEX_COORD) {
+        int64_t texCoord = corner.texCoord;
+        if ((corner.relative & RELATIVE_TEX_COORD) != 0) {
+          texCoord += static_cast<int64_t>(chunk.texCoordBase);
+        }
+        if (texCoord < 0 ||
+            texCoord >= static_cast<int64_t>(texCoords.size())) {
+          throw std::runtime_error("face index out of range in OBJ file!");
+        }
+        const glm::vec2& uv = texCoords[static_cast<size_t>(texCoord)];
+        vertex.texCoord = {uv.x, 1.0f - uv.y};
+      }
+      face.push_back(vertex);
+    }
+
+    if (faceSize == 4) {
+      const uint32_t start = quadFanStart(face.data());
+      *out++ = face[start];
+      *out++ = face[(start + 1) % 4];
+      *out++ = face[(start + 2) % 4];
+      *out++ = face[start];
+      *out++ = face[(start + 2) % 4];
+      *out++ = face[(start + 3) % 4];
+    } else {
+      for (uint32_t i{1}; i + 1 < faceSize; ++i) {
+        *out++ = face[0];
+        *out++ = face[i];
+        *out++ = face[i + 1];
+      }
+    }
+  }
+}
+
+std::vector<ObjChunk> splitChunks(const char* data, size_t size,
+                                  unsigned int threadCount) {
+  const size_t chunkCount =
+      std::clamp<size_t>(size / MIN_CHUNK_SIZE, 1, workerCount(threadCount));
+  const size_t chunkSize = size / chunkCount;
+
+  std::vector<ObjChunk> chunks;
+  const char* end = data + size;
+  const char* begin = data;
+  for (size_t i{0}; i < chunkCount && begin < end; ++i) {
+    const char* chunkEnd = end;
+    if (i + 1 < chunkCount) {
+      chunkEnd = std::min(end, begin + chunkSize);
+      const auto* newline = static_cast<const char*>(
+          std::memchr(chunkEnd, '\n', static_cast<size_t>(end - chunkEnd)));
+      chunkEnd = newline != nullptr ? newline + 1 : end;
+    }
+    ObjChunk chunk;
+    chunk.begin = begin;
+    chunk.end = chunkEnd;
+    chunks.push_back(std::move(chunk));
+    begin = chunkEnd;
+  }
+  return chunks;
+}
+
+}  // namespace
+
+float parseObjFloat(const char*& c, const char* end) {
+  float f{0.0f};
+  const bool negative = c < end && *c == '-';
+  if (negative || (c < end && *c == '+')) {
+    ++c;
+  }
+
+  const auto isSeparator = [&](const char* p) {
+    return p < end && (*p == '.' || *p == ',');
+  };
+  const bool fractionFollows = isSeparator(c) && c + 1 < end && isDigit(c[1]);
+  if (!(c < end && isDigit(*c)) && !fractionFollows) {
+    throw std::runtime_error("invalid number in OBJ file!");
+  }
+
+  if (!isSeparator(c)) {
+    f = static_cast<float>(
+        parseDigits(c, end, nullptr, std::numeric_limits<unsigned int>::max()));
+  }
+  if (isSeparator(c) && c + 1 < end && isDigit(c[1])) {
+    ++c;
+    unsigned int digits{0};
+    auto fraction = static_cast<double>(
+        parseDigits(c, end, &digits, MAX_FRACTION_DIGITS));
+    fraction *= FRACTION_SCALE[digits];
+    f += static_cast<float>(fraction);
+  } else if (c < end && *c == '.') {
+    ++c;
+  }
+
+  if (c < end && (*c == 'e' || *c == 'E')) {
+    ++c;
+    const bool negativeExponent = c < end && *c == '-';
+    if (negativeExponent || (c < end && *c == '+')) {
+      ++c;
+    }
+    auto exponent = static_cast<float>(
+        parseDigits(c, end, nullptr, std::numeric_limits<unsigned int>::max()));
+    if (negativeExponent) {
+      exponent = -exponent;
+    }
+    f *= std::pow(10.0f, exponent);
+  }
+
+  return negative ? -f : f;
+}
+
+std::vector<Vertex> parseObj(const char* data, size_t size,
+                             unsigned int threadCount) {
+  std::vector<ObjChunk> chunks = splitChunks(data, size, threadCount);
+  parallelFor(chunks.size(), [&](size_t i) { parseChunk(chunks[i]); });
+
+  // Chunk offsets into the merged arrays, in file order.
+  size_t positionCount{0};
+  size_t texCoordCount{0};
+  size_t cornerCount{0};
+  for (auto& chunk : chunks) {
+    chunk.positionBase = positionCount;
+    chunk.texCoordBase = texCoordCount;
+    chunk.outputBase = cornerCount;
+    positionCount += chunk.positions.size();
+    texCoordCount += chunk.texCoords.size();
+    cornerCount += chunk.triangleCount * 3;
+  }
+
+  std::vector<glm::vec3> positions;
+  std::vector<glm::vec2> texCoords;
+  positions.reserve(positionCount);
+  texCoords.reserve(texCoordCount);
+  for (auto& chunk : chunks) {
+    positions.insert(positions.end(), chunk.positions.begin(),
+                     chunk.positions.end());
+    texCoords.insert(texCoords.end(), chunk.texCoords.begin(),
+                     chunk.texCoords.end());
+    chunk.positions = {};
+    chunk.texCoords = {};
+  }
+
+  std::vector<Vertex> corners(cornerCount);
+  parallelFor(chunks.size(), [&](size_t i) {
+    emitTriangles(chunks[i], positions, texCoords,
+                  corners.data() + chunks[i].outputBase);
+  });
+  return corners;
+}
+
+std::vector<Vertex> parseObj(const std::string& path,
+                             unsigned int threadCount) {
+  MappedFile file;
+  if (!file.open(path)) {
+    throw std::runtime_error("failed to open " + path + "!");
+  }
+  return parseObj(reinterpret_cast<const char*>(file.data()), file.size(),
+                  threadCount);
+}
@@ -0,0 +1,30 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_OBJPARSER_HPP
+#define VULKANTEST_OBJPARSER_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Mesh.hpp"
+
+// Parses `value` the way Assimp's fast_atof does (integer and fraction
+// accumulated separately, added in single precision), so the native parser
+// reproduces the Assimp import bit for bit. Advances `c`; throws if there is
+// no number at `c`.
+float parseObjFloat(const char*& c, const char* end);
+
+// Multi-threaded Wavefront OBJ reader. The file is split into newline-aligned
+// chunks that are parsed concurrently, then merged in file order. Returns the
+// triangle corners (unwelded) exactly as the Assimp path produces them with
+// aiProcess_Triangulate | aiProcess_FlipUVs. Only positions and the first
+// texture coordinate set are read; points and lines are skipped.
+std::vector<Vertex> parseObj(const char* data, size_t size,
+                             unsigned int threadCount = 0);
+std::vector<Vertex> parseObj(const std::string& path,
+                             unsigned int threadCount = 0);
+
+#endif  // VULKANTEST_OBJPARSER_HPP
@@ -0,0 +1,108 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "Options.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+bool splitArgument(const std::string& argument, const std::string& name,
+                   std::string& value) {
+  const std::string prefix = "--" + name + "=";
+  if (argument.rfind(prefix, 0) != 0) {
+    return false;
+  }
+  value = argument.substr(prefix.size());
+  return true;
+}
+
+[[noreturn]] void invalidValue(const std::string& argument) {
+  throw std::invalid_argument("invalid value in argument " + argument);
+}
+
+}  // namespace
+
+Options parseOptions(int argc, const char* const argv[]) {
+  Options options{};
+  for (int i{1}; i < argc; ++i) {
+    const std::string argument = argv[i];
+    std::string value;
+    if (splitArgument(argument, "importer", value)) {
+      if (value == "native") {
+        options.importer = ModelImporter::Native;
+      } else if (value == "assimp") {
+        options.importer = ModelImporter::Assimp;
+      } else {
+        invalidValue(argument);
+      }
+    } else if (splitArgument(argument, "vertex-format", value)) {
+      if (value == "full") {
+        options.vertexFormat = VertexFormat::Full;
+      } else if (value == "compact") {
+        options.vertexFormat = VertexFormat::Compact;
+      } else if (value == "split") {
+        options.vertexFormat = VertexFormat::Split;
+      } else {
+        invalidValue(argument);
+      }
+    } else if (splitArgument(argument, "meshlet-culling", value)) {
+      if (value == "on") {
+        options.meshletCulling = true;
+      } else if (value == "off") {
+        options.meshletCulling = false;
+      } else {
+        invalidValue(argument);
+      }
+    } else if (splitArgument(argument, "mesh-compression", value)) {
+      if (value == "on") {
+        options.meshCompression = true;
+      } else if (value == "off") {
+        options.meshCompression = false;
+      } else {
+        invalidValue(argument);
+      }
+    } else if (splitArgument(argument, "depth-prepass", value)) {
+      if (value == "on") {
+        options.depthPrepass = true;
+      } else if (value == "off") {
+        options.depthPrepass = false;
+      } else {
+        invalidValue(argument);
+      }
+    } else if (splitArgument(argument, "keep-geometry", value)) {
+      if (value == "on") {
+        options.keepGeometry = true;
+      } else if (value == "off") {
+        options.keepGeometry = false;
+      } else {
+        invalidValue(argument);
+      }
+    } else if (splitArgument(argument, "texture-format", value)) {
+      if (value == "rgba8") {
+        options.textureFormat = VK_FORMAT_R8G8B8A8_SRGB;
+      } else if (value == "bc1") {
+        options.textureFormat = VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+      } else if (value == "bc3") {
+        options.textureFormat = VK_FORMAT_BC3_SRGB_BLOCK;
+      } else if (value == "bc7") {
+        options.textureFormat = VK_FORMAT_BC7_SRGB_BLOCK;
+      } else {
+        invalidValue(argument);
+      }
+    } else if (splitArgument(argument, "virtual-texture", value)) {
+      if (value == "on") {
+        options.virtualTexture = true;
+      } else if (value == "off") {
+        options.virtualTexture = false;
+      } else {
+        invalidValue(argument);
+      }
+    } else {
+      throw std::invalid_argument("unknown argument " + argument);
+    }
+  }
+  return options;
+}
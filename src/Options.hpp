@@ -0,0 +1,31 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_OPTIONS_HPP
+#define VULKANTEST_OPTIONS_HPP
+
+#include <vulkan/vulkan.h>
+
+#include "CompactVertex.hpp"
+#include "ModelLoader.hpp"
+
+// Load-time switches, set from the command line so that alternative code
+// paths can be compared against each other without rebuilding.
+struct Options {
+  ModelImporter importer{ModelImporter::Native};
+  VertexFormat vertexFormat{VertexFormat::Full};
+  bool meshletCulling{false};
+  bool meshCompression{true};
+  bool depthPrepass{false};
+  bool keepGeometry{false};
+  // What textures are cooked to: VK_FORMAT_R8G8B8A8_SRGB or one of the BC
+  // formats in BlockCompression.hpp.
+  VkFormat textureFormat{VK_FORMAT_BC7_SRGB_BLOCK};
+  bool virtualTexture{false};
+};
+
+// Throws std::invalid_argument on unknown or malformed arguments.
+Options parseOptions(int argc, const char* const argv[]);
+
+#endif  // VULKANTEST_OPTIONS_HPP
@@ -0,0 +1,124 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "PageCache.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+PageCache::PageCache(std::vector<VirtualLevel> levels, uint32_t slotCount)
+    : levels_(std::move(levels)) {
+  const uint32_t pageCount = rootPage() + 1;
+  levelOfPage_.resize(pageCount);
+  for (uint32_t level{0}; level < levels_.size(); ++level) {
+    const VirtualLevel& info = levels_[level];
+    std::fill_n(levelOfPage_.begin() + info.firstPage,
+                info.pagesX * info.pagesY, level);
+  }
+  slotOfPage_.assign(pageCount, NO_PAGE_SLOT);
+  requestedIn_.assign(pageCount, std::numeric_limits<uint64_t>::max());
+  loading_.assign(pageCount, false);
+
+  pageOfSlot_.assign(slotCount, NO_PAGE_SLOT);
+  slotUsedIn_.assign(slotCount, 0);
+  // Handed out from the back, lowest slot first.
+  for (uint32_t slot{slotCount}; slot-- > 1;) {
+    freeSlots_.push_back(slot);
+  }
+  pageOfSlot_[0] = rootPage();
+  slotOfPage_[rootPage()] = 0;
+  slotUsedIn_[0] = std::numeric_limits<uint64_t>::max();
+}
+
+// Walks from each page up to the root. Pages sampled near each other share
+// most of their ancestors, so a walk stops at the first page this frame has
+// seen already.
+std::vector<uint32_t> PageCache::request(const std::vector<uint32_t>& pages,
+                                         uint64_t frame) {
+  std::vector<uint32_t> missing;
+  for (uint32_t page : pages) {
+    for (uint32_t current{page}; requestedIn_[current] != frame;
+         current = parent(current)) {
+      requestedIn_[current] = frame;
+      const uint32_t slot = slotOfPage_[current];
+      if (current == rootPage()) {
+        break;
+      }
+      if (slot != NO_PAGE_SLOT) {
+        slotUsedIn_[slot] = frame;
+      } else if (!loading_[current]) {
+        loading_[current] = true;
+        missing.push_back(current);
+      }
+    }
+  }
+  // Coarser levels come after finer ones in page order.
+  std::sort(missing.begin(), missing.end(), std::greater<>());
+  return missing;
+}
+
+uint32_t PageCache::map(uint32_t page, uint64_t frame) {
+  loading_[page] = false;
+  if (slotOfPage_[page] != NO_PAGE_SLOT) {
+    return slotOfPage_[page];
+  }
+
+  uint32_t slot{NO_PAGE_SLOT};
+  if (!freeSlots_.empty()) {
+    slot = freeSlots_.back();
+    freeSlots_.pop_back();
+  } else {
+    uint64_t oldest = frame;
+    for (uint32_t candidate{0}; candidate < slotUsedIn_.size(); ++candidate) {
+      if (slotUsedIn_[candidate] < oldest) {
+        oldest = slotUsedIn_[candidate];
+        slot = candidate;
+      }
+    }
+    if (slot == NO_PAGE_SLOT) {
+      return NO_PAGE_SLOT;
+    }
+    slotOfPage_[pageOfSlot_[slot]] = NO_PAGE_SLOT;
+  }
+
+  pageOfSlot_[slot] = page;
+  slotOfPage_[page] = slot;
+  slotUsedIn_[slot] = frame;
+  tableDirty_ = true;
+  return slot;
+}
+
+// Levels are filled coarsest first, so a missing page copies the entry of
+// its parent, which already points at the nearest resident ancestor.
+const std::vector<uint32_t>& PageCache::table() {
+  if (!tableDirty_) {
+    return table_;
+  }
+  table_.resize(slotOfPage_.size());
+  for (uint32_t level{static_cast<uint32_t>(levels_.size())}; level-- > 0;) {
+    const VirtualLevel& info = levels_[level];
+    const uint32_t end = info.firstPage + info.pagesX * info.pagesY;
+    for (uint32_t page{info.firstPage}; page < end; ++page) {
+      const uint32_t slot = slotOfPage_[page];
+      table_[page] = slot != NO_PAGE_SLOT ? slot | level << 16
+                                          : table_[parent(page)];
+    }
+  }
+  tableDirty_ = false;
+  return table_;
+}
+
+// The page of the next level that covers the top-left corner of `page`,
+// clamped to that level's pages. shader.frag.glsl finds ancestors the same
+// way.
+uint32_t PageCache::parent(uint32_t page) const {
+  const uint32_t level = levelOfPage_[page];
+  const VirtualLevel& info = levels_[level];
+  const VirtualLevel& next = levels_[level + 1];
+  const uint32_t local = page - info.firstPage;
+  const uint32_t x = std::min(local % info.pagesX / 2, next.pagesX - 1);
+  const uint32_t y = std::min(local / info.pagesX / 2, next.pagesY - 1);
+  return next.firstPage + y * next.pagesX + x;
+}
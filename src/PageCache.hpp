@@ -0,0 +1,64 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_PAGECACHE_HPP
+#define VULKANTEST_PAGECACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "VirtualTexture.hpp"
+
+constexpr uint32_t NO_PAGE_SLOT = std::numeric_limits<uint32_t>::max();
+
+// Which pages of a virtual texture sit in which slot of the physical page
+// atlas. Slots are handed out least recently used first; a page counts as
+// used in every frame that asks for it or for one of its descendants.
+class PageCache {
+ public:
+  PageCache() = default;
+  // The single page of the last level goes into slot 0 and stays there, so
+  // every lookup resolves to some resident page. At most 65536 slots.
+  PageCache(std::vector<VirtualLevel> levels, uint32_t slotCount);
+
+  // Records the pages a frame sampled. Returns the ones to load: those
+  // missing and their missing ancestors, coarsest first, leaving out pages
+  // already returned and not mapped yet.
+  std::vector<uint32_t> request(const std::vector<uint32_t>& pages,
+                                uint64_t frame);
+  // Puts a loaded page into a free or the least recently used slot and
+  // returns it. Returns NO_PAGE_SLOT if every slot was used by `frame`; the
+  // page is then dropped and comes back with a later request.
+  uint32_t map(uint32_t page, uint64_t frame);
+
+  [[nodiscard]] uint32_t slot(uint32_t page) const {
+    return slotOfPage_[page];
+  }
+  [[nodiscard]] uint32_t rootPage() const {
+    return levels_.back().firstPage;
+  }
+  [[nodiscard]] size_t pageCount() const { return slotOfPage_.size(); }
+  // The indirection table the shader reads: for every page, the slot and
+  // level of the page itself or of its nearest resident ancestor, as
+  // slot | level << 16. Rebuilt after pages were mapped.
+  const std::vector<uint32_t>& table();
+
+ private:
+  std::vector<VirtualLevel> levels_;
+  std::vector<uint32_t> levelOfPage_;
+  std::vector<uint32_t> slotOfPage_;
+  std::vector<uint64_t> requestedIn_;
+  std::vector<bool> loading_;
+  std::vector<uint32_t> pageOfSlot_;
+  std::vector<uint64_t> slotUsedIn_;
+  std::vector<uint32_t> freeSlots_;
+  std::vector<uint32_t> table_;
+  bool tableDirty_{true};
+
+  uint32_t parent(uint32_t page) const;
+};
+
+#endif  // VULKANTEST_PAGECACHE_HPP
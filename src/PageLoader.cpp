@@ -0,0 +1,67 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "PageLoader.hpp"
+
+#include <algorithm>
+#include <utility>
+
+PageLoader::PageLoader(const VirtualTextureFile& file, size_t maxLoaded)
+    : file_(file), maxLoaded_(maxLoaded), thread_([this]() { run(); }) {}
+
+PageLoader::~PageLoader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  thread_.join();
+}
+
+void PageLoader::request(const std::vector<uint32_t>& pages) {
+  if (pages.empty()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    requests_.insert(requests_.end(), pages.begin(), pages.end());
+  }
+  wake_.notify_all();
+}
+
+std::vector<LoadedPage> PageLoader::takeLoaded(size_t maxPages) {
+  std::vector<LoadedPage> pages;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t count = std::min(maxPages, loaded_.size());
+    for (size_t i{0}; i < count; ++i) {
+      pages.push_back(std::move(loaded_.front()));
+      loaded_.pop_front();
+    }
+  }
+  if (!pages.empty()) {
+    wake_.notify_all();
+  }
+  return pages;
+}
+
+// The copy runs unlocked: it is where the page faults in from disk.
+void PageLoader::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    wake_.wait(lock, [this]() {
+      return stop_ || (!requests_.empty() && loaded_.size() < maxLoaded_);
+    });
+    if (stop_) {
+      return;
+    }
+    LoadedPage loaded{requests_.front(), {}};
+    requests_.pop_front();
+    lock.unlock();
+    const uint8_t* page = file_.page(loaded.page);
+    loaded.data.assign(page, page + file_.pageBytes());
+    lock.lock();
+    loaded_.push_back(std::move(loaded));
+  }
+}
@@ -0,0 +1,51 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_PAGELOADER_HPP
+#define VULKANTEST_PAGELOADER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "VirtualTexture.hpp"
+
+struct LoadedPage {
+  uint32_t page;
+  std::vector<uint8_t> data;
+};
+
+// Reads requested pages of a virtual texture on a worker thread, so that the
+// disk reads behind the mapped file never stall a frame. The worker stays at
+// most `maxLoaded` pages ahead of takeLoaded().
+class PageLoader {
+ public:
+  PageLoader(const VirtualTextureFile& file, size_t maxLoaded);
+  ~PageLoader();
+  PageLoader(const PageLoader&) = delete;
+  PageLoader& operator=(const PageLoader&) = delete;
+
+  // Pages are read in the order they were requested.
+  void request(const std::vector<uint32_t>& pages);
+  // Never blocks. Returns up to maxPages pages, oldest first.
+  std::vector<LoadedPage> takeLoaded(size_t maxPages);
+
+ private:
+  const VirtualTextureFile& file_;
+  const size_t maxLoaded_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::deque<uint32_t> requests_;
+  std::deque<LoadedPage> loaded_;
+  bool stop_{false};
+  std::thread thread_;
+
+  void run();
+};
+
+#endif  // VULKANTEST_PAGELOADER_HPP
@@ -0,0 +1,78 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_PARALLEL_HPP
+#define VULKANTEST_PARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Number of worker threads to use when the caller asked for `requested`
+// (0 = one per hardware thread).
+inline unsigned int workerCount(unsigned int requested = 0) {
+  if (requested != 0) {
+    return requested;
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Calls function(i) for every i in [0, count), spread over up to
+// `threadCount` threads, and rethrows the first exception once all work has
+// finished. Items are handed out in contiguous ranges, so a given i always
+// runs alone on its thread and the caller can write to per-item state
+// without locking.
+template <typename Function>
+void parallelFor(size_t count, Function&& function,
+                 unsigned int threadCount = 0) {
+  const size_t workers = std::min<size_t>(count, workerCount(threadCount));
+  if (workers <= 1) {
+    for (size_t i{0}; i < count; ++i) {
+      function(i);
+    }
+    return;
+  }
+
+  const auto runRange = [&](size_t worker) {
+    const size_t begin = count * worker / workers;
+    const size_t end = count * (worker + 1) / workers;
+    for (size_t i{begin}; i < end; ++i) {
+      function(i);
+    }
+  };
+  std::vector<std::future<void>> futures;
+  futures.reserve(workers - 1);
+  for (size_t worker{1}; worker < workers; ++worker) {
+    futures.push_back(std::async(std::launch::async, runRange, worker));
+  }
+  std::exception_ptr error;
+  try {
+    runRange(0);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  for (auto& future : futures) {
+    try {
+      future.get();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+// Splits [0, size) into `parts` contiguous ranges of near-equal length.
+inline std::pair<size_t, size_t> partRange(size_t size, size_t parts,
+                                           size_t part) {
+  return {size * part / parts, size * (part + 1) / parts};
+}
+
+#endif  // VULKANTEST_PARALLEL_HPP
@@ -0,0 +1,36 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "ReleaseQueue.hpp"
+
+#include <iterator>
+#include <utility>
+
+void ReleaseQueue::retire(uint64_t frame, std::function<void()> release) {
+  pending_.push_back({frame, std::move(release)});
+}
+
+void ReleaseQueue::collect(uint64_t completedFrames) {
+  // Frames never decrease, so the ready ones are a prefix.
+  size_t ready{0};
+  while (ready < pending_.size() && pending_[ready].frame <= completedFrames) {
+    ++ready;
+  }
+  // Moved out first: a release may retire something else.
+  const auto end = pending_.begin() + static_cast<ptrdiff_t>(ready);
+  std::vector<Pending> released(std::make_move_iterator(pending_.begin()),
+                                std::make_move_iterator(end));
+  pending_.erase(pending_.begin(), end);
+  for (Pending& pending : released) {
+    pending.release();
+  }
+}
+
+void ReleaseQueue::releaseAll() {
+  std::vector<Pending> released = std::move(pending_);
+  pending_.clear();
+  for (Pending& pending : released) {
+    pending.release();
+  }
+}
@@ -0,0 +1,36 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_RELEASEQUEUE_HPP
+#define VULKANTEST_RELEASEQUEUE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Defers destroying objects that frames still in flight may use. Frames are
+// counted in submission order; an object retired while `frame` frames had
+// been submitted is released once that many have completed. Frames passed to
+// retire() must not decrease.
+class ReleaseQueue {
+ public:
+  void retire(uint64_t frame, std::function<void()> release);
+  // Releases everything retired at or before completedFrames, oldest first.
+  void collect(uint64_t completedFrames);
+  // For when the device is idle.
+  void releaseAll();
+
+  [[nodiscard]] size_t size() const { return pending_.size(); }
+
+ private:
+  struct Pending {
+    uint64_t frame;
+    std::function<void()> release;
+  };
+
+  std::vector<Pending> pending_;
+};
+
+#endif  // VULKANTEST_RELEASEQUEUE_HPP
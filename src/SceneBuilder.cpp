@@ -0,0 +1,195 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "SceneBuilder.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include "IndexSplitter.hpp"
+#include "MeshletBuilder.hpp"
+#include "Parallel.hpp"
+#include "VertexWelder.hpp"
+
+namespace {
+
+struct PartGeometry {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  MeshOptimizationStats stats;
+};
+
+// Copies of the vertices moved into scene space by their part, for
+// everything that measures distances: simplification error and meshlet
+// culling data.
+std::vector<Vertex> toSceneSpace(const std::vector<Vertex>& vertices,
+                                 const std::vector<uint32_t>& vertexParts,
+                                 const std::vector<MeshPart>& parts) {
+  std::vector<Vertex> result(vertices);
+  for (size_t i{0}; i < result.size(); ++i) {
+    const glm::mat4& transform = parts[vertexParts[i]].transform;
+    result[i].pos = glm::vec3(transform * glm::vec4(result[i].pos, 1.0f));
+  }
+  return result;
+}
+
+}  // namespace
+
+MeshView SceneGeometry::view() const {
+  MeshView mesh{};
+  mesh.vertices = vertices.data();
+  mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+  mesh.indices = indices.data();
+  mesh.indexCount = static_cast<uint32_t>(indices.size());
+  mesh.indexSize = sizeof(uint16_t);
+  mesh.ranges = ranges.data();
+  mesh.rangeCount = static_cast<uint32_t>(ranges.size());
+  mesh.meshlets = meshlets.data();
+  mesh.meshletCount = static_cast<uint32_t>(meshlets.size());
+  mesh.lods = lods.data();
+  mesh.lodCount = static_cast<uint32_t>(lods.size());
+  mesh.parts = parts.data();
+  mesh.partCount = static_cast<uint32_t>(parts.size());
+  mesh.bounds = bounds;
+  mesh.sceneBounds = sceneBounds;
+  return mesh;
+}
+
+void SceneGeometry::releaseGeometry() {
+  std::vector<Vertex>().swap(vertices);
+  std::vector<uint16_t>().swap(indices);
+  std::vector<Meshlet>().swap(meshlets);
+}
+
+SceneGeometry buildScene(const std::vector<ImportedPart>& imported,
+                         size_t maxLods) {
+  if (imported.empty()) {
+    throw std::runtime_error("scene has no parts!");
+  }
+
+  // Parts are welded in parallel with each other; a lone part gets all
+  // threads for itself.
+  std::vector<PartGeometry> geometry(imported.size());
+  const unsigned int weldThreads = imported.size() == 1 ? 0u : 1u;
+  parallelFor(imported.size(), [&](size_t part) {
+    PartGeometry& result = geometry[part];
+    weldVertices(imported[part].corners, result.vertices, result.indices,
+                 weldThreads);
+    result.stats = optimizeMesh(result.vertices, result.indices);
+  });
+
+  // Sized up front so that concatenating doesn't leave the vectors up to
+  // twice as large as the scene.
+  size_t vertexCount{0};
+  size_t indexCount{0};
+  for (const PartGeometry& part : geometry) {
+    vertexCount += part.vertices.size();
+    indexCount += part.indices.size();
+  }
+  SceneGeometry scene;
+  std::vector<uint32_t> indices;
+  std::vector<uint32_t> vertexParts;
+  scene.vertices.reserve(vertexCount);
+  indices.reserve(indexCount);
+  vertexParts.reserve(vertexCount);
+  size_t triangleCount{0};
+  for (size_t part{0}; part < imported.size(); ++part) {
+    const PartGeometry& source = geometry[part];
+    const auto base = static_cast<uint32_t>(scene.vertices.size());
+    for (uint32_t index : source.indices) {
+      indices.push_back(base + index);
+    }
+    scene.vertices.insert(scene.vertices.end(), source.vertices.begin(),
+                          source.vertices.end());
+    vertexParts.insert(vertexParts.end(), source.vertices.size(),
+                       static_cast<uint32_t>(part));
+
+    MeshPart meshPart{};
+    meshPart.transform = imported[part].transform;
+    meshPart.material = imported[part].material;
+    scene.parts.push_back(meshPart);
+
+    // ACMR is per triangle and ATVR per vertex, so weigh them that way.
+    const size_t triangles = source.indices.size() / 3;
+    scene.stats.before.acmr +=
+        source.stats.before.acmr * static_cast<float>(triangles);
+    scene.stats.before.atvr +=
+        source.stats.before.atvr * static_cast<float>(source.vertices.size());
+    triangleCount += triangles;
+  }
+  if (triangleCount == 0) {
+    throw std::runtime_error("scene has no triangles!");
+  }
+  scene.stats.before.acmr /= static_cast<float>(triangleCount);
+  scene.stats.before.atvr /= static_cast<float>(scene.vertices.size());
+  // The scene holds its own copy now.
+  std::vector<PartGeometry>().swap(geometry);
+
+  // Each level of detail is laid out part by part, with the triangles of a
+  // part in the order the vertex cache optimization left them.
+  const std::vector<LodLevel> chain = buildLodChain(
+      toSceneSpace(scene.vertices, vertexParts, scene.parts), indices,
+      maxLods);
+  std::vector<uint32_t>().swap(indices);
+  std::vector<uint32_t> lodIndices;
+  std::vector<uint32_t> segmentStarts;
+  std::vector<uint32_t> segmentParts;
+  for (const LodLevel& level : chain) {
+    MeshLod lod{};
+    lod.firstIndex = static_cast<uint32_t>(lodIndices.size());
+    lod.indexCount = static_cast<uint32_t>(level.indices.size());
+    lod.error = level.error;
+    scene.lods.push_back(lod);
+
+    const auto partOf = [&](uint32_t triangle) {
+      return vertexParts[level.indices[triangle * 3]];
+    };
+    std::vector<uint32_t> triangles(level.indices.size() / 3);
+    std::iota(triangles.begin(), triangles.end(), 0u);
+    std::stable_sort(triangles.begin(), triangles.end(),
+                     [&](uint32_t a, uint32_t b) {
+                       return partOf(a) < partOf(b);
+                     });
+    for (size_t i{0}; i < triangles.size(); ++i) {
+      const uint32_t part = partOf(triangles[i]);
+      if (i == 0 || part != segmentParts.back()) {
+        segmentStarts.push_back(static_cast<uint32_t>(lodIndices.size()));
+        segmentParts.push_back(part);
+      }
+      const uint32_t* corner = level.indices.data() + triangles[i] * 3;
+      lodIndices.insert(lodIndices.end(), corner, corner + 3);
+    }
+  }
+
+  splitForUint16(scene.vertices, lodIndices, scene.indices, scene.ranges,
+                 MAX_UINT16_VERTICES, segmentStarts);
+  std::vector<uint32_t>().swap(lodIndices);
+  // Splitting may have copied vertices, so the parts are found again from
+  // the ranges, which never cross a segment.
+  vertexParts.assign(scene.vertices.size(), 0);
+  for (MeshRange& range : scene.ranges) {
+    const auto segment = static_cast<size_t>(
+        std::upper_bound(segmentStarts.begin(), segmentStarts.end(),
+                         range.firstIndex) -
+        segmentStarts.begin() - 1);
+    range.part = segmentParts[segment];
+    for (uint32_t i{0}; i < range.indexCount; ++i) {
+      vertexParts[static_cast<size_t>(range.vertexOffset) +
+                  scene.indices[range.firstIndex + i]] = range.part;
+    }
+  }
+
+  const std::vector<Vertex> sceneVertices =
+      toSceneSpace(scene.vertices, vertexParts, scene.parts);
+  scene.meshlets = buildMeshlets(sceneVertices, scene.indices, scene.ranges);
+  assignLodSpans(scene.lods, scene.ranges, scene.meshlets);
+
+  scene.bounds = computeBounds(scene.vertices.data(), scene.vertices.size());
+  scene.sceneBounds =
+      computeBounds(sceneVertices.data(), sceneVertices.size());
+  // Meshlets reorder triangles, report what is actually drawn.
+  scene.stats.after = analyzeVertexCache(scene.view(), 0);
+  return scene;
+}
@@ -0,0 +1,47 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_SCENEBUILDER_HPP
+#define VULKANTEST_SCENEBUILDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshSimplifier.hpp"
+#include "ModelLoader.hpp"
+
+// Every part of a scene in one vertex array and one 16-bit index array, so
+// that the whole scene draws from a single pair of buffers. Levels of detail
+// follow each other in the index buffer; within a level each part has ranges
+// of its own.
+struct SceneGeometry {
+  std::vector<Vertex> vertices;  // mesh space of their part
+  std::vector<uint16_t> indices;
+  std::vector<MeshRange> ranges;
+  std::vector<Meshlet> meshlets;
+  std::vector<MeshLod> lods;
+  std::vector<MeshPart> parts;
+  MeshBounds bounds;
+  MeshBounds sceneBounds;
+  // Vertex cache statistics over all parts, the final ones for the finest
+  // level as drawn.
+  MeshOptimizationStats stats;
+
+  [[nodiscard]] MeshView view() const;
+  // Frees the vertices, indices and meshlets once they are uploaded. The
+  // ranges, levels of detail and parts stay for drawing; a view taken before
+  // keeps its counts but must not read the freed arrays.
+  void releaseGeometry();
+};
+
+// Welds and optimizes every part on its own, then simplifies, splits and
+// clusters the scene as a whole: levels of detail are chosen for the scene,
+// with errors measured in scene space.
+SceneGeometry buildScene(const std::vector<ImportedPart>& parts,
+                         size_t maxLods = MAX_MESH_LODS);
+
+#endif  // VULKANTEST_SCENEBUILDER_HPP
@@ -0,0 +1,91 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "SourceStamp.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#include "Hash.hpp"
+
+namespace {
+
+bool statSource(const std::string& sourcePath, uint64_t& size,
+                int64_t& mtime) {
+  std::error_code ec;
+  size = std::filesystem::file_size(sourcePath, ec);
+  if (ec) {
+    return false;
+  }
+  auto writeTime = std::filesystem::last_write_time(sourcePath, ec);
+  if (ec) {
+    return false;
+  }
+  mtime = writeTime.time_since_epoch().count();
+  return true;
+}
+
+uint64_t hashFile(const std::string& path) {
+  MappedFile file;
+  if (!file.open(path)) {
+    return 0;
+  }
+  return hashBytes(file.data(), file.size());
+}
+
+}  // namespace
+
+SourceStamp stampSource(const std::string& sourcePath) {
+  SourceStamp stamp{};
+  if (statSource(sourcePath, stamp.size, stamp.mtime)) {
+    stamp.contentHash = hashFile(sourcePath);
+  }
+  return stamp;
+}
+
+bool openStampedFile(MappedFile& file, const std::string& cachePath,
+                     const std::string& sourcePath, uint64_t stampOffset) {
+  if (!file.open(cachePath)) {
+    return false;
+  }
+  if (file.size() < stampOffset + sizeof(SourceStamp)) {
+    file.close();
+    return false;
+  }
+  SourceStamp stamp{};
+  std::memcpy(&stamp, file.data() + stampOffset, sizeof(stamp));
+  uint64_t size{0};
+  int64_t mtime{0};
+  if (!statSource(sourcePath, size, mtime)) {
+    return true;
+  }
+  if (size != stamp.size) {
+    file.close();
+    return false;
+  }
+  if (mtime == stamp.mtime) {
+    return true;
+  }
+  if (hashFile(sourcePath) != stamp.contentHash) {
+    file.close();
+    return false;
+  }
+
+  // The mapping is read-only, and on Windows it keeps the file from being
+  // written at all.
+  file.close();
+  {
+    std::fstream out(cachePath,
+                     std::ios::in | std::ios::out | std::ios::binary);
+    if (out.is_open()) {
+      out.seekp(static_cast<std::streamoff>(stampOffset +
+                                            offsetof(SourceStamp, mtime)));
+      out.write(reinterpret_cast<const char*>(&mtime), sizeof(mtime));
+    }
+  }
+  return file.open(cachePath);
+}
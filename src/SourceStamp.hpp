@@ -0,0 +1,35 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_SOURCESTAMP_HPP
+#define VULKANTEST_SOURCESTAMP_HPP
+
+#include <cstdint>
+#include <string>
+
+#include "MappedFile.hpp"
+
+// Identifies the source asset a cooked file was made from.
+struct SourceStamp {
+  uint64_t size{0};
+  int64_t mtime{0};
+  uint64_t contentHash{0};
+};
+
+// Zero if the source cannot be read.
+SourceStamp stampSource(const std::string& sourcePath);
+
+// Maps cachePath into `file` if the source is still the one the stamp
+// `stampOffset` bytes into it was taken from. Size and mtime are checked
+// first because they are free. A matching size with a different mtime (fresh
+// checkout, touched file) falls back to the content hash, so only a real edit
+// fails the check. The new mtime is then written over the stamp, between
+// unmapping and mapping the file again, so that the next start takes the
+// cheap path again; if that write fails, the next start just hashes again.
+// Without a source file there is nothing to compare against and the cooked
+// file is trusted as shipped.
+bool openStampedFile(MappedFile& file, const std::string& cachePath,
+                     const std::string& sourcePath, uint64_t stampOffset);
+
+#endif  // VULKANTEST_SOURCESTAMP_HPP
@@ -0,0 +1,41 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "SplitVertex.hpp"
+
+#include <cstring>
+
+std::vector<uint8_t> splitVertices(const Vertex* vertices, size_t count) {
+  std::vector<uint8_t> streams(splitVerticesSize(count));
+  splitVertices(vertices, count, streams.data());
+  return streams;
+}
+
+void splitVertices(const Vertex* vertices, size_t count, uint8_t* streams) {
+  const size_t attributeOffset = splitAttributeOffset(count);
+  for (size_t i{0}; i < count; ++i) {
+    const VertexPosition position{vertices[i].pos};
+    const VertexAttributes attributes{vertices[i].color, vertices[i].texCoord};
+    std::memcpy(streams + i * sizeof(VertexPosition), &position,
+                sizeof(position));
+    std::memcpy(streams + attributeOffset + i * sizeof(VertexAttributes),
+                &attributes, sizeof(attributes));
+  }
+}
+
+std::vector<Vertex> joinVertices(const uint8_t* streams, size_t count) {
+  const size_t attributeOffset = splitAttributeOffset(count);
+  std::vector<Vertex> vertices(count);
+  for (size_t i{0}; i < count; ++i) {
+    VertexPosition position{};
+    VertexAttributes attributes{};
+    std::memcpy(&position, streams + i * sizeof(VertexPosition),
+                sizeof(position));
+    std::memcpy(&attributes,
+                streams + attributeOffset + i * sizeof(VertexAttributes),
+                sizeof(attributes));
+    vertices[i] = {position.pos, attributes.color, attributes.texCoord};
+  }
+  return vertices;
+}
@@ -0,0 +1,104 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_SPLITVERTEX_HPP
+#define VULKANTEST_SPLITVERTEX_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.hpp"
+
+// VertexFormat::Split keeps positions in a stream of their own (binding 0)
+// and the other attributes in a second one (binding 1), so that passes which
+// only need positions fetch 12 bytes per vertex instead of sizeof(Vertex).
+// Both streams live in one buffer, positions first; the parts move to
+// binding 2. The shader locations are the same as with Vertex.
+struct VertexPosition {
+  glm::vec3 pos;
+
+  static VkVertexInputBindingDescription getBindingDescription() {
+    VkVertexInputBindingDescription bindingDescription{};
+    bindingDescription.binding = 0;
+    bindingDescription.stride = sizeof(VertexPosition);
+    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    return bindingDescription;
+  }
+
+  static std::array<VkVertexInputAttributeDescription, 1>
+  getAttributeDescriptions() {
+    std::array<VkVertexInputAttributeDescription, 1> attributeDescriptions{};
+
+    attributeDescriptions[0].binding = 0;
+    attributeDescriptions[0].location = 0;
+    attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attributeDescriptions[0].offset = offsetof(VertexPosition, pos);
+
+    return attributeDescriptions;
+  }
+};
+
+struct VertexAttributes {
+  glm::vec3 color;
+  glm::vec2 texCoord;
+
+  static VkVertexInputBindingDescription getBindingDescription() {
+    VkVertexInputBindingDescription bindingDescription{};
+    bindingDescription.binding = 1;
+    bindingDescription.stride = sizeof(VertexAttributes);
+    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    return bindingDescription;
+  }
+
+  static std::array<VkVertexInputAttributeDescription, 2>
+  getAttributeDescriptions() {
+    std::array<VkVertexInputAttributeDescription, 2> attributeDescriptions{};
+
+    attributeDescriptions[0].binding = 1;
+    attributeDescriptions[0].location = 1;
+    attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attributeDescriptions[0].offset = offsetof(VertexAttributes, color);
+
+    attributeDescriptions[1].binding = 1;
+    attributeDescriptions[1].location = 2;
+    attributeDescriptions[1].format = VK_FORMAT_R32G32_SFLOAT;
+    attributeDescriptions[1].offset = offsetof(VertexAttributes, texCoord);
+
+    return attributeDescriptions;
+  }
+};
+
+static_assert(sizeof(VertexPosition) == 12 && sizeof(VertexAttributes) == 20,
+              "split streams must be tightly packed");
+
+constexpr uint32_t SPLIT_PART_BINDING = 2;
+
+// Where the attribute stream starts in a buffer of `vertexCount` split
+// vertices.
+inline size_t splitAttributeOffset(size_t vertexCount) {
+  constexpr size_t alignment = 16;
+  return (vertexCount * sizeof(VertexPosition) + alignment - 1) / alignment *
+         alignment;
+}
+
+// Bytes both streams of `vertexCount` split vertices take.
+inline size_t splitVerticesSize(size_t vertexCount) {
+  return splitAttributeOffset(vertexCount) +
+         vertexCount * sizeof(VertexAttributes);
+}
+
+// Both streams, laid out as they are uploaded.
+std::vector<uint8_t> splitVertices(const Vertex* vertices, size_t count);
+// Writes both streams to `streams`, which holds splitVerticesSize(count)
+// bytes, e.g. mapped memory.
+void splitVertices(const Vertex* vertices, size_t count, uint8_t* streams);
+
+// Inverse of splitVertices().
+std::vector<Vertex> joinVertices(const uint8_t* streams, size_t count);
+
+#endif  // VULKANTEST_SPLITVERTEX_HPP
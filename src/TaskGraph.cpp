@@ -0,0 +1,179 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "TaskGraph.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <iomanip>
+#include <mutex>
+#include <stdexcept>
+
+#include "Parallel.hpp"
+
+TaskGraph::Task TaskGraph::add(std::string name, std::function<void()> work,
+                               std::vector<Task> dependencies,
+                               bool callingThread) {
+  const Task task = tasks_.size();
+  for (Task dependency : dependencies) {
+    if (dependency >= task) {
+      throw std::runtime_error("task depends on an unknown task!");
+    }
+    tasks_[dependency].dependents.push_back(task);
+  }
+  Node node;
+  node.name = std::move(name);
+  node.work = std::move(work);
+  node.dependencies = std::move(dependencies);
+  node.callingThread = callingThread;
+  tasks_.push_back(std::move(node));
+  return task;
+}
+
+void TaskGraph::run(unsigned int threadCount) {
+  using Clock = std::chrono::steady_clock;
+  const Clock::time_point begin = Clock::now();
+  const auto now = [begin]() {
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin)
+        .count();
+  };
+
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::deque<Task> ready;
+  std::deque<Task> readyOnCaller;
+  const auto push = [&](Task task) {
+    (tasks_[task].callingThread ? readyOnCaller : ready).push_back(task);
+  };
+  std::vector<size_t> waitingFor(tasks_.size());
+  for (Task task{0}; task < tasks_.size(); ++task) {
+    tasks_[task].ran = false;
+    waitingFor[task] = tasks_[task].dependencies.size();
+    if (waitingFor[task] == 0) {
+      push(task);
+    }
+  }
+  size_t finished{0};
+  size_t running{0};
+  std::exception_ptr error;
+
+  const auto done = [&]() {
+    return finished == tasks_.size() || (error && running == 0);
+  };
+  const auto worker = [&](bool caller) {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+      changed.wait(lock, [&]() {
+        return !ready.empty() || (caller && !readyOnCaller.empty()) || done();
+      });
+      if (done()) {
+        return;
+      }
+      std::deque<Task>& queue =
+          caller && !readyOnCaller.empty() ? readyOnCaller : ready;
+      const Task task = queue.front();
+      queue.pop_front();
+      ++running;
+      Node& node = tasks_[task];
+      lock.unlock();
+
+      node.timing.start = now();
+      std::exception_ptr taskError;
+      try {
+        node.work();
+      } catch (...) {
+        taskError = std::current_exception();
+      }
+      node.timing.end = now();
+
+      lock.lock();
+      --running;
+      ++finished;
+      node.ran = true;
+      if (taskError) {
+        if (!error) {
+          error = taskError;
+        }
+        ready.clear();
+        readyOnCaller.clear();
+      } else if (!error) {
+        for (Task dependent : node.dependents) {
+          if (--waitingFor[dependent] == 0) {
+            push(dependent);
+          }
+        }
+      }
+      changed.notify_all();
+    }
+  };
+
+  const unsigned int threads =
+      threadCount != 0 ? threadCount : std::max(workerCount(), 2u);
+  std::vector<std::future<void>> futures;
+  for (unsigned int thread{1}; thread < threads; ++thread) {
+    futures.push_back(std::async(std::launch::async, worker, false));
+  }
+  worker(true);
+  for (auto& future : futures) {
+    future.get();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+std::vector<TaskGraph::Task> TaskGraph::criticalPath() const {
+  std::vector<Task> path;
+  const auto finishedLater = [this](Task a, Task b) {
+    return tasks_[a].timing.end < tasks_[b].timing.end;
+  };
+  std::vector<Task> candidates;
+  for (Task task{0}; task < tasks_.size(); ++task) {
+    if (tasks_[task].ran) {
+      candidates.push_back(task);
+    }
+  }
+  while (!candidates.empty()) {
+    const Task last =
+        *std::max_element(candidates.begin(), candidates.end(), finishedLater);
+    path.push_back(last);
+    candidates = tasks_[last].dependencies;
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+void TaskGraph::printTimings(std::ostream& out) const {
+  size_t width{0};
+  for (const Node& node : tasks_) {
+    width = std::max(width, node.name.size());
+  }
+  const auto flags = out.flags();
+  const auto precision = out.precision();
+  out << std::fixed << std::setprecision(1);
+  for (const Node& node : tasks_) {
+    if (!node.ran) {
+      out << "  " << std::left << std::setw(static_cast<int>(width))
+          << node.name << std::right << "  skipped\n";
+      continue;
+    }
+    out << "  " << std::left << std::setw(static_cast<int>(width))
+        << node.name << std::right << std::setw(9) << node.timing.start
+        << " ->" << std::setw(9) << node.timing.end << " ms ("
+        << node.timing.end - node.timing.start << " ms)\n";
+  }
+  const std::vector<Task> path = criticalPath();
+  if (!path.empty()) {
+    out << "  critical path:";
+    for (Task task : path) {
+      out << ' ' << tasks_[task].name << (task == path.back() ? "" : " >");
+    }
+    out << " (" << tasks_[path.back()].timing.end << " ms)\n";
+  }
+  out.flags(flags);
+  out.precision(precision);
+}
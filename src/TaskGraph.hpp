@@ -0,0 +1,66 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_TASKGRAPH_HPP
+#define VULKANTEST_TASKGRAPH_HPP
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// A set of named tasks with dependencies that run in parallel as soon as
+// what they depend on has finished. Used to overlap the independent parts of
+// startup (file I/O, decoding, device creation) and to log where the time
+// goes.
+class TaskGraph {
+ public:
+  using Task = size_t;
+
+  struct Timing {
+    double start{0.0};  // milliseconds since run() was called
+    double end{0.0};
+  };
+
+  // Dependencies must have been added before, which keeps the graph acyclic.
+  // Work that has to stay on the thread calling run() (most of GLFW may only
+  // be used from the main thread) sets callingThread.
+  Task add(std::string name, std::function<void()> work,
+           std::vector<Task> dependencies = {}, bool callingThread = false);
+
+  // Runs every task once, on up to threadCount threads (0 = one per hardware
+  // thread, but at least two, since most startup tasks wait on the disk or
+  // the driver rather than compute). If a task throws, tasks that have not
+  // started are skipped and the first exception is rethrown once the running
+  // ones have finished.
+  void run(unsigned int threadCount = 0);
+
+  [[nodiscard]] const Timing& timing(Task task) const {
+    return tasks_[task].timing;
+  }
+
+  // The chain of tasks, first to last, that determined when the last task
+  // finished: each one is the dependency of the next that finished last.
+  [[nodiscard]] std::vector<Task> criticalPath() const;
+
+  // One line per task with its start, end and duration, then the critical
+  // path.
+  void printTimings(std::ostream& out) const;
+
+ private:
+  struct Node {
+    std::string name;
+    std::function<void()> work;
+    std::vector<Task> dependencies;
+    std::vector<Task> dependents;
+    Timing timing;
+    bool callingThread{false};
+    bool ran{false};
+  };
+
+  std::vector<Node> tasks_;
+};
+
+#endif  // VULKANTEST_TASKGRAPH_HPP
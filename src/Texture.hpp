@@ -0,0 +1,95 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_TEXTURE_HPP
+#define VULKANTEST_TEXTURE_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One mip level: `size` bytes of tightly packed rows, `offset` bytes into the
+// texture's level data.
+struct TextureLevel {
+  uint64_t offset;
+  uint64_t size;
+  uint32_t width;
+  uint32_t height;
+};
+
+// Non-owning view of a texture with its whole mip chain in the format it is
+// uploaded in. Points either into a CookedTexture or straight into a mapped
+// texture cache.
+struct TextureView {
+  VkFormat format{VK_FORMAT_UNDEFINED};
+  uint32_t width{0};
+  uint32_t height{0};
+  const TextureLevel* levels{nullptr};  // largest first
+  uint32_t levelCount{0};
+  const uint8_t* data{nullptr};
+  uint64_t dataSize{0};
+  // Extent of the texture an atlas tile holds, 0 for any other texture. See
+  // TextureAtlas.hpp.
+  uint32_t contentWidth{0};
+  uint32_t contentHeight{0};
+};
+
+// A texture cooked in memory, in the layout of a texture cache.
+struct CookedTexture {
+  VkFormat format{VK_FORMAT_UNDEFINED};
+  uint32_t width{0};
+  uint32_t height{0};
+  std::vector<TextureLevel> levels;
+  std::vector<uint8_t> data;
+  uint32_t contentWidth{0};
+  uint32_t contentHeight{0};
+
+  [[nodiscard]] TextureView view() const {
+    return {format,
+            width,
+            height,
+            levels.data(),
+            static_cast<uint32_t>(levels.size()),
+            data.data(),
+            data.size(),
+            contentWidth,
+            contentHeight};
+  }
+};
+
+// Levels of a full chain down to 1x1.
+inline uint32_t mipLevelCount(uint32_t width, uint32_t height) {
+  uint32_t levels{1};
+  for (uint32_t size = width > height ? width : height; size > 1; size /= 2) {
+    ++levels;
+  }
+  return levels;
+}
+
+inline uint32_t mipExtent(uint32_t extent, uint32_t level) {
+  return extent >> level > 0 ? extent >> level : 1;
+}
+
+// Bytes of one width x height level in `format`, or 0 if the format is not
+// one textures are cooked to. Block-compressed levels are stored as whole 4x4
+// blocks, so a 1x1 level still takes one block.
+inline uint64_t textureLevelSize(VkFormat format, uint32_t width,
+                                 uint32_t height) {
+  const uint64_t blocks = uint64_t{(width + 3) / 4} * ((height + 3) / 4);
+  switch (format) {
+    case VK_FORMAT_R8G8B8A8_SRGB:
+      return uint64_t{width} * height * 4;
+    case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+      return blocks * 8;
+    case VK_FORMAT_BC3_SRGB_BLOCK:
+    case VK_FORMAT_BC7_SRGB_BLOCK:
+      return blocks * 16;
+    default:
+      return 0;
+  }
+}
+
+#endif  // VULKANTEST_TEXTURE_HPP
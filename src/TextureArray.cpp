@@ -0,0 +1,96 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "TextureArray.hpp"
+
+std::vector<TextureArrayLayout> groupTextureLayers(
+    const std::vector<TextureView>& textures, uint32_t maxLayers) {
+  std::vector<TextureArrayLayout> arrays;
+  for (size_t i{0}; i < textures.size(); ++i) {
+    const TextureView& texture = textures[i];
+    // Batches are tens to hundreds of textures in a handful of sizes, so a
+    // linear search over the open arrays is enough.
+    TextureArrayLayout* match{nullptr};
+    for (TextureArrayLayout& array : arrays) {
+      if (array.format == texture.format && array.width == texture.width &&
+          array.height == texture.height &&
+          array.levelCount == texture.levelCount &&
+          array.textures.size() < maxLayers) {
+        match = &array;
+        break;
+      }
+    }
+    if (match == nullptr) {
+      TextureArrayLayout array;
+      array.format = texture.format;
+      array.width = texture.width;
+      array.height = texture.height;
+      array.levelCount = texture.levelCount;
+      arrays.push_back(array);
+      match = &arrays.back();
+    }
+    match->textures.push_back(static_cast<uint32_t>(i));
+  }
+  return arrays;
+}
+
+uint32_t mipTailLevel(const TextureArrayLayout& array) {
+  uint32_t level{0};
+  while (level + 1 < array.levelCount &&
+         (mipExtent(array.width, level) > MIP_TAIL_EXTENT ||
+          mipExtent(array.height, level) > MIP_TAIL_EXTENT)) {
+    ++level;
+  }
+  return level;
+}
+
+std::vector<uint64_t> mipTailOffsets(
+    const std::vector<TextureView>& textures,
+    const std::vector<TextureArrayLayout>& arrays) {
+  std::vector<uint64_t> offsets(textures.size());
+  for (size_t i{0}; i < textures.size(); ++i) {
+    offsets[i] = textures[i].dataSize;
+  }
+  for (const TextureArrayLayout& array : arrays) {
+    const uint32_t tail = mipTailLevel(array);
+    for (uint32_t texture : array.textures) {
+      offsets[texture] = textures[texture].levels[tail].offset;
+    }
+  }
+  return offsets;
+}
+
+uint64_t arrayLevelSize(const TextureArrayLayout& array, uint32_t level) {
+  return textureLevelSize(array.format, mipExtent(array.width, level),
+                          mipExtent(array.height, level)) *
+         array.textures.size();
+}
+
+std::vector<MipUpload> planMipUploads(
+    const std::vector<TextureArrayLayout>& arrays,
+    std::vector<uint32_t>& residentLevels, uint64_t budget) {
+  std::vector<MipUpload> uploads;
+  uint64_t planned{0};
+  while (true) {
+    size_t next{arrays.size()};
+    uint64_t nextSize{0};
+    for (size_t i{0}; i < arrays.size(); ++i) {
+      if (residentLevels[i] == 0) {
+        continue;
+      }
+      const uint64_t size = arrayLevelSize(arrays[i], residentLevels[i] - 1);
+      if (next == arrays.size() || size < nextSize) {
+        next = i;
+        nextSize = size;
+      }
+    }
+    if (next == arrays.size() ||
+        (!uploads.empty() && planned + nextSize > budget)) {
+      return uploads;
+    }
+    --residentLevels[next];
+    uploads.push_back({next, residentLevels[next]});
+    planned += nextSize;
+  }
+}
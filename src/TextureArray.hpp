@@ -0,0 +1,84 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_TEXTUREARRAY_HPP
+#define VULKANTEST_TEXTUREARRAY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Texture.hpp"
+#include "TextureCache.hpp"
+
+// Textures that are loaded together, by asset name. Each view points into
+// the cache or the cooked texture at the same index, so the batch has to
+// outlive the views; it is dropped as a whole once everything is uploaded.
+struct TextureBatch {
+  TextureBatch() = default;
+  explicit TextureBatch(std::vector<std::string> textureNames)
+      : names(std::move(textureNames)),
+        caches(names.size()),
+        cooked(names.size()),
+        views(names.size()) {}
+
+  std::vector<std::string> names;
+  std::vector<TextureCache> caches;
+  std::vector<CookedTexture> cooked;
+  std::vector<TextureView> views;
+};
+
+// Textures of one format, extent and level count, uploaded as the layers of
+// one image.
+struct TextureArrayLayout {
+  VkFormat format{VK_FORMAT_UNDEFINED};
+  uint32_t width{0};
+  uint32_t height{0};
+  uint32_t levelCount{0};
+  std::vector<uint32_t> textures;  // batch index of each layer
+};
+
+// Groups a batch into arrays of at most maxLayers layers. Arrays are ordered
+// by their first texture and layers by batch index, so texture 0 is always
+// layer 0 of array 0.
+std::vector<TextureArrayLayout> groupTextureLayers(
+    const std::vector<TextureView>& textures, uint32_t maxLayers);
+
+// Levels no larger than this in either dimension form the mip tail, which is
+// uploaded before the first frame; finer levels are streamed in afterwards.
+constexpr uint32_t MIP_TAIL_EXTENT = 128;
+
+// The finest level of the array's mip tail. A texture smaller than
+// MIP_TAIL_EXTENT is all tail.
+uint32_t mipTailLevel(const TextureArrayLayout& array);
+
+// Where each texture's mip tail starts in its data: at the finest tail level
+// of its array. Levels are stored largest first, so the tail runs to the end
+// of the data. Textures in none of the arrays, such as atlas tiles, start at
+// the end and have no tail to upload.
+std::vector<uint64_t> mipTailOffsets(
+    const std::vector<TextureView>& textures,
+    const std::vector<TextureArrayLayout>& arrays);
+
+// Bytes of one level across all layers of the array.
+uint64_t arrayLevelSize(const TextureArrayLayout& array, uint32_t level);
+
+// One level of one array, uploaded for all its layers at once.
+struct MipUpload {
+  size_t array;
+  uint32_t level;
+};
+
+// Picks the levels to stream next, given the finest resident level of each
+// array, and lowers those to match. The smallest pending levels go first,
+// so all arrays sharpen at the same pace. The picked levels take at most
+// `budget` bytes, except that at least one level is picked while any is
+// missing. Returns nothing once every level is resident.
+std::vector<MipUpload> planMipUploads(
+    const std::vector<TextureArrayLayout>& arrays,
+    std::vector<uint32_t>& residentLevels, uint64_t budget);
+
+#endif  // VULKANTEST_TEXTUREARRAY_HPP
@@ -0,0 +1,210 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "TextureAtlas.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include "Parallel.hpp"
+
+namespace {
+
+uint32_t alignUp(uint32_t value, uint32_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+// The top edge of the packed tiles over [x, x + width).
+struct SkylineSegment {
+  uint32_t x;
+  uint32_t y;
+  uint32_t width;
+};
+
+// Moves `rect` to the lowest spot on the skyline where it fits, the
+// leftmost of those. Segments are ordered by x.
+void findSpot(const std::vector<SkylineSegment>& skyline, uint32_t atlasWidth,
+              AtlasRect& rect) {
+  bool found{false};
+  for (size_t i{0}; i < skyline.size(); ++i) {
+    const uint32_t x = skyline[i].x;
+    if (x + rect.width > atlasWidth) {
+      return;
+    }
+    uint32_t y{0};
+    for (size_t j{i}; j < skyline.size() && skyline[j].x < x + rect.width;
+         ++j) {
+      y = std::max(y, skyline[j].y);
+    }
+    if (!found || y < rect.y) {
+      rect.x = x;
+      rect.y = y;
+      found = true;
+    }
+  }
+}
+
+// Puts the top of `rect` into the skyline in place of the segments below it,
+// merging neighbors of equal height.
+void raiseSkyline(std::vector<SkylineSegment>& skyline, const AtlasRect& rect) {
+  const uint32_t end = rect.x + rect.width;
+  const SkylineSegment top{rect.x, rect.y + rect.height, rect.width};
+  std::vector<SkylineSegment> raised;
+  bool inserted{false};
+  for (const SkylineSegment& segment : skyline) {
+    const uint32_t segmentEnd = segment.x + segment.width;
+    if (segmentEnd <= rect.x) {
+      raised.push_back(segment);
+      continue;
+    }
+    if (segment.x < rect.x) {
+      raised.push_back({segment.x, segment.y, rect.x - segment.x});
+    }
+    if (!inserted) {
+      raised.push_back(top);
+      inserted = true;
+    }
+    if (segment.x >= end) {
+      raised.push_back(segment);
+    } else if (segmentEnd > end) {
+      raised.push_back({end, segment.y, segmentEnd - end});
+    }
+  }
+
+  skyline.clear();
+  for (const SkylineSegment& segment : raised) {
+    if (!skyline.empty() && skyline.back().y == segment.y) {
+      skyline.back().width += segment.width;
+    } else {
+      skyline.push_back(segment);
+    }
+  }
+}
+
+}  // namespace
+
+bool isAtlasCandidate(uint32_t width, uint32_t height) {
+  return width <= ATLAS_MAX_TILE_EXTENT && height <= ATLAS_MAX_TILE_EXTENT;
+}
+
+CookedTexture cookAtlasTile(const uint8_t* pixels, uint32_t width,
+                            uint32_t height, MipKernel kernel,
+                            unsigned int threadCount) {
+  const uint32_t tileWidth = alignUp(width + 2 * ATLAS_GUTTER, ATLAS_ALIGNMENT);
+  const uint32_t tileHeight =
+      alignUp(height + 2 * ATLAS_GUTTER, ATLAS_ALIGNMENT);
+  CookedTexture tile = allocateTexture(tileWidth, tileHeight);
+  tile.contentWidth = width;
+  tile.contentHeight = height;
+
+  uint8_t* texels = tile.data.data();
+  parallelFor(
+      tileHeight,
+      [&](size_t y) {
+        const size_t sourceY = std::clamp<size_t>(
+            y < ATLAS_GUTTER ? 0 : y - ATLAS_GUTTER, 0, height - 1);
+        const uint8_t* row = pixels + sourceY * width * 4;
+        const uint8_t* last = row + size_t{width - 1} * 4;
+        uint8_t* out = texels + y * tileWidth * 4;
+        for (uint32_t x{0}; x < ATLAS_GUTTER; ++x) {
+          memcpy(out + size_t{x} * 4, row, 4);
+        }
+        memcpy(out + size_t{ATLAS_GUTTER} * 4, row, size_t{width} * 4);
+        for (uint32_t x{ATLAS_GUTTER + width}; x < tileWidth; ++x) {
+          memcpy(out + size_t{x} * 4, last, 4);
+        }
+      },
+      threadCount);
+  cookMips(tile, kernel, threadCount);
+  return tile;
+}
+
+// Every tile extent is a multiple of ATLAS_ALIGNMENT, so every spot on the
+// skyline is one as well.
+AtlasLayout packAtlas(const std::vector<TextureView>& tiles,
+                      uint32_t maxExtent) {
+  std::vector<size_t> order(tiles.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return tiles[a].height > tiles[b].height;
+  });
+  uint32_t widest{ATLAS_ALIGNMENT};
+  for (const TextureView& tile : tiles) {
+    widest = std::max(widest, tile.width);
+  }
+
+  uint64_t width{1};
+  while (width < widest) {
+    width *= 2;
+  }
+  for (; width <= maxExtent; width *= 2) {
+    AtlasLayout layout;
+    layout.width = static_cast<uint32_t>(width);
+    layout.rects.resize(tiles.size());
+    std::vector<SkylineSegment> skyline{{0, 0, layout.width}};
+    for (size_t tile : order) {
+      AtlasRect& rect = layout.rects[tile];
+      rect.width = tiles[tile].width;
+      rect.height = tiles[tile].height;
+      findSpot(skyline, layout.width, rect);
+      raiseSkyline(skyline, rect);
+      layout.height = std::max(layout.height, rect.y + rect.height);
+    }
+    if (layout.height <= layout.width) {
+      return layout;
+    }
+  }
+  return {};
+}
+
+// Packing is cheap next to uploading, so the tiles are simply packed again
+// after each one left out.
+std::vector<uint32_t> chooseAtlasTiles(const std::vector<TextureView>& textures,
+                                       uint32_t maxExtent) {
+  std::vector<uint32_t> chosen;
+  for (uint32_t i{0}; i < textures.size(); ++i) {
+    const TextureView& texture = textures[i];
+    if (texture.contentWidth != 0 && texture.levelCount >= ATLAS_LEVEL_COUNT &&
+        (chosen.empty() || texture.format == textures[chosen[0]].format)) {
+      chosen.push_back(i);
+    }
+  }
+  std::vector<uint32_t> bySize = chosen;
+  std::stable_sort(bySize.begin(), bySize.end(), [&](uint32_t a, uint32_t b) {
+    return uint64_t{textures[a].width} * textures[a].height >
+           uint64_t{textures[b].width} * textures[b].height;
+  });
+  for (uint32_t largest : bySize) {
+    std::vector<TextureView> tiles;
+    for (uint32_t tile : chosen) {
+      tiles.push_back(textures[tile]);
+    }
+    if (packAtlas(tiles, maxExtent).width != 0) {
+      break;
+    }
+    chosen.erase(std::find(chosen.begin(), chosen.end(), largest));
+  }
+  return chosen;
+}
+
+std::array<float, 4> atlasTexCoordTransform(const AtlasLayout& atlas,
+                                            size_t tile,
+                                            const TextureView& texture) {
+  const AtlasRect& rect = atlas.rects[tile];
+  const auto width = static_cast<float>(atlas.width);
+  const auto height = static_cast<float>(atlas.height);
+  return {static_cast<float>(texture.contentWidth) / width,
+          static_cast<float>(texture.contentHeight) / height,
+          static_cast<float>(rect.x + ATLAS_GUTTER) / width,
+          static_cast<float>(rect.y + ATLAS_GUTTER) / height};
+}
+
+std::array<float, 4> tileTexCoordTransform(const TextureView& tile) {
+  AtlasLayout layout;
+  layout.width = tile.width;
+  layout.height = tile.height;
+  layout.rects.push_back({0, 0, tile.width, tile.height});
+  return atlasTexCoordTransform(layout, 0, tile);
+}
@@ -0,0 +1,83 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_TEXTUREATLAS_HPP
+#define VULKANTEST_TEXTUREATLAS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MipChain.hpp"
+#include "Texture.hpp"
+
+// Small textures share one atlas image instead of getting one each. Each is
+// cooked as a tile: the texture at (ATLAS_GUTTER, ATLAS_GUTTER), its edge
+// repeated out to the tile border, in a tile whose extents are multiples of
+// ATLAS_ALIGNMENT. Tiles sit on that grid in the atlas, so down to the last
+// of its ATLAS_LEVEL_COUNT levels every level of a tile lands on whole 4x4
+// blocks and the gutter is still a texel wide: filtering never reaches into
+// a neighbor.
+constexpr uint32_t ATLAS_GUTTER = 16;
+constexpr uint32_t ATLAS_LEVEL_COUNT = 5;
+constexpr uint32_t ATLAS_ALIGNMENT = 4 << (ATLAS_LEVEL_COUNT - 1);
+
+static_assert(ATLAS_GUTTER >> (ATLAS_LEVEL_COUNT - 1) == 1,
+              "the gutter must last down to the last atlas level");
+
+// The atlas is at most ATLAS_MAX_EXTENT square, well within the 4096 every
+// device supports. Textures up to a quarter of that in each dimension are
+// cooked as tiles, so that nine of the largest still fit; larger ones
+// would crowd out the small textures the atlas is for.
+constexpr uint32_t ATLAS_MAX_EXTENT = 2048;
+constexpr uint32_t ATLAS_MAX_TILE_EXTENT = ATLAS_MAX_EXTENT / 4;
+
+// Whether a width x height texture is cooked as an atlas tile.
+bool isAtlasCandidate(uint32_t width, uint32_t height);
+
+// Cooks a width x height RGBA8 sRGB image as a tile, with its full mip
+// chain; the tile records the image's extent as its content.
+CookedTexture cookAtlasTile(const uint8_t* pixels, uint32_t width,
+                            uint32_t height,
+                            MipKernel kernel = MipKernel::Simd,
+                            unsigned int threadCount = 0);
+
+struct AtlasRect {
+  uint32_t x{0};
+  uint32_t y{0};
+  uint32_t width{0};
+  uint32_t height{0};
+};
+
+// Where each tile goes, in the order the tiles were given.
+struct AtlasLayout {
+  uint32_t width{0};
+  uint32_t height{0};
+  std::vector<AtlasRect> rects;
+};
+
+// Packs tiles bottom-left onto a skyline, tallest first. The atlas is as
+// narrow as a power of two can be without growing taller than wide. Returns
+// a layout of width 0 if the tiles do not fit into maxExtent.
+AtlasLayout packAtlas(const std::vector<TextureView>& tiles,
+                      uint32_t maxExtent);
+
+// The tiles among `textures` that go into the atlas, by index: those of the
+// first tile's format with all the atlas's levels. If they do not fit into
+// maxExtent, the largest are left out until the rest do. Textures left out
+// are used on their own, through tileTexCoordTransform().
+std::vector<uint32_t> chooseAtlasTiles(const std::vector<TextureView>& textures,
+                                       uint32_t maxExtent);
+
+// Scale (x, y) and offset (z, w) that map texture coordinates of the texture
+// in tile `tile` into the atlas.
+std::array<float, 4> atlasTexCoordTransform(const AtlasLayout& atlas,
+                                            size_t tile,
+                                            const TextureView& texture);
+
+// The same for a tile used as a texture of its own, into its content.
+std::array<float, 4> tileTexCoordTransform(const TextureView& tile);
+
+#endif  // VULKANTEST_TEXTUREATLAS_HPP
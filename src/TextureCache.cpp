@@ -0,0 +1,173 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "TextureCache.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace {
+
+// The largest chain a 32-bit extent can have.
+constexpr uint32_t MAX_TEXTURE_LEVELS = 32;
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+void writePadding(std::ofstream& out, uint64_t from, uint64_t to) {
+  static constexpr char zeros[TEXTURE_CACHE_ALIGNMENT]{};
+  out.write(zeros, static_cast<std::streamsize>(to - from));
+}
+
+}  // namespace
+
+bool TextureCache::open(const std::string& cachePath,
+                        const std::string& sourcePath) {
+  close();
+  if (!openStampedFile(file_, cachePath, sourcePath,
+                       offsetof(TextureCacheHeader, source))) {
+    return false;
+  }
+  data_ = file_.data();
+  size_ = file_.size();
+  header_ = reinterpret_cast<const TextureCacheHeader*>(data_);
+  if (!validateLayout()) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+bool TextureCache::open(const uint8_t* data, size_t size) {
+  close();
+  data_ = data;
+  size_ = size;
+  header_ = reinterpret_cast<const TextureCacheHeader*>(data_);
+  if (!validateLayout()) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+void TextureCache::close() {
+  header_ = nullptr;
+  data_ = nullptr;
+  size_ = 0;
+  file_.close();
+}
+
+TextureView TextureCache::view() const {
+  TextureView view{};
+  if (header_ == nullptr) {
+    return view;
+  }
+  view.format = static_cast<VkFormat>(header_->format);
+  view.width = header_->width;
+  view.height = header_->height;
+  view.levels =
+      reinterpret_cast<const TextureLevel*>(data_ + header_->levelOffset);
+  view.levelCount = header_->levelCount;
+  view.data = data_ + header_->dataOffset;
+  view.dataSize = header_->dataSize;
+  view.contentWidth = header_->contentWidth;
+  view.contentHeight = header_->contentHeight;
+  return view;
+}
+
+// Levels have to be exactly the chain the header describes, so that the
+// upload can trust their extents and sizes.
+bool TextureCache::validateLayout() const {
+  if (size_ < sizeof(TextureCacheHeader)) {
+    return false;
+  }
+  if (header_->magic != TEXTURE_CACHE_MAGIC ||
+      header_->version != TEXTURE_CACHE_VERSION ||
+      header_->levelCount == 0 || header_->levelCount > MAX_TEXTURE_LEVELS ||
+      header_->levelCount > mipLevelCount(header_->width, header_->height)) {
+    return false;
+  }
+  const auto format = static_cast<VkFormat>(header_->format);
+  const uint64_t levelBytes =
+      uint64_t{header_->levelCount} * sizeof(TextureLevel);
+  if (header_->levelOffset % alignof(TextureLevel) != 0 ||
+      header_->dataOffset % TEXTURE_CACHE_ALIGNMENT != 0 ||
+      header_->levelOffset > size_ ||
+      levelBytes > size_ - header_->levelOffset ||
+      header_->dataOffset > size_ ||
+      header_->dataSize > size_ - header_->dataOffset ||
+      header_->contentWidth > header_->width ||
+      header_->contentHeight > header_->height ||
+      (header_->contentWidth == 0) != (header_->contentHeight == 0)) {
+    return false;
+  }
+  const auto* levels =
+      reinterpret_cast<const TextureLevel*>(data_ + header_->levelOffset);
+  for (uint32_t i{0}; i < header_->levelCount; ++i) {
+    const TextureLevel& level = levels[i];
+    const uint64_t expected =
+        textureLevelSize(format, level.width, level.height);
+    if (level.width != mipExtent(header_->width, i) ||
+        level.height != mipExtent(header_->height, i) || expected == 0 ||
+        level.size != expected ||
+        level.offset % TEXTURE_CACHE_ALIGNMENT != 0 ||
+        level.offset > header_->dataSize ||
+        level.size > header_->dataSize - level.offset) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TextureCache::write(const std::string& cachePath,
+                         const std::string& sourcePath,
+                         const TextureView& texture) {
+  TextureCacheHeader header{};
+  header.magic = TEXTURE_CACHE_MAGIC;
+  header.version = TEXTURE_CACHE_VERSION;
+  header.source = stampSource(sourcePath);
+  header.format = static_cast<uint32_t>(texture.format);
+  header.width = texture.width;
+  header.height = texture.height;
+  header.levelCount = texture.levelCount;
+  header.levelOffset =
+      alignUp(sizeof(TextureCacheHeader), TEXTURE_CACHE_ALIGNMENT);
+  const uint64_t levelBytes =
+      uint64_t{texture.levelCount} * sizeof(TextureLevel);
+  header.dataOffset =
+      alignUp(header.levelOffset + levelBytes, TEXTURE_CACHE_ALIGNMENT);
+  header.dataSize = texture.dataSize;
+  header.contentWidth = texture.contentWidth;
+  header.contentHeight = texture.contentHeight;
+
+  // Written next to the destination and renamed, like the mesh cache.
+  const std::string tempPath = cachePath + ".tmp";
+  {
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writePadding(out, sizeof(header), header.levelOffset);
+    out.write(reinterpret_cast<const char*>(texture.levels),
+              static_cast<std::streamsize>(levelBytes));
+    writePadding(out, header.levelOffset + levelBytes, header.dataOffset);
+    out.write(reinterpret_cast<const char*>(texture.data),
+              static_cast<std::streamsize>(texture.dataSize));
+    if (!out.good()) {
+      return false;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tempPath, cachePath, ec);
+  if (ec) {
+    std::filesystem::remove(tempPath, ec);
+    return false;
+  }
+  return true;
+}
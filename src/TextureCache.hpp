@@ -0,0 +1,70 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_TEXTURECACHE_HPP
+#define VULKANTEST_TEXTURECACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "MappedFile.hpp"
+#include "SourceStamp.hpp"
+#include "Texture.hpp"
+
+constexpr uint32_t TEXTURE_CACHE_MAGIC = 0x58545456;  // "VTTX"
+constexpr uint32_t TEXTURE_CACHE_VERSION = 2;
+// Enough for vkCmdCopyBufferToImage offsets of any format textures are
+// cooked to.
+constexpr uint64_t TEXTURE_CACHE_ALIGNMENT = 16;
+
+// On-disk layout of a texture cache, after KTX2: this header, levelCount
+// TextureLevel records, largest first, and the level data at dataOffset. Every
+// level is stored already filtered, in the format the image is created with,
+// so the whole chain uploads with one copy. Level offsets are relative to
+// dataOffset and aligned to TEXTURE_CACHE_ALIGNMENT.
+struct TextureCacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  SourceStamp source;
+  uint32_t format;  // VkFormat
+  uint32_t width;
+  uint32_t height;
+  uint32_t levelCount;
+  uint64_t levelOffset;
+  uint64_t dataOffset;
+  uint64_t dataSize;
+  uint32_t contentWidth;  // of an atlas tile, see TextureView
+  uint32_t contentHeight;
+};
+
+class TextureCache {
+ public:
+  // Maps cachePath and validates it against sourcePath. Returns false if the
+  // cache is missing, malformed, from another version or stale.
+  bool open(const std::string& cachePath, const std::string& sourcePath);
+  // Uses a cache that lives in memory owned by the caller, such as an asset
+  // pack entry, which has to stay valid until close(). There is no source to
+  // check it against.
+  bool open(const uint8_t* data, size_t size);
+  void close();
+
+  [[nodiscard]] bool isOpen() const { return header_ != nullptr; }
+  [[nodiscard]] TextureView view() const;
+
+  // Returns false if the cache could not be written; the caller can carry on
+  // without it.
+  static bool write(const std::string& cachePath,
+                    const std::string& sourcePath, const TextureView& texture);
+
+ private:
+  MappedFile file_;
+  const uint8_t* data_{nullptr};
+  size_t size_{0};
+  const TextureCacheHeader* header_{nullptr};
+
+  bool validateLayout() const;
+};
+
+#endif  // VULKANTEST_TEXTURECACHE_HPP
@@ -0,0 +1,236 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "VertexWelder.hpp"
+
+#include <stdexcept>
+
+#include "Parallel.hpp"
+
+namespace {
+
+// Below this many corners the serial weld wins over the thread start-up.
+constexpr size_t MIN_PARALLEL_CORNERS = 64 * 1024;
+constexpr size_t MAX_SHARDS = 256;
+
+size_t capacityFor(size_t vertices) {
+  // Keep the load factor at or below one half.
+  size_t capacity{16};
+  while (capacity < vertices * 2) {
+    capacity *= 2;
+  }
+  return capacity;
+}
+
+void weldSerial(const std::vector<Vertex>& corners,
+                std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+  VertexWeldTable table(corners.size());
+  indices.reserve(indices.size() + corners.size());
+  for (const auto& corner : corners) {
+    indices.push_back(table.weld(corner, vertices));
+  }
+}
+
+// Corners are bucketed by the top bits of their hash, so equal vertices
+// always land in the same shard and the shards can be welded independently.
+// Every pass walks the corners in contiguous blocks, and buckets keep corner
+// order, so the first corner of each distinct vertex is found exactly as the
+// serial weld finds it. A prefix sum over those first corners then hands out
+// the same indices the serial weld would.
+void weldSharded(const std::vector<Vertex>& corners,
+                 std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                 unsigned int threadCount) {
+  const size_t cornerCount = corners.size();
+  if (cornerCount >= UINT32_MAX) {
+    throw std::runtime_error("too many vertices to index with 32 bits!");
+  }
+  const size_t blocks = workerCount(threadCount);
+  size_t shards{1};
+  int shardBits{0};
+  while (shards < blocks * 4 && shards < MAX_SHARDS) {
+    shards *= 2;
+    ++shardBits;
+  }
+  const auto shardOf = [shardBits](uint64_t hash) {
+    return shardBits == 0 ? size_t{0} : hash >> (64 - shardBits);
+  };
+
+  // Hash every corner once and count how many each block sends to a shard.
+  std::vector<uint64_t> hashes(cornerCount);
+  std::vector<size_t> bucketOffsets(blocks * shards, 0);
+  parallelFor(
+      blocks,
+      [&](size_t block) {
+        const auto [begin, end] = partRange(cornerCount, blocks, block);
+        size_t* counts = &bucketOffsets[block * shards];
+        for (size_t c{begin}; c < end; ++c) {
+          hashes[c] = hashPackedVertex(packVertex(corners[c]));
+          ++counts[shardOf(hashes[c])];
+        }
+      },
+      threadCount);
+
+  // Shard-major, block-minor offsets keep each shard's corners in order.
+  std::vector<size_t> shardBegin(shards + 1, 0);
+  size_t offset{0};
+  for (size_t shard{0}; shard < shards; ++shard) {
+    shardBegin[shard] = offset;
+    for (size_t block{0}; block < blocks; ++block) {
+      const size_t count = bucketOffsets[block * shards + shard];
+      bucketOffsets[block * shards + shard] = offset;
+      offset += count;
+    }
+  }
+  shardBegin[shards] = offset;
+
+  std::vector<uint32_t> order(cornerCount);
+  parallelFor(
+      blocks,
+      [&](size_t block) {
+        const auto [begin, end] = partRange(cornerCount, blocks, block);
+        size_t* offsets = &bucketOffsets[block * shards];
+        for (size_t c{begin}; c < end; ++c) {
+          order[offsets[shardOf(hashes[c])]++] = static_cast<uint32_t>(c);
+        }
+      },
+      threadCount);
+
+  // Map every corner to the first corner holding the same vertex.
+  std::vector<uint32_t> firstCorner(cornerCount);
+  parallelFor(
+      shards,
+      [&](size_t shard) {
+        VertexWeldTable table(shardBegin[shard + 1] - shardBegin[shard]);
+        for (size_t k{shardBegin[shard]}; k < shardBegin[shard + 1]; ++k) {
+          const uint32_t c = order[k];
+          firstCorner[c] =
+              table.findOrInsert(corners[c], hashes[c], c, corners.data());
+        }
+      },
+      threadCount);
+
+  // Number the first corners in corner order.
+  std::vector<size_t> blockBase(blocks + 1, 0);
+  parallelFor(
+      blocks,
+      [&](size_t block) {
+        const auto [begin, end] = partRange(cornerCount, blocks, block);
+        size_t unique{0};
+        for (size_t c{begin}; c < end; ++c) {
+          unique += firstCorner[c] == c ? 1 : 0;
+        }
+        blockBase[block + 1] = unique;
+      },
+      threadCount);
+  for (size_t block{0}; block < blocks; ++block) {
+    blockBase[block + 1] += blockBase[block];
+  }
+
+  const size_t vertexBase = vertices.size();
+  const size_t indexBase = indices.size();
+  if (vertexBase + blockBase[blocks] >= UINT32_MAX) {
+    throw std::runtime_error("too many vertices to index with 32 bits!");
+  }
+  vertices.resize(vertexBase + blockBase[blocks]);
+  indices.resize(indexBase + cornerCount);
+
+  // `order` is no longer needed and becomes the final index of each first
+  // corner.
+  std::vector<uint32_t>& finalIndex = order;
+  parallelFor(
+      blocks,
+      [&](size_t block) {
+        const auto [begin, end] = partRange(cornerCount, blocks, block);
+        size_t next = vertexBase + blockBase[block];
+        for (size_t c{begin}; c < end; ++c) {
+          if (firstCorner[c] == c) {
+            vertices[next] = corners[c];
+            finalIndex[c] = static_cast<uint32_t>(next++);
+          }
+        }
+      },
+      threadCount);
+  parallelFor(
+      blocks,
+      [&](size_t block) {
+        const auto [begin, end] = partRange(cornerCount, blocks, block);
+        for (size_t c{begin}; c < end; ++c) {
+          indices[indexBase + c] = finalIndex[firstCorner[c]];
+        }
+      },
+      threadCount);
+}
+
+}  // namespace
+
+VertexWeldTable::VertexWeldTable(size_t expectedVertices) {
+  const size_t capacity = capacityFor(expectedVertices);
+  slots_.assign(capacity, Slot{0, EMPTY});
+  mask_ = capacity - 1;
+}
+
+uint32_t VertexWeldTable::weld(const Vertex& vertex,
+                               std::vector<Vertex>& vertices) {
+  if (vertices.size() >= EMPTY) {
+    throw std::runtime_error("too many vertices to index with 32 bits!");
+  }
+  const auto next = static_cast<uint32_t>(vertices.size());
+  const uint32_t id = findOrInsert(vertex, hashPackedVertex(packVertex(vertex)),
+                                   next, vertices.data());
+  if (id == next) {
+    vertices.push_back(vertex);
+  }
+  return id;
+}
+
+uint32_t VertexWeldTable::findOrInsert(const Vertex& vertex, uint64_t hash,
+                                       uint32_t id, const Vertex* storage) {
+  if ((count_ + 1) * 2 > slots_.size()) {
+    rehash(slots_.size() * 2, storage);
+  }
+
+  const PackedVertex key = packVertex(vertex);
+  const auto tag = static_cast<uint32_t>(hash >> 32);
+  size_t slot = hash & mask_;
+  while (slots_[slot].id != EMPTY) {
+    if (slots_[slot].tag == tag && packVertex(storage[slots_[slot].id]) == key) {
+      return slots_[slot].id;
+    }
+    slot = (slot + 1) & mask_;
+  }
+
+  slots_[slot] = Slot{tag, id};
+  ++count_;
+  return id;
+}
+
+void VertexWeldTable::rehash(size_t capacity, const Vertex* storage) {
+  std::vector<Slot> old(capacity, Slot{0, EMPTY});
+  old.swap(slots_);
+  mask_ = capacity - 1;
+  for (const Slot& entry : old) {
+    if (entry.id == EMPTY) {
+      continue;
+    }
+    size_t slot = hashPackedVertex(packVertex(storage[entry.id])) & mask_;
+    while (slots_[slot].id != EMPTY) {
+      slot = (slot + 1) & mask_;
+    }
+    slots_[slot] = entry;
+  }
+}
+
+void weldVertices(const std::vector<Vertex>& corners,
+                  std::vector<Vertex>& vertices,
+                  std::vector<uint32_t>& indices, unsigned int threadCount) {
+  const bool parallel =
+      threadCount > 1 ||
+      (threadCount == 0 && corners.size() >= MIN_PARALLEL_CORNERS &&
+       workerCount() > 1);
+  if (parallel) {
+    weldSharded(corners, vertices, indices, threadCount);
+  } else {
+    weldSerial(corners, vertices, indices);
+  }
+}
@@ -0,0 +1,55 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_VERTEXWELDER_HPP
+#define VULKANTEST_VERTEXWELDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.hpp"
+
+// Flat open-addressing table (linear probing) from vertex to an id, normally
+// its index in the welded vertex array. Keys are compared bit for bit after
+// mapping -0.0 to +0.0, so the table agrees with Vertex::operator== for every
+// finite vertex.
+class VertexWeldTable {
+ public:
+  // Sized so that `expectedVertices` unique vertices fit without a rehash.
+  explicit VertexWeldTable(size_t expectedVertices);
+
+  // One probe sequence per call: returns the index of an equal vertex already
+  // in `vertices`, or appends `vertex` and returns the new index.
+  uint32_t weld(const Vertex& vertex, std::vector<Vertex>& vertices);
+
+  // Returns the id of an equal vertex in the table, or inserts `id` and
+  // returns it. `storage[i]` must be the vertex for every id i in the table.
+  uint32_t findOrInsert(const Vertex& vertex, uint64_t hash, uint32_t id,
+                        const Vertex* storage);
+
+ private:
+  struct Slot {
+    uint32_t tag;
+    uint32_t id;
+  };
+  static constexpr uint32_t EMPTY = UINT32_MAX;
+
+  std::vector<Slot> slots_;
+  size_t mask_{0};
+  size_t count_{0};
+
+  void rehash(size_t capacity, const Vertex* storage);
+};
+
+// Collapses identical corners into one vertex each and appends the indices.
+// Vertices are numbered in order of first use. Large inputs are welded in
+// parallel (or whenever threadCount > 1); the result is identical to the
+// serial weld, so cooked files do not depend on the machine that made them.
+void weldVertices(const std::vector<Vertex>& corners,
+                  std::vector<Vertex>& vertices,
+                  std::vector<uint32_t>& indices,
+                  unsigned int threadCount = 0);
+
+#endif  // VULKANTEST_VERTEXWELDER_HPP
@@ -0,0 +1,258 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "VirtualTexture.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#include "BlockCompression.hpp"
+#include "MipChain.hpp"
+#include "Parallel.hpp"
+#include "Texture.hpp"
+
+namespace {
+
+constexpr uint64_t VIRTUAL_TEXTURE_ALIGNMENT = 16;
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+void writePadding(std::ofstream& out, uint64_t from, uint64_t to) {
+  static constexpr char zeros[VIRTUAL_TEXTURE_ALIGNMENT]{};
+  out.write(zeros, static_cast<std::streamsize>(to - from));
+}
+
+// Copies page (pageX, pageY) of a level with its border into `page`, which
+// holds VIRTUAL_PAGE_STRIDE^2 RGBA8 texels. Texels beyond the level repeat
+// its edge, as a clamped sampler would.
+void extractPage(const uint8_t* level, uint32_t width, uint32_t height,
+                 uint32_t pageX, uint32_t pageY, uint8_t* page) {
+  const auto clampTexel = [](int64_t texel, uint32_t extent) {
+    return static_cast<uint32_t>(
+        std::clamp<int64_t>(texel, 0, int64_t{extent} - 1));
+  };
+  const int64_t originX =
+      int64_t{pageX} * VIRTUAL_PAGE_SIZE - VIRTUAL_PAGE_BORDER;
+  const int64_t originY =
+      int64_t{pageY} * VIRTUAL_PAGE_SIZE - VIRTUAL_PAGE_BORDER;
+  for (uint32_t y{0}; y < VIRTUAL_PAGE_STRIDE; ++y) {
+    const uint8_t* row =
+        level + size_t{clampTexel(originY + y, height)} * width * 4;
+    uint8_t* out = page + size_t{y} * VIRTUAL_PAGE_STRIDE * 4;
+    for (uint32_t x{0}; x < VIRTUAL_PAGE_STRIDE; ++x) {
+      memcpy(out + size_t{x} * 4,
+             row + size_t{clampTexel(originX + x, width)} * 4, 4);
+    }
+  }
+}
+
+}  // namespace
+
+std::vector<VirtualLevel> virtualLevels(uint32_t width, uint32_t height) {
+  std::vector<VirtualLevel> levels;
+  uint32_t firstPage{0};
+  for (uint32_t i{0};; ++i) {
+    VirtualLevel level{};
+    level.width = mipExtent(width, i);
+    level.height = mipExtent(height, i);
+    level.pagesX = (level.width + VIRTUAL_PAGE_SIZE - 1) / VIRTUAL_PAGE_SIZE;
+    level.pagesY = (level.height + VIRTUAL_PAGE_SIZE - 1) / VIRTUAL_PAGE_SIZE;
+    level.firstPage = firstPage;
+    firstPage += level.pagesX * level.pagesY;
+    levels.push_back(level);
+    if (level.pagesX == 1 && level.pagesY == 1) {
+      return levels;
+    }
+  }
+}
+
+bool VirtualTextureFile::open(const std::string& path,
+                              const std::string& sourcePath) {
+  close();
+  if (!openStampedFile(file_, path, sourcePath,
+                       offsetof(VirtualTextureHeader, source))) {
+    return false;
+  }
+  data_ = file_.data();
+  size_ = file_.size();
+  header_ = reinterpret_cast<const VirtualTextureHeader*>(data_);
+  if (!validateLayout()) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+bool VirtualTextureFile::open(const uint8_t* data, size_t size) {
+  close();
+  data_ = data;
+  size_ = size;
+  header_ = reinterpret_cast<const VirtualTextureHeader*>(data_);
+  if (!validateLayout()) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+void VirtualTextureFile::close() {
+  header_ = nullptr;
+  data_ = nullptr;
+  size_ = 0;
+  file_.close();
+}
+
+VkFormat VirtualTextureFile::format() const {
+  return static_cast<VkFormat>(header_->format);
+}
+
+std::vector<VirtualLevel> VirtualTextureFile::levels() const {
+  const auto* levels =
+      reinterpret_cast<const VirtualLevel*>(data_ + header_->levelOffset);
+  return {levels, levels + header_->levelCount};
+}
+
+const uint8_t* VirtualTextureFile::page(uint32_t page) const {
+  return data_ + header_->dataOffset + uint64_t{page} * header_->pageBytes;
+}
+
+// The levels have to be exactly the chain virtualLevels() computes, since
+// the shader finds pages from the extents alone.
+bool VirtualTextureFile::validateLayout() const {
+  if (size_ < sizeof(VirtualTextureHeader)) {
+    return false;
+  }
+  if (header_->magic != VIRTUAL_TEXTURE_MAGIC ||
+      header_->version != VIRTUAL_TEXTURE_VERSION || header_->width == 0 ||
+      header_->height == 0 || header_->levelCount == 0 ||
+      header_->levelCount > VIRTUAL_MAX_LEVELS) {
+    return false;
+  }
+  const auto format = static_cast<VkFormat>(header_->format);
+  const uint64_t pageBytes = textureLevelSize(format, VIRTUAL_PAGE_STRIDE,
+                                              VIRTUAL_PAGE_STRIDE);
+  const uint64_t levelBytes =
+      uint64_t{header_->levelCount} * sizeof(VirtualLevel);
+  if (pageBytes == 0 || header_->pageBytes != pageBytes ||
+      header_->levelOffset % alignof(VirtualLevel) != 0 ||
+      header_->dataOffset % VIRTUAL_TEXTURE_ALIGNMENT != 0 ||
+      header_->levelOffset > size_ ||
+      levelBytes > size_ - header_->levelOffset ||
+      header_->dataOffset > size_ ||
+      uint64_t{header_->pageCount} * pageBytes > size_ - header_->dataOffset) {
+    return false;
+  }
+  const std::vector<VirtualLevel> expected =
+      virtualLevels(header_->width, header_->height);
+  if (expected.size() != header_->levelCount ||
+      expected.back().firstPage + 1 != header_->pageCount) {
+    return false;
+  }
+  const auto* levels =
+      reinterpret_cast<const VirtualLevel*>(data_ + header_->levelOffset);
+  for (size_t i{0}; i < expected.size(); ++i) {
+    if (memcmp(&levels[i], &expected[i], sizeof(VirtualLevel)) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool VirtualTextureFile::write(const std::string& path,
+                               const std::string& sourcePath,
+                               const uint8_t* pixels, uint32_t width,
+                               uint32_t height, VkFormat format,
+                               unsigned int threadCount) {
+  const std::vector<VirtualLevel> levels = virtualLevels(width, height);
+  const uint64_t pageBytes =
+      textureLevelSize(format, VIRTUAL_PAGE_STRIDE, VIRTUAL_PAGE_STRIDE);
+  if (pageBytes == 0 || levels.size() > VIRTUAL_MAX_LEVELS) {
+    return false;
+  }
+
+  VirtualTextureHeader header{};
+  header.magic = VIRTUAL_TEXTURE_MAGIC;
+  header.version = VIRTUAL_TEXTURE_VERSION;
+  header.source = stampSource(sourcePath);
+  header.format = static_cast<uint32_t>(format);
+  header.width = width;
+  header.height = height;
+  header.levelCount = static_cast<uint32_t>(levels.size());
+  header.pageCount = levels.back().firstPage + 1;
+  header.pageBytes = static_cast<uint32_t>(pageBytes);
+  header.levelOffset =
+      alignUp(sizeof(VirtualTextureHeader), VIRTUAL_TEXTURE_ALIGNMENT);
+  const uint64_t levelBytes = levels.size() * sizeof(VirtualLevel);
+  header.dataOffset =
+      alignUp(header.levelOffset + levelBytes, VIRTUAL_TEXTURE_ALIGNMENT);
+
+  // Written next to the destination and renamed, like the caches.
+  const std::string tempPath = path + ".tmp";
+  {
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writePadding(out, sizeof(header), header.levelOffset);
+    out.write(reinterpret_cast<const char*>(levels.data()),
+              static_cast<std::streamsize>(levelBytes));
+    writePadding(out, header.levelOffset + levelBytes, header.dataOffset);
+
+    // Each level is filtered from the one before, which is dropped as soon
+    // as its pages are written.
+    std::vector<uint8_t> current;
+    std::vector<uint8_t> next;
+    const uint8_t* level = pixels;
+    std::vector<uint8_t> row;
+    for (size_t i{0}; i < levels.size(); ++i) {
+      const VirtualLevel& info = levels[i];
+      row.resize(info.pagesX * pageBytes);
+      for (uint32_t pageY{0}; pageY < info.pagesY; ++pageY) {
+        parallelFor(
+            info.pagesX,
+            [&](size_t pageX) {
+              std::vector<uint8_t> texels(size_t{VIRTUAL_PAGE_STRIDE} *
+                                          VIRTUAL_PAGE_STRIDE * 4);
+              extractPage(level, info.width, info.height,
+                          static_cast<uint32_t>(pageX), pageY,
+                          texels.data());
+              uint8_t* page = row.data() + pageX * pageBytes;
+              if (isBlockCompressed(format)) {
+                compressBlocks(format, texels.data(), VIRTUAL_PAGE_STRIDE,
+                               VIRTUAL_PAGE_STRIDE, page, 1);
+              } else {
+                memcpy(page, texels.data(), texels.size());
+              }
+            },
+            threadCount);
+        out.write(reinterpret_cast<const char*>(row.data()),
+                  static_cast<std::streamsize>(row.size()));
+      }
+      if (i + 1 < levels.size()) {
+        next.resize(size_t{levels[i + 1].width} * levels[i + 1].height * 4);
+        downsampleSrgba(level, info.width, info.height, next.data(),
+                        MipKernel::Simd, threadCount);
+        std::swap(current, next);
+        level = current.data();
+      }
+    }
+    if (!out.good()) {
+      return false;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tempPath, path, ec);
+  if (ec) {
+    std::filesystem::remove(tempPath, ec);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,101 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef VULKANTEST_VIRTUALTEXTURE_HPP
+#define VULKANTEST_VIRTUALTEXTURE_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "SourceStamp.hpp"
+
+constexpr uint32_t VIRTUAL_TEXTURE_MAGIC = 0x47505456;  // "VTPG"
+constexpr uint32_t VIRTUAL_TEXTURE_VERSION = 1;
+// Texels of a page, and of the border around them copied from the
+// neighbouring pages, so that bilinear filtering near a page edge never reads
+// another page's slot in the atlas. The stride stays a multiple of the 4x4
+// block size.
+constexpr uint32_t VIRTUAL_PAGE_SIZE = 128;
+constexpr uint32_t VIRTUAL_PAGE_BORDER = 4;
+constexpr uint32_t VIRTUAL_PAGE_STRIDE =
+    VIRTUAL_PAGE_SIZE + 2 * VIRTUAL_PAGE_BORDER;
+// Matches the level array in shader.frag.glsl; enough for 4M texels a side.
+constexpr uint32_t VIRTUAL_MAX_LEVELS = 16;
+
+// One level of the virtual mip chain, split into pagesX x pagesY pages that
+// are numbered row by row from firstPage.
+struct VirtualLevel {
+  uint32_t width;
+  uint32_t height;
+  uint32_t pagesX;
+  uint32_t pagesY;
+  uint32_t firstPage;
+};
+
+// The chain of a width x height texture, from the full size down to the
+// first level that fits into a single page. Coarser levels are not paged;
+// the last page stands in for them.
+std::vector<VirtualLevel> virtualLevels(uint32_t width, uint32_t height);
+
+// On-disk layout of a tiled texture: this header, levelCount VirtualLevel
+// records and pageCount pages of pageBytes each at dataOffset, in page order.
+// Every page is VIRTUAL_PAGE_STRIDE texels square in `format`, so any page
+// can be read with one copy without touching the others.
+struct VirtualTextureHeader {
+  uint32_t magic;
+  uint32_t version;
+  SourceStamp source;
+  uint32_t format;  // VkFormat
+  uint32_t width;
+  uint32_t height;
+  uint32_t levelCount;
+  uint32_t pageCount;
+  uint32_t pageBytes;
+  uint64_t levelOffset;
+  uint64_t dataOffset;
+};
+
+class VirtualTextureFile {
+ public:
+  // Maps path and validates it against sourcePath. Returns false if the file
+  // is missing, malformed, from another version or stale.
+  bool open(const std::string& path, const std::string& sourcePath);
+  // Uses a file that lives in memory owned by the caller, such as an asset
+  // pack entry, which has to stay valid until close().
+  bool open(const uint8_t* data, size_t size);
+  void close();
+
+  [[nodiscard]] bool isOpen() const { return header_ != nullptr; }
+  [[nodiscard]] VkFormat format() const;
+  [[nodiscard]] uint32_t width() const { return header_->width; }
+  [[nodiscard]] uint32_t height() const { return header_->height; }
+  [[nodiscard]] std::vector<VirtualLevel> levels() const;
+  [[nodiscard]] uint32_t pageCount() const { return header_->pageCount; }
+  [[nodiscard]] uint32_t pageBytes() const { return header_->pageBytes; }
+  // Pages are only faulted in from disk when read.
+  [[nodiscard]] const uint8_t* page(uint32_t page) const;
+
+  // Tiles an RGBA8 sRGB image into pages of every level in `format`, either
+  // VK_FORMAT_R8G8B8A8_SRGB or a BC format. Works through the chain one row
+  // of pages at a time, so memory stays at about 1.25 times the image.
+  // Returns false if the file could not be written.
+  static bool write(const std::string& path, const std::string& sourcePath,
+                    const uint8_t* pixels, uint32_t width, uint32_t height,
+                    VkFormat format, unsigned int threadCount = 0);
+
+ private:
+  MappedFile file_;
+  const uint8_t* data_{nullptr};
+  size_t size_{0};
+  const VirtualTextureHeader* header_{nullptr};
+
+  bool validateLayout() const;
+};
+
+#endif  // VULKANTEST_VIRTUALTEXTURE_HPP
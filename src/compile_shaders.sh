@@ -1,4 +1,10 @@
 #!/bin/sh
 
 glslangValidator -V shader.vert.glsl -o vert.spv
+glslangValidator -V -DCOMPACT_VERTEX shader.vert.glsl -o vert_compact.spv
+glslangValidator -V -DPOSITION_ONLY shader.vert.glsl -o vert_depth.spv
+glslangValidator -V -DPOSITION_ONLY -DCOMPACT_VERTEX shader.vert.glsl -o vert_depth_compact.spv
 glslangValidator -V shader.frag.glsl -o frag.spv
+glslangValidator -V -DTEXTURE_TABLE shader.frag.glsl -o frag_table.spv
+glslangValidator -V -DVIRTUAL_TEXTURE shader.frag.glsl -o frag_virtual.spv
+glslangValidator -V cull.comp.glsl -o cull.spv
@@ -0,0 +1,91 @@
+#version 450 core
+#extension GL_ARB_separate_shader_objects : enable
+
+// One invocation per meshlet. Meshlets that pass the frustum and backface
+// cone tests append an indexed draw to the compacted draw list; the list was
+// zeroed beforehand, so the unused tail draws nothing.
+layout(local_size_x = 64) in;
+
+layout(binding = 0) uniform UniformBufferObject {
+  mat4 model;
+  mat4 view;
+  mat4 proj;
+  vec4 positionScale;
+  vec4 positionOffset;
+  vec4 cameraPosition;
+} ubo;
+
+struct Meshlet {
+  vec4 sphere;
+  vec4 coneApex;
+  vec4 coneAxis;
+  uint firstIndex;
+  uint indexCount;
+  int vertexOffset;
+  uint part;
+};
+
+layout(std430, binding = 1) readonly buffer Meshlets {
+  Meshlet meshlets[];
+};
+
+struct DrawCommand {
+  uint indexCount;
+  uint instanceCount;
+  uint firstIndex;
+  int vertexOffset;
+  uint firstInstance;
+};
+
+layout(std430, binding = 2) buffer Draws {
+  uint drawCount;
+  uint reserved[3];
+  DrawCommand draws[];
+};
+
+// The meshlets of the level of detail being drawn.
+layout(push_constant) uniform Params {
+  uint firstMeshlet;
+  uint meshletCount;
+} params;
+
+bool insideFrustum(vec3 center, float radius) {
+  // Gribb/Hartmann planes of the clip space volume, with 0 <= z <= w.
+  mat4 clip = transpose(ubo.proj * ubo.view);
+  vec4 planes[6] = vec4[6](clip[3] + clip[0], clip[3] - clip[0],
+                           clip[3] + clip[1], clip[3] - clip[1], clip[2],
+                           clip[3] - clip[2]);
+  for (int i = 0; i < 6; ++i) {
+    if (dot(planes[i].xyz, center) + planes[i].w <
+        -radius * length(planes[i].xyz)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void main() {
+  uint id = gl_GlobalInvocationID.x;
+  if (id >= params.meshletCount) {
+    return;
+  }
+  Meshlet meshlet = meshlets[params.firstMeshlet + id];
+
+  vec3 center = (ubo.model * vec4(meshlet.sphere.xyz, 1.0)).xyz;
+  float radius = meshlet.sphere.w * length(ubo.model[0].xyz);
+  if (!insideFrustum(center, radius)) {
+    return;
+  }
+
+  vec3 apex = (ubo.model * vec4(meshlet.coneApex.xyz, 1.0)).xyz;
+  vec3 axis = mat3(ubo.model) * meshlet.coneAxis.xyz;
+  if (dot(normalize(apex - ubo.cameraPosition.xyz), axis) >=
+      meshlet.coneAxis.w) {
+    return;
+  }
+
+  uint slot = atomicAdd(drawCount, 1);
+  // The part is drawn as the instance, which selects its transform.
+  draws[slot] = DrawCommand(meshlet.indexCount, 1, meshlet.firstIndex,
+                            meshlet.vertexOffset, meshlet.part);
+}
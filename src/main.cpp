@@ -1,9 +1,8 @@
 #include "Application.hpp"
 
-int main() {
-  Application app;
-
+int main(int argc, char* argv[]) {
   try {
+    Application app(parseOptions(argc, argv));
     app.run();
   } catch (const std::exception& e) {
     std::cerr << e.what() << '\n';
@@ -0,0 +1,70 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+// Builds an asset pack from loose files:
+//   vulkantest_pack <pack> <asset dir> <name>...
+// Each name is looked up relative to the asset directory and stored under
+// that name, e.g. "models/viking_room.obj.meshcache".
+
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AssetPack.hpp"
+#include "MappedFile.hpp"
+
+namespace {
+
+// Cooked meshes, textures and virtual texture pages are used in place and
+// images are compressed already; the rest (model sources, SPIR-V) shrinks
+// well.
+AssetCompression chooseCompression(const std::string& name) {
+  const std::string extension =
+      std::filesystem::path(name).extension().string();
+  if (extension == ".meshcache" || extension == ".texturecache" ||
+      extension == ".atlastile" || extension == ".vtpages" ||
+      extension == ".png" || extension == ".jpg") {
+    return AssetCompression::None;
+  }
+  return AssetCompression::Zstd;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc < 4) {
+    std::cerr << "usage: " << argv[0] << " <pack> <asset dir> <name>...\n";
+    return EXIT_FAILURE;
+  }
+  try {
+    const std::string packPath = argv[1];
+    const std::filesystem::path assetDir = argv[2];
+    std::vector<AssetSource> sources;
+    for (int i{3}; i < argc; ++i) {
+      AssetSource source;
+      source.name = argv[i];
+      MappedFile file;
+      if (!file.open((assetDir / source.name).string())) {
+        std::cerr << "failed to read " << source.name << '\n';
+        return EXIT_FAILURE;
+      }
+      source.data.assign(file.data(), file.data() + file.size());
+      source.compression = chooseCompression(source.name);
+      sources.push_back(std::move(source));
+    }
+    if (!AssetPack::write(packPath, sources)) {
+      std::cerr << "failed to write " << packPath << '\n';
+      return EXIT_FAILURE;
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -1,13 +1,114 @@
 #version 450 core
 #extension GL_ARB_separate_shader_objects : enable
+#ifdef TEXTURE_TABLE
+#extension GL_EXT_nonuniform_qualifier : enable
+#endif
 
-layout(binding = 1) uniform sampler2D texSampler;
+#ifdef VIRTUAL_TEXTURE
+layout(binding = 0) uniform UniformBufferObject {
+  mat4 model;
+  mat4 view;
+  mat4 proj;
+  vec4 positionScale;
+  vec4 positionOffset;
+  vec4 cameraPosition;
+  uint feedbackStamp;
+} ubo;
+
+// Page slots of VIRTUAL_PAGE_STRIDE texels, see Application.hpp.
+layout(binding = 2) uniform sampler2D pageAtlas;
+
+// PageTableHeader, followed by PageCache::table().
+layout(std430, binding = 3) readonly buffer PageTable {
+  uint levelCount;
+  uint slotsPerRow;
+  uint atlasSize;
+  uint padding;
+  uvec4 levels[16];  // width, height, pagesX, firstPage
+  uint entries[];
+} pageTable;
+
+// One stamp per page; the pages this frame sampled hold ubo.feedbackStamp.
+layout(std430, binding = 4) writeonly buffer Feedback {
+  uint stamps[];
+} feedback;
+
+const uint PAGE_SIZE = 128;
+const uint PAGE_BORDER = 4;
+const uint PAGE_STRIDE = PAGE_SIZE + 2 * PAGE_BORDER;
+
+uvec2 pagesOf(uvec4 level) {
+  return uvec2(level.z, (level.y + PAGE_SIZE - 1) / PAGE_SIZE);
+}
+
+vec4 sampleVirtual(vec2 uv) {
+  // The level whose texels are about one pixel apart, as the sampler would
+  // choose it without anisotropy.
+  vec2 size = vec2(pageTable.levels[0].xy);
+  vec2 dx = dFdx(uv * size);
+  vec2 dy = dFdy(uv * size);
+  float lod = 0.5 * log2(max(max(dot(dx, dx), dot(dy, dy)), 1.0));
+  uint level = min(uint(lod), pageTable.levelCount - 1);
+  uv = fract(uv);
+
+  uvec4 info = pageTable.levels[level];
+  uvec2 page = min(uvec2(uv * vec2(info.xy)) / PAGE_SIZE, pagesOf(info) - 1);
+  uint id = info.w + page.y * info.z + page.x;
+
+  // One pixel of every 4x4 reports, a different one each frame.
+  uvec2 pixel = uvec2(gl_FragCoord.xy) & 3;
+  if (pixel.x + pixel.y * 4 == ubo.feedbackStamp % 16) {
+    feedback.stamps[id] = ubo.feedbackStamp;
+  }
+
+  // The page itself or its nearest resident ancestor, found the way
+  // PageCache::parent() walks up.
+  uint entry = pageTable.entries[id];
+  uint slot = entry & 0xffff;
+  uint mapped = entry >> 16;
+  uvec4 mappedInfo = pageTable.levels[mapped];
+  uvec2 mappedPage = min(page >> (mapped - level), pagesOf(mappedInfo) - 1);
+  vec2 local = uv * vec2(mappedInfo.xy) - vec2(mappedPage * PAGE_SIZE);
+  local = clamp(local, 0.5 - float(PAGE_BORDER),
+                float(PAGE_SIZE + PAGE_BORDER) - 0.5);
+
+  uvec2 origin = uvec2(slot % pageTable.slotsPerRow,
+                       slot / pageTable.slotsPerRow) * PAGE_STRIDE;
+  vec2 atlasUv = (vec2(origin + PAGE_BORDER) + local) /
+                 float(pageTable.atlasSize);
+  return textureLod(pageAtlas, atlasUv, 0.0);
+}
+#elif defined(TEXTURE_TABLE)
+// The texture table, MAX_BINDLESS_TEXTURES entries of which only the first
+// ubo.textureCount are bound. Fragments of different parts may share a
+// subgroup, so the index is not uniform.
+layout(binding = 1) uniform sampler2D textures[1024];
+#define TEXTURE_INDEX(index) nonuniformEXT(index)
+#else
+// MAX_FIXED_TEXTURES entries, all bound. Every draw is of one part, so the
+// index is uniform within it.
+layout(binding = 1) uniform sampler2D textures[8];
+#define TEXTURE_INDEX(index) (index)
+#endif
 
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) flat in uint fragTexture;
+layout(location = 3) flat in vec4 fragTextureTransform;
 
 layout(location = 0) out vec4 outColor;
 
 void main() {
-  outColor = texture(texSampler, fragTexCoord);
+#ifdef VIRTUAL_TEXTURE
+  outColor = sampleVirtual(fragTexCoord);
+#else
+  // The coordinates repeat within the texture's rectangle of its image, its
+  // tile for atlas textures, so they are wrapped before the transform. The
+  // wrap jumps, so the level comes from the unwrapped coordinates.
+  vec2 scale = fragTextureTransform.xy;
+  vec2 uv = fragTextureTransform.zw + fract(fragTexCoord) * scale;
+  outColor = textureGrad(textures[TEXTURE_INDEX(fragTexture)], uv,
+                         dFdx(fragTexCoord) * scale,
+                         dFdy(fragTexCoord) * scale);
+#endif
 }
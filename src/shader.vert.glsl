@@ -5,17 +5,68 @@ layout(binding = 0) uniform UniformBufferObject {
   mat4 model;
   mat4 view;
   mat4 proj;
+  vec4 positionScale;
+  vec4 positionOffset;
+  vec4 cameraPosition;
+  uint feedbackStamp;
+  uint textureCount;
 } ubo;
 
+#ifdef COMPACT_VERTEX
+// CompactVertex: unorm positions relative to the mesh bounds, half float UVs.
+layout(location = 0) in vec4 inPosition;
+#ifndef POSITION_ONLY
+layout(location = 2) in vec2 inTexCoord;
+#endif
+#else
 layout(location = 0) in vec3 inPosition;
+#ifndef POSITION_ONLY
 layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec2 inTexCoord;
+#endif
+#endif
+// MeshPart, one per instance: the transform from mesh to scene space and
+// the material, which selects the texture.
+layout(location = 3) in mat4 inPartTransform;
+#ifndef POSITION_ONLY
+layout(location = 7) in uint inPartMaterial;
+#endif
+
+#ifndef POSITION_ONLY
+// Per texture of the table, the scale (xy) and offset (zw) that map its
+// texture coordinates, wrapped into [0, 1), into its image: into its tile
+// for atlas textures.
+layout(std430, binding = 5) readonly buffer TextureTransforms {
+  vec4 transforms[];
+};
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) flat out uint fragTexture;
+layout(location = 3) flat out vec4 fragTextureTransform;
+#endif
+
+// The depth pre-pass (POSITION_ONLY) has to produce exactly the depth the
+// main pass tests against.
+invariant gl_Position;
 
 void main() {
-  gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
+#ifdef COMPACT_VERTEX
+  vec3 position =
+      ubo.positionOffset.xyz + inPosition.xyz * ubo.positionScale.xyz;
+#else
+  vec3 position = inPosition;
+#endif
+  gl_Position =
+      ubo.proj * ubo.view * ubo.model * inPartTransform * vec4(position, 1.0);
+#ifndef POSITION_ONLY
+#ifdef COMPACT_VERTEX
+  fragColor = vec3(1.0);
+#else
   fragColor = inColor;
+#endif
+  fragTexture = min(inPartMaterial, ubo.textureCount - 1);
+  fragTextureTransform = transforms[fragTexture];
   fragTexCoord = inTexCoord;
+#endif
 }
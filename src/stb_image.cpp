@@ -2,5 +2,11 @@
 // Created by Michael Wittmann on 14/06/2020.
 //
 
+#include "ImageDecoder.hpp"
+
+// Lets decodeImage() hand the decoder the memory its result goes to.
+#define STBI_MALLOC(size) stbiAllocate(size)
+#define STBI_REALLOC(pointer, size) stbiReallocate(pointer, size)
+#define STBI_FREE(pointer) stbiFree(pointer)
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.hpp"
@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "GeometryCodec.hpp"
+#include "MeshOptimizer.hpp"
+#include "MipChain.hpp"
+#include "ModelLoader.hpp"
+#include "ObjParser.hpp"
+#include "VertexWelder.hpp"
+
+namespace {
+
+const std::string MODEL = std::string(MODELS_DIR) + "/viking_room.obj";
+
+// Writes `copies` side-by-side instances of the model into one OBJ file, so
+// the parsers see a proportionally larger file with distinct vertices.
+std::string scaledModel(int copies) {
+  const auto path = (std::filesystem::temp_directory_path() /
+                     ("viking_room_x" + std::to_string(copies) + ".obj"))
+                        .string();
+  if (std::filesystem::exists(path)) {
+    return path;
+  }
+
+  std::ifstream in(MODEL);
+  std::vector<std::string> lines;
+  int positions{0};
+  int texCoords{0};
+  for (std::string line; std::getline(in, line);) {
+    positions += line.rfind("v ", 0) == 0 ? 1 : 0;
+    texCoords += line.rfind("vt ", 0) == 0 ? 1 : 0;
+    lines.push_back(line);
+  }
+
+  std::ofstream out(path);
+  char buffer[128];
+  for (int copy{0}; copy < copies; ++copy) {
+    for (const auto& line : lines) {
+      std::istringstream tokens(line);
+      std::string type;
+      tokens >> type;
+      if (type == "v") {
+        float x{0.0f};
+        float y{0.0f};
+        float z{0.0f};
+        tokens >> x >> y >> z;
+        std::snprintf(buffer, sizeof(buffer), "v %f %f %f\n",
+                      static_cast<double>(x + 2.0f * static_cast<float>(copy)),
+                      static_cast<double>(y), static_cast<double>(z));
+        out << buffer;
+      } else if (type == "f") {
+        out << 'f';
+        for (std::string corner; tokens >> corner;) {
+          const auto slash = corner.find('/');
+          const int position = std::atoi(corner.c_str()) + copy * positions;
+          const int texCoord = std::atoi(corner.c_str() + slash + 1) +
+                               copy * texCoords;
+          out << ' ' << position << '/' << texCoord;
+        }
+        out << '\n';
+      } else if (type == "vt") {
+        out << line << '\n';
+      }
+    }
+  }
+  return path;
+}
+
+// The welding loop loadModel() used before the flat table, kept as a baseline.
+void weldWithUnorderedMap(const std::vector<Vertex>& corners,
+                          std::vector<Vertex>& vertices,
+                          std::vector<uint32_t>& indices) {
+  std::unordered_map<Vertex, uint32_t> uniqueVertices{};
+  for (const auto& vertex : corners) {
+    if (uniqueVertices.count(vertex) == 0) {
+      uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
+      vertices.push_back(vertex);
+    }
+    indices.push_back(uniqueVertices[vertex]);
+  }
+}
+
+// The mip loop cookTexture() used before the vector kernels: one level at a
+// time from 8-bit texels, encoding every texel with std::pow. Kept as the
+// baseline, like a linear blit of the sRGB image.
+void downsampleWithPow(const uint8_t* source, uint32_t width, uint32_t height,
+                       uint8_t* destination) {
+  const auto decode = [](uint8_t value) {
+    const float c = static_cast<float>(value) / 255.0f;
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+  };
+  const uint32_t halfWidth = mipExtent(width, 1);
+  const uint32_t halfHeight = mipExtent(height, 1);
+  for (uint32_t y{0}; y < halfHeight; ++y) {
+    const uint8_t* row0 =
+        source + size_t{std::min(2 * y, height - 1)} * width * 4;
+    const uint8_t* row1 =
+        source + size_t{std::min(2 * y + 1, height - 1)} * width * 4;
+    uint8_t* out = destination + size_t{y} * halfWidth * 4;
+    for (uint32_t x{0}; x < halfWidth; ++x) {
+      const size_t x0 = size_t{std::min(2 * x, width - 1)} * 4;
+      const size_t x1 = size_t{std::min(2 * x + 1, width - 1)} * 4;
+      for (size_t c{0}; c < 3; ++c) {
+        const float linear =
+            (decode(row0[x0 + c]) + decode(row0[x1 + c]) +
+             decode(row1[x0 + c]) + decode(row1[x1 + c])) *
+            0.25f;
+        const float encoded =
+            linear <= 0.0031308f
+                ? linear * 12.92f
+                : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+        out[x * 4 + c] = static_cast<uint8_t>(
+            std::clamp(encoded, 0.0f, 1.0f) * 255.0f + 0.5f);
+      }
+      const unsigned int alpha = row0[x0 + 3] + row0[x1 + 3] + row1[x0 + 3] +
+                                 row1[x1 + 3];
+      out[x * 4 + 3] = static_cast<uint8_t>((alpha + 2) / 4);
+    }
+  }
+}
+
+size_t mipChainWithPow(const std::vector<uint8_t>& pixels, uint32_t width,
+                       uint32_t height) {
+  std::vector<uint8_t> level = pixels;
+  std::vector<uint8_t> next;
+  size_t bytes{0};
+  for (; width > 1 || height > 1;
+       width = mipExtent(width, 1), height = mipExtent(height, 1)) {
+    next.resize(size_t{mipExtent(width, 1)} * mipExtent(height, 1) * 4);
+    downsampleWithPow(level.data(), width, height, next.data());
+    bytes += next.size();
+    std::swap(level, next);
+  }
+  return bytes;
+}
+
+void importAndWeld(const std::string& path, ModelImporter importer) {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  weldVertices(importCorners(path, importer), vertices, indices);
+}
+
+}  // namespace
+
+TEST_CASE("OBJ import: native parser vs Assimp", "[!benchmark][objparser]") {
+  const std::string x10 = scaledModel(10);
+  const std::string x100 = scaledModel(100);
+
+  BENCHMARK("viking_room.obj native") {
+    return parseObj(MODEL).size();
+  };
+  BENCHMARK("viking_room.obj assimp") {
+    return importCornersAssimp(MODEL).size();
+  };
+  BENCHMARK("viking_room x10 native") { return parseObj(x10).size(); };
+  BENCHMARK("viking_room x10 assimp") {
+    return importCornersAssimp(x10).size();
+  };
+  BENCHMARK("viking_room x100 native") { return parseObj(x100).size(); };
+  BENCHMARK("viking_room x100 assimp") {
+    return importCornersAssimp(x100).size();
+  };
+
+  BENCHMARK("viking_room x100 native + weld") {
+    importAndWeld(x100, ModelImporter::Native);
+  };
+  BENCHMARK("viking_room x100 assimp + weld") {
+    importAndWeld(x100, ModelImporter::Assimp);
+  };
+}
+
+TEST_CASE("Vertex welding: flat table vs unordered_map",
+          "[!benchmark][weld]") {
+  const auto corners = parseObj(MODEL);
+  const auto corners100 = parseObj(scaledModel(100));
+
+  BENCHMARK("viking_room.obj unordered_map") {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    weldWithUnorderedMap(corners, vertices, indices);
+    return vertices.size();
+  };
+  BENCHMARK("viking_room.obj flat table") {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    weldVertices(corners, vertices, indices);
+    return vertices.size();
+  };
+  BENCHMARK("viking_room x100 unordered_map") {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    weldWithUnorderedMap(corners100, vertices, indices);
+    return vertices.size();
+  };
+  BENCHMARK("viking_room x100 flat table") {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    weldVertices(corners100, vertices, indices, 1);
+    return vertices.size();
+  };
+  BENCHMARK("viking_room x100 sharded") {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    weldVertices(corners100, vertices, indices);
+    return vertices.size();
+  };
+}
+
+TEST_CASE("Mesh optimization", "[!benchmark][optimizer]") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  weldVertices(parseObj(scaledModel(10)), vertices, indices);
+
+  BENCHMARK("viking_room x10 optimizeMesh") {
+    auto optimizedVertices = vertices;
+    auto optimizedIndices = indices;
+    return optimizeMesh(optimizedVertices, optimizedIndices).after.acmr;
+  };
+}
+
+TEST_CASE("Geometry codec decode", "[!benchmark][codec]") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  weldVertices(parseObj(scaledModel(10)), vertices, indices);
+  optimizeMesh(vertices, indices);
+  const auto vertexStream =
+      encodeVertexStream(vertices.data(), vertices.size(), sizeof(Vertex));
+  const auto indexStream =
+      encodeIndexStream(indices.data(), indices.size(), sizeof(uint32_t));
+  std::cout << "viking_room x10: vertices " << vertices.size() * sizeof(Vertex)
+            << " -> " << vertexStream.size() << " bytes, indices "
+            << indices.size() * sizeof(uint32_t) << " -> "
+            << indexStream.size() << " bytes\n";
+
+  std::vector<Vertex> decodedVertices(vertices.size());
+  std::vector<uint32_t> decodedIndices(indices.size());
+  BENCHMARK("viking_room x10 memcpy") {
+    std::memcpy(decodedVertices.data(), vertices.data(),
+                vertices.size() * sizeof(Vertex));
+    std::memcpy(decodedIndices.data(), indices.data(),
+                indices.size() * sizeof(uint32_t));
+    return decodedIndices.back();
+  };
+  BENCHMARK("viking_room x10 decode, 1 thread") {
+    return decodeVertexStream(vertexStream.data(), vertexStream.size(),
+                              decodedVertices.data(), vertices.size(),
+                              sizeof(Vertex), 1) &&
+           decodeIndexStream(indexStream.data(), indexStream.size(),
+                             decodedIndices.data(), indices.size(),
+                             sizeof(uint32_t), 1);
+  };
+  BENCHMARK("viking_room x10 decode, all threads") {
+    return decodeVertexStream(vertexStream.data(), vertexStream.size(),
+                              decodedVertices.data(), vertices.size(),
+                              sizeof(Vertex)) &&
+           decodeIndexStream(indexStream.data(), indexStream.size(),
+                             decodedIndices.data(), indices.size(),
+                             sizeof(uint32_t));
+  };
+}
+
+TEST_CASE("Mip chain generation", "[!benchmark][mipchain]") {
+  constexpr uint32_t extent = 2048;
+  std::mt19937 random(3);
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::vector<uint8_t> pixels(size_t{extent} * extent * 4);
+  for (uint8_t& value : pixels) {
+    value = static_cast<uint8_t>(byte(random));
+  }
+
+  BENCHMARK("2048x2048 8-bit levels with pow") {
+    return mipChainWithPow(pixels, extent, extent);
+  };
+  BENCHMARK("2048x2048 scalar, 1 thread") {
+    return cookTexture(pixels.data(), extent, extent, MipKernel::Scalar, 1)
+        .data.size();
+  };
+  BENCHMARK("2048x2048 SIMD, 1 thread") {
+    return cookTexture(pixels.data(), extent, extent, MipKernel::Simd, 1)
+        .data.size();
+  };
+  BENCHMARK("2048x2048 SIMD, all threads") {
+    return cookTexture(pixels.data(), extent, extent).data.size();
+  };
+}
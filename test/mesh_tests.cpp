@@ -0,0 +1,1579 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "AssetPack.hpp"
+#include "BlockCompression.hpp"
+#include "CompactVertex.hpp"
+#include "FileWatcher.hpp"
+#include "GeometryCodec.hpp"
+#include "IndexSplitter.hpp"
+#include "MappedFile.hpp"
+#include "MemoryUsage.hpp"
+#include "MeshCache.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshSimplifier.hpp"
+#include "MeshletBuilder.hpp"
+#include "MipChain.hpp"
+#include "ModelLoader.hpp"
+#include "ObjParser.hpp"
+#include "PageCache.hpp"
+#include "PageLoader.hpp"
+#include "ReleaseQueue.hpp"
+#include "SceneBuilder.hpp"
+#include "SplitVertex.hpp"
+#include "TaskGraph.hpp"
+#include "TextureArray.hpp"
+#include "TextureAtlas.hpp"
+#include "TextureCache.hpp"
+#include "VertexWelder.hpp"
+#include "VirtualTexture.hpp"
+
+namespace {
+
+std::string tempPath(const std::string& name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+void writeText(const std::string& path, const std::string& text) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out << text;
+}
+
+std::vector<Vertex> quadVertices() {
+  return {{{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}},
+          {{1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {1.0f, 0.0f}},
+          {{1.0f, 1.0f, 0.5f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f}},
+          {{0.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f}}};
+}
+
+// A size x size grid of quads with its triangles in random order.
+void shuffledGrid(int size, std::vector<Vertex>& vertices,
+                  std::vector<uint32_t>& indices) {
+  for (int y{0}; y <= size; ++y) {
+    for (int x{0}; x <= size; ++x) {
+      Vertex vertex{};
+      vertex.pos = {static_cast<float>(x), static_cast<float>(y), 0.0f};
+      vertices.push_back(vertex);
+    }
+  }
+  std::vector<std::array<uint32_t, 3>> triangles;
+  const auto at = [size](int x, int y) {
+    return static_cast<uint32_t>(y * (size + 1) + x);
+  };
+  for (int y{0}; y < size; ++y) {
+    for (int x{0}; x < size; ++x) {
+      triangles.push_back({at(x, y), at(x + 1, y), at(x + 1, y + 1)});
+      triangles.push_back({at(x, y), at(x + 1, y + 1), at(x, y + 1)});
+    }
+  }
+  std::shuffle(triangles.begin(), triangles.end(), std::mt19937(42));
+  for (const auto& triangle : triangles) {
+    indices.insert(indices.end(), triangle.begin(), triangle.end());
+  }
+}
+
+// Triangles as position triples, rotated to start at their smallest corner
+// so that winding is kept but the starting corner does not matter.
+std::vector<std::array<float, 9>> canonicalTriangles(
+    const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
+  std::vector<std::array<float, 9>> triangles;
+  for (size_t t{0}; t < indices.size(); t += 3) {
+    std::array<std::array<float, 3>, 3> corners;
+    for (size_t c{0}; c < 3; ++c) {
+      const glm::vec3& pos = vertices[indices[t + c]].pos;
+      corners[c] = {pos.x, pos.y, pos.z};
+    }
+    std::rotate(corners.begin(),
+                std::min_element(corners.begin(), corners.end()),
+                corners.end());
+    std::array<float, 9> triangle;
+    for (size_t c{0}; c < 9; ++c) {
+      triangle[c] = corners[c / 3][c % 3];
+    }
+    triangles.push_back(triangle);
+  }
+  std::sort(triangles.begin(), triangles.end());
+  return triangles;
+}
+
+}  // namespace
+
+TEST_CASE("Mesh cache round-trips geometry", "[meshcache]") {
+  const std::string source = tempPath("meshcache_roundtrip.obj");
+  const std::string cache = source + ".meshcache";
+  writeText(source, "v 0 0 0\n");
+
+  const auto vertices = quadVertices();
+  const std::vector<uint16_t> indices{0, 1, 2, 2, 3, 0, 0, 1, 2};
+  const std::vector<MeshRange> ranges{{0, 6, 0, 0}, {6, 3, 1, 1}};
+  MeshView mesh{};
+  mesh.vertices = vertices.data();
+  mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+  mesh.indices = indices.data();
+  mesh.indexCount = static_cast<uint32_t>(indices.size());
+  mesh.indexSize = sizeof(uint16_t);
+  mesh.ranges = ranges.data();
+  mesh.rangeCount = static_cast<uint32_t>(ranges.size());
+  Meshlet meshlet{};
+  meshlet.sphere = glm::vec4(0.5f, 0.5f, 0.25f, 0.8f);
+  meshlet.firstIndex = 6;
+  meshlet.indexCount = 3;
+  meshlet.vertexOffset = 1;
+  meshlet.part = 1;
+  mesh.meshlets = &meshlet;
+  mesh.meshletCount = 1;
+  const std::vector<MeshLod> lods{{0, 6, 0, 1, 0, 0, 0.0f, 0},
+                                  {6, 3, 1, 1, 0, 1, 0.25f, 0}};
+  mesh.lods = lods.data();
+  mesh.lodCount = static_cast<uint32_t>(lods.size());
+  std::array<MeshPart, 2> parts{};
+  parts[1].transform[3] = glm::vec4(2.0f, 0.0f, 0.0f, 1.0f);
+  parts[1].material = 3;
+  mesh.parts = parts.data();
+  mesh.partCount = static_cast<uint32_t>(parts.size());
+  mesh.bounds = computeBounds(vertices.data(), vertices.size());
+  REQUIRE(mesh.bounds.max == glm::vec3(1.0f, 1.0f, 0.5f));
+  mesh.sceneBounds = {mesh.bounds.min, mesh.bounds.max + glm::vec3(2, 0, 0)};
+  REQUIRE(MeshCache::write(cache, source, mesh));
+
+  MeshCache meshCache;
+  REQUIRE(meshCache.open(cache, source));
+  const MeshView view = meshCache.view();
+  REQUIRE(view.vertexCount == vertices.size());
+  REQUIRE(view.indexCount == indices.size());
+  REQUIRE(view.indexType() == VK_INDEX_TYPE_UINT16);
+  for (size_t i{0}; i < vertices.size(); ++i) {
+    REQUIRE(view.vertices[i] == vertices[i]);
+  }
+  for (size_t i{0}; i < indices.size(); ++i) {
+    REQUIRE(view.index(i) == indices[i]);
+  }
+  REQUIRE(view.rangeCount == 2);
+  REQUIRE(view.ranges[1].firstIndex == 6);
+  REQUIRE(view.ranges[1].indexCount == 3);
+  REQUIRE(view.ranges[1].vertexOffset == 1);
+  REQUIRE(view.ranges[1].part == 1);
+  REQUIRE(view.meshletCount == 1);
+  REQUIRE(view.meshlets[0].sphere == meshlet.sphere);
+  REQUIRE(view.meshlets[0].firstIndex == 6);
+  REQUIRE(view.meshlets[0].part == 1);
+  REQUIRE(view.lodCount == 2);
+  REQUIRE(view.lod(1).firstRange == 1);
+  REQUIRE(view.lod(1).error == 0.25f);
+  REQUIRE(view.bounds.min == mesh.bounds.min);
+  REQUIRE(view.bounds.max == mesh.bounds.max);
+  REQUIRE(view.partCount == 2);
+  REQUIRE(view.parts[1].transform == parts[1].transform);
+  REQUIRE(view.parts[1].material == 3);
+  REQUIRE(view.sceneBounds.max == mesh.sceneBounds.max);
+}
+
+TEST_CASE("Mesh cache is rejected when the source changes", "[meshcache]") {
+  const std::string source = tempPath("meshcache_stale.obj");
+  const std::string cache = source + ".meshcache";
+  writeText(source, "v 0 0 0\n");
+
+  const auto vertices = quadVertices();
+  const std::vector<uint32_t> indices{0, 1, 2};
+  const std::vector<MeshRange> ranges{{0, 3, 0, 0}};
+  MeshView mesh{};
+  mesh.vertices = vertices.data();
+  mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+  mesh.indices = indices.data();
+  mesh.indexCount = static_cast<uint32_t>(indices.size());
+  mesh.ranges = ranges.data();
+  mesh.rangeCount = static_cast<uint32_t>(ranges.size());
+  REQUIRE(MeshCache::write(cache, source, mesh));
+
+  MeshCache meshCache;
+  SECTION("touching the source keeps the cache") {
+    std::filesystem::last_write_time(
+        source, std::filesystem::last_write_time(source) +
+                    std::chrono::seconds(5));
+    REQUIRE(meshCache.open(cache, source));
+    // The stamp now carries the new mtime, for the cheap check next time.
+    meshCache.close();
+    MeshCacheHeader header{};
+    std::ifstream(cache, std::ios::binary)
+        .read(reinterpret_cast<char*>(&header), sizeof(header));
+    REQUIRE(header.source.mtime == std::filesystem::last_write_time(source)
+                                       .time_since_epoch()
+                                       .count());
+  }
+  SECTION("editing the source invalidates the cache") {
+    writeText(source, "v 1 0 0\n");
+    std::filesystem::last_write_time(
+        source, std::filesystem::last_write_time(source) +
+                    std::chrono::seconds(5));
+    REQUIRE_FALSE(meshCache.open(cache, source));
+  }
+  SECTION("a truncated cache is rejected") {
+    std::filesystem::resize_file(cache, sizeof(MeshCacheHeader) + 4);
+    REQUIRE_FALSE(meshCache.open(cache, source));
+  }
+  SECTION("an offset whose end wraps around is rejected") {
+    MeshCacheHeader header{};
+    std::ifstream(cache, std::ios::binary)
+        .read(reinterpret_cast<char*>(&header), sizeof(header));
+    header.vertexOffset = 0 - MESH_CACHE_ALIGNMENT;
+    std::fstream out(cache, std::ios::in | std::ios::out | std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    REQUIRE_FALSE(meshCache.open(cache, source));
+  }
+  SECTION("an index past the vertices is rejected") {
+    MeshCacheHeader header{};
+    std::ifstream(cache, std::ios::binary)
+        .read(reinterpret_cast<char*>(&header), sizeof(header));
+    const auto index = static_cast<uint32_t>(vertices.size());
+    std::fstream out(cache, std::ios::in | std::ios::out | std::ios::binary);
+    out.seekp(static_cast<std::streamoff>(header.indexOffset));
+    out.write(reinterpret_cast<const char*>(&index), sizeof(index));
+    out.close();
+    REQUIRE_FALSE(meshCache.open(cache, source));
+  }
+}
+
+TEST_CASE("Compressed mesh cache decodes to the cooked geometry",
+          "[meshcache]") {
+  const std::string source = tempPath("meshcache_compressed.obj");
+  const std::string cache = source + ".meshcache";
+  writeText(source, "v 0 0 0\n");
+
+  // More than one codec block of vertices and of indices.
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  shuffledGrid(150, vertices, indices);
+  MeshView mesh{};
+  mesh.vertices = vertices.data();
+  mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+  mesh.indices = indices.data();
+  mesh.indexCount = static_cast<uint32_t>(indices.size());
+  mesh.indexSize = sizeof(uint32_t);
+  REQUIRE(MeshCache::write(cache, source, mesh, true));
+  REQUIRE(std::filesystem::file_size(cache) <
+          vertices.size() * sizeof(Vertex) / 2);
+
+  MeshCache meshCache;
+  REQUIRE(meshCache.open(cache, source));
+  const MeshView view = meshCache.view();
+  REQUIRE(view.vertexCount == vertices.size());
+  REQUIRE(view.indexCount == indices.size());
+  REQUIRE(std::equal(vertices.begin(), vertices.end(), view.vertices));
+  for (size_t i{0}; i < indices.size(); ++i) {
+    REQUIRE(view.index(i) == indices[i]);
+  }
+  meshCache.close();
+
+  SECTION("a damaged stream is rejected") {
+    MeshCacheHeader header{};
+    std::ifstream(cache, std::ios::binary)
+        .read(reinterpret_cast<char*>(&header), sizeof(header));
+    std::fstream out(cache, std::ios::in | std::ios::out | std::ios::binary);
+    out.seekp(static_cast<std::streamoff>(header.indexOffset +
+                                          header.indexStreamSize / 2));
+    out.write("\xff\xff\xff\xff\xff\xff\xff\xff", 8);
+    out.close();
+    REQUIRE_FALSE(meshCache.open(cache, source));
+  }
+  SECTION("a count the streams cannot hold is rejected") {
+    MeshCacheHeader header{};
+    std::ifstream(cache, std::ios::binary)
+        .read(reinterpret_cast<char*>(&header), sizeof(header));
+    header.vertexCount = 0xffffffffu;
+    std::fstream out(cache, std::ios::in | std::ios::out | std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    REQUIRE_FALSE(meshCache.open(cache, source));
+  }
+}
+
+TEST_CASE("Geometry streams round-trip across blocks", "[codec]") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  shuffledGrid(150, vertices, indices);
+  REQUIRE(vertices.size() > CODEC_BLOCK_VERTICES);
+  REQUIRE(indices.size() > CODEC_BLOCK_INDICES);
+  // Wrapping deltas in both directions.
+  indices[0] = 0xffffffffu;
+  const std::vector<uint16_t> shortIndices(indices.begin(),
+                                           indices.begin() + 70000);
+
+  const auto vertexStream =
+      encodeVertexStream(vertices.data(), vertices.size(), sizeof(Vertex));
+  const auto indexStream =
+      encodeIndexStream(indices.data(), indices.size(), sizeof(uint32_t));
+  const auto shortStream = encodeIndexStream(
+      shortIndices.data(), shortIndices.size(), sizeof(uint16_t));
+  REQUIRE(vertexStream.size() < vertices.size() * sizeof(Vertex));
+  REQUIRE(indexStream.size() < indices.size() * sizeof(uint32_t));
+  REQUIRE(checkVertexStream(vertexStream.data(), vertexStream.size(),
+                            vertices.size(), sizeof(Vertex)));
+  REQUIRE_FALSE(checkVertexStream(vertexStream.data(), vertexStream.size(),
+                                  vertices.size() + 1, sizeof(Vertex)));
+  REQUIRE(checkIndexStream(indexStream.data(), indexStream.size(),
+                           indices.size(), sizeof(uint32_t)));
+  REQUIRE_FALSE(checkIndexStream(indexStream.data(), indexStream.size() / 2,
+                                 indices.size(), sizeof(uint32_t)));
+
+  for (unsigned int threads : {1u, 3u}) {
+    std::vector<Vertex> decodedVertices(vertices.size());
+    std::vector<uint32_t> decodedIndices(indices.size());
+    std::vector<uint16_t> decodedShort(shortIndices.size());
+    REQUIRE(decodeVertexStream(vertexStream.data(), vertexStream.size(),
+                               decodedVertices.data(), vertices.size(),
+                               sizeof(Vertex), threads));
+    REQUIRE(decodeIndexStream(indexStream.data(), indexStream.size(),
+                              decodedIndices.data(), indices.size(),
+                              sizeof(uint32_t), threads));
+    REQUIRE(decodeIndexStream(shortStream.data(), shortStream.size(),
+                              decodedShort.data(), shortIndices.size(),
+                              sizeof(uint16_t), threads));
+    REQUIRE(decodedVertices == vertices);
+    REQUIRE(decodedIndices == indices);
+    REQUIRE(decodedShort == shortIndices);
+  }
+
+  std::vector<Vertex> decoded(vertices.size());
+  // Streams only decode into the shape they were encoded from.
+  REQUIRE_FALSE(decodeVertexStream(vertexStream.data(), vertexStream.size(),
+                                   decoded.data(), vertices.size() - 1,
+                                   sizeof(Vertex)));
+  REQUIRE_FALSE(decodeVertexStream(indexStream.data(), indexStream.size(),
+                                   decoded.data(), indices.size() / 8,
+                                   sizeof(uint32_t)));
+  REQUIRE_FALSE(decodeVertexStream(vertexStream.data(), 40, decoded.data(),
+                                   vertices.size(), sizeof(Vertex)));
+  auto damaged = vertexStream;
+  damaged.resize(damaged.size() - 1);
+  REQUIRE_FALSE(decodeVertexStream(damaged.data(), damaged.size(),
+                                   decoded.data(), vertices.size(),
+                                   sizeof(Vertex)));
+}
+
+TEST_CASE("OBJ floats are parsed like Assimp's fast_atof", "[objparser]") {
+  const auto parse = [](const std::string& text) {
+    const char* c = text.data();
+    return parseObjFloat(c, text.data() + text.size());
+  };
+  REQUIRE(parse("1") == 1.0f);
+  REQUIRE(parse("-0.5") == -0.5f);
+  REQUIRE(parse(".25") == 0.25f);
+  REQUIRE(parse("1.5e2") == 150.0f);
+  REQUIRE(parse("-0.573651") ==
+          (0.0f + static_cast<float>(573651 * 0.000001)) * -1.0f);
+  REQUIRE_THROWS(parse("x"));
+}
+
+TEST_CASE("OBJ faces are triangulated and indexed correctly", "[objparser]") {
+  const std::string text =
+      "# quad and a triangle using relative indices\n"
+      "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\r\n"
+      "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+      "f 1/1 2/2 3/3 4/4\n"
+      "f -4/-4 -3/-3 -2/-2\n"
+      "l 1 2\n";
+  const auto corners = parseObj(text.data(), text.size());
+  REQUIRE(corners.size() == 9);
+  REQUIRE(corners[0].pos == glm::vec3(0.0f, 0.0f, 0.0f));
+  REQUIRE(corners[4].pos == glm::vec3(1.0f, 1.0f, 0.0f));
+  REQUIRE(corners[5].pos == glm::vec3(0.0f, 1.0f, 0.0f));
+  REQUIRE(corners[2].texCoord == glm::vec2(1.0f, 0.0f));
+  REQUIRE(corners[7].pos == glm::vec3(1.0f, 0.0f, 0.0f));
+  REQUIRE(corners[8].color == glm::vec3(1.0f, 1.0f, 1.0f));
+}
+
+TEST_CASE("Native OBJ import matches the Assimp import", "[objparser]") {
+  const std::string path = std::string(MODELS_DIR) + "/viking_room.obj";
+  const auto native = parseObj(path, 8);
+  const auto assimp = importCornersAssimp(path);
+  REQUIRE(native.size() == assimp.size());
+  for (size_t i{0}; i < native.size(); ++i) {
+    REQUIRE(native[i] == assimp[i]);
+  }
+}
+
+TEST_CASE("Welding merges equal vertices only", "[weld]") {
+  auto corners = quadVertices();
+  corners.push_back(corners[0]);
+  corners.push_back(corners[2]);
+  // -0.0 welds with +0.0, as it compares equal.
+  corners.push_back(corners[0]);
+  corners.back().pos.x = -0.0f;
+  // A one-ulp difference does not.
+  corners.push_back(corners[1]);
+  corners.back().texCoord.x = std::nextafter(1.0f, 2.0f);
+
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  weldVertices(corners, vertices, indices);
+  REQUIRE(vertices.size() == 5);
+  REQUIRE(indices == std::vector<uint32_t>{0, 1, 2, 3, 0, 2, 0, 4});
+  REQUIRE(std::hash<Vertex>()(corners[0]) == std::hash<Vertex>()(corners[6]));
+}
+
+TEST_CASE("Weld table grows past its initial size", "[weld]") {
+  VertexWeldTable table(1);
+  std::vector<Vertex> vertices;
+  for (uint32_t i{0}; i < 1000; ++i) {
+    Vertex vertex{};
+    vertex.pos.x = static_cast<float>(i);
+    REQUIRE(table.weld(vertex, vertices) == i);
+  }
+  for (uint32_t i{0}; i < 1000; ++i) {
+    Vertex vertex{};
+    vertex.pos.x = static_cast<float>(i);
+    REQUIRE(table.weld(vertex, vertices) == i);
+  }
+  REQUIRE(vertices.size() == 1000);
+}
+
+TEST_CASE("Parallel welding matches the serial weld", "[weld]") {
+  const auto model = parseObj(std::string(MODELS_DIR) + "/viking_room.obj", 1);
+  std::vector<Vertex> corners;
+  for (int copy{0}; copy < 4; ++copy) {
+    // Every other copy overlaps the first one, so shards see repeats that
+    // span blocks.
+    for (Vertex vertex : model) {
+      vertex.pos.x += static_cast<float>(copy / 2);
+      corners.push_back(vertex);
+    }
+  }
+
+  std::vector<Vertex> serialVertices{quadVertices()[0]};
+  std::vector<uint32_t> serialIndices{0};
+  weldVertices(corners, serialVertices, serialIndices, 1);
+  std::vector<Vertex> parallelVertices{quadVertices()[0]};
+  std::vector<uint32_t> parallelIndices{0};
+  weldVertices(corners, parallelVertices, parallelIndices, 4);
+
+  REQUIRE(parallelIndices == serialIndices);
+  REQUIRE(parallelVertices.size() == serialVertices.size());
+  for (size_t i{0}; i < serialVertices.size(); ++i) {
+    REQUIRE(parallelVertices[i] == serialVertices[i]);
+  }
+}
+
+TEST_CASE("Vertex cache statistics follow a FIFO cache", "[optimizer]") {
+  const std::vector<uint32_t> quad{0, 1, 2, 0, 2, 3};
+  const auto warm = analyzeVertexCache(quad, 4);
+  REQUIRE(warm.acmr == 2.0f);
+  REQUIRE(warm.atvr == 1.0f);
+  // With a single entry every corner after the first misses.
+  const auto tiny = analyzeVertexCache(quad, 4, 1);
+  REQUIRE(tiny.acmr == 3.0f);
+  REQUIRE(tiny.atvr == 1.5f);
+}
+
+TEST_CASE("Mesh optimization reduces ACMR and keeps the triangles",
+          "[optimizer]") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  shuffledGrid(32, vertices, indices);
+  const auto expected = canonicalTriangles(vertices, indices);
+
+  const MeshOptimizationStats stats = optimizeMesh(vertices, indices);
+  REQUIRE(stats.before.acmr > 2.0f);
+  REQUIRE(stats.after.acmr < 1.0f);
+  REQUIRE(stats.after.atvr < stats.before.atvr);
+  REQUIRE(vertices.size() == 33 * 33);
+  REQUIRE(canonicalTriangles(vertices, indices) == expected);
+
+  // Vertices are numbered in order of first use.
+  uint32_t next{0};
+  for (uint32_t index : indices) {
+    REQUIRE(index <= next);
+    next = std::max(next, index + 1);
+  }
+}
+
+TEST_CASE("Half floats round to nearest even", "[compact]") {
+  REQUIRE(floatToHalf(1.0f) == 0x3c00);
+  REQUIRE(floatToHalf(-2.0f) == 0xc000);
+  REQUIRE(floatToHalf(0.5f) == 0x3800);
+  REQUIRE(floatToHalf(65504.0f) == 0x7bff);
+  REQUIRE(floatToHalf(65520.0f) == 0x7c00);
+  REQUIRE(floatToHalf(std::ldexp(1.0f, -24)) == 0x0001);
+  REQUIRE(floatToHalf(std::ldexp(1.0f, -14)) == 0x0400);
+  // Halfway between 1 and the next half: ties go to the even mantissa.
+  REQUIRE(floatToHalf(1.0f + std::ldexp(1.0f, -11)) == 0x3c00);
+  REQUIRE(floatToHalf(1.0f + 3.0f * std::ldexp(1.0f, -11)) == 0x3c02);
+  for (uint32_t half{0}; half < 0x7c00; ++half) {
+    REQUIRE(floatToHalf(halfToFloat(static_cast<uint16_t>(half))) == half);
+  }
+}
+
+TEST_CASE("Compact vertices stay within quantization error", "[compact]") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  weldVertices(parseObj(std::string(MODELS_DIR) + "/viking_room.obj"),
+               vertices, indices);
+  const MeshBounds bounds = computeBounds(vertices.data(), vertices.size());
+  const glm::vec3 extent = bounds.max - bounds.min;
+  const auto compact =
+      compactVertices(vertices.data(), vertices.size(), bounds);
+  REQUIRE(sizeof(CompactVertex) == 12);
+
+  for (size_t i{0}; i < vertices.size(); ++i) {
+    const Vertex expanded = expandVertex(compact[i], bounds);
+    for (int axis{0}; axis < 3; ++axis) {
+      REQUIRE(std::fabs(expanded.pos[axis] - vertices[i].pos[axis]) <=
+              extent[axis] / 65535.0f);
+    }
+    for (int axis{0}; axis < 2; ++axis) {
+      // UVs are in [0, 1], where half floats have 11 significant bits.
+      REQUIRE(std::fabs(expanded.texCoord[axis] -
+                        vertices[i].texCoord[axis]) <= 1.0f / 2048.0f);
+    }
+  }
+}
+
+TEST_CASE("Split vertex streams keep positions on their own", "[split]") {
+  std::vector<Vertex> vertices = quadVertices();
+  vertices.push_back({{2.0f, 3.0f, 4.0f}, {0.5f, 0.25f, 0.0f}, {0.5f, 1.0f}});
+  const auto streams = splitVertices(vertices.data(), vertices.size());
+  const size_t attributeOffset = splitAttributeOffset(vertices.size());
+  REQUIRE(attributeOffset == 64);
+  REQUIRE(streams.size() ==
+          attributeOffset + vertices.size() * sizeof(VertexAttributes));
+  REQUIRE(joinVertices(streams.data(), vertices.size()) == vertices);
+
+  glm::vec3 position{};
+  std::memcpy(&position, streams.data() + 4 * sizeof(VertexPosition),
+              sizeof(position));
+  REQUIRE(position == vertices[4].pos);
+
+  // A position-only pipeline binds just the first stream.
+  REQUIRE(VertexPosition::getBindingDescription().stride == 12);
+  REQUIRE(VertexPosition::getAttributeDescriptions()[0].location == 0);
+  for (const auto& attribute : VertexAttributes::getAttributeDescriptions()) {
+    REQUIRE(attribute.binding == 1);
+    REQUIRE(attribute.location != 0);
+  }
+  REQUIRE(MeshPart::getBindingDescription(SPLIT_PART_BINDING).binding == 2);
+}
+
+TEST_CASE("Mip chains are filtered in linear space down to 1x1",
+          "[texture]") {
+  // Black and white texels. Each texel of the odd 5x3 -> 2x1 level covers
+  // 7/15 white, which is linear 7/15 and sRGB 182; averaging the stored
+  // values, as alpha does, gives 119.
+  std::vector<uint8_t> pixels(5 * 3 * 4);
+  for (size_t i{0}; i < 5 * 3; ++i) {
+    const uint8_t value = i % 2 == 0 ? 0 : 255;
+    pixels[i * 4 + 0] = value;
+    pixels[i * 4 + 1] = value;
+    pixels[i * 4 + 2] = value;
+    pixels[i * 4 + 3] = value;
+  }
+  const CookedTexture texture = cookTexture(pixels.data(), 5, 3);
+  REQUIRE(texture.format == VK_FORMAT_R8G8B8A8_SRGB);
+  REQUIRE(texture.levels.size() == 3);
+  REQUIRE(texture.levels[1].width == 2);
+  REQUIRE(texture.levels[1].height == 1);
+  REQUIRE(texture.levels[2].width == 1);
+  REQUIRE(texture.levels[2].height == 1);
+  for (const TextureLevel& level : texture.levels) {
+    REQUIRE(level.offset % TEXTURE_CACHE_ALIGNMENT == 0);
+    REQUIRE(level.size == uint64_t{level.width} * level.height * 4);
+    REQUIRE(level.offset + level.size <= texture.data.size());
+  }
+  REQUIRE(std::equal(pixels.begin(), pixels.end(), texture.data.begin()));
+  const uint8_t* half = texture.data.data() + texture.levels[1].offset;
+  REQUIRE(half[0] == 182);
+  REQUIRE(half[3] == 119);
+  REQUIRE(half[4] == 182);
+  REQUIRE(half[7] == 119);
+  const uint8_t* last = texture.data.data() + texture.levels[2].offset;
+  REQUIRE(last[0] == 182);
+
+  // An even 2x2 block of black and white is linear mid-grey, sRGB 188.
+  const uint8_t checker[16]{0,   0,   0,   0,   255, 255, 255, 255,
+                            255, 255, 255, 255, 0,   0,   0,   0};
+  uint8_t grey[4]{};
+  downsampleSrgba(checker, 2, 2, grey);
+  REQUIRE(grey[0] == 188);
+  REQUIRE(grey[3] == 128);
+}
+
+TEST_CASE("Odd mip levels keep the last row and column", "[texture]") {
+  // Only the last column of a 5x1 row is white. Every source texel covers
+  // the same share of the level below, so it reaches the second texel with
+  // weight 2/5 and the total brightness is kept.
+  std::vector<uint8_t> pixels(5 * 4, 0);
+  pixels[4 * 4 + 3] = 255;
+  uint8_t half[2 * 4]{};
+  downsampleSrgba(pixels.data(), 5, 1, half);
+  REQUIRE(half[3] == 0);
+  REQUIRE(half[7] == 102);
+
+  // The same holds for the last row of a 1x3 column.
+  uint8_t column[3 * 4]{};
+  column[2 * 4 + 3] = 255;
+  uint8_t single[4]{};
+  downsampleSrgba(column, 1, 3, single);
+  REQUIRE(single[3] == 85);
+}
+
+TEST_CASE("SIMD and parallel mip filtering match the scalar reference",
+          "[texture]") {
+  constexpr uint32_t width = 67;
+  constexpr uint32_t height = 45;
+  std::mt19937 random(11);
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::vector<uint8_t> pixels(width * height * 4);
+  for (uint8_t& value : pixels) {
+    value = static_cast<uint8_t>(byte(random));
+  }
+  const CookedTexture reference =
+      cookTexture(pixels.data(), width, height, MipKernel::Scalar, 1);
+  const CookedTexture simd =
+      cookTexture(pixels.data(), width, height, MipKernel::Simd, 1);
+  const CookedTexture parallel =
+      cookTexture(pixels.data(), width, height, MipKernel::Simd, 4);
+  REQUIRE(simd.data.size() == reference.data.size());
+  // Vector code may fuse multiply-adds, so allow one step of rounding.
+  for (size_t i{0}; i < reference.data.size(); ++i) {
+    REQUIRE(std::abs(simd.data[i] - reference.data[i]) <= 1);
+  }
+  REQUIRE(parallel.data == simd.data);
+}
+
+TEST_CASE("Texture cache round-trips the mip chain", "[texture]") {
+  const std::string source = tempPath("texturecache_roundtrip.png");
+  const std::string cache = source + ".texturecache";
+  writeText(source, "png");
+
+  std::vector<uint8_t> pixels(16 * 8 * 4);
+  std::iota(pixels.begin(), pixels.end(), uint8_t{0});
+  const CookedTexture texture = cookTexture(pixels.data(), 16, 8);
+  REQUIRE(TextureCache::write(cache, source, texture.view()));
+
+  TextureCache textureCache;
+  REQUIRE(textureCache.open(cache, source));
+  const TextureView view = textureCache.view();
+  REQUIRE(view.format == texture.format);
+  REQUIRE(view.width == 16);
+  REQUIRE(view.height == 8);
+  REQUIRE(view.levelCount == 5);
+  for (uint32_t level{0}; level < view.levelCount; ++level) {
+    REQUIRE(view.levels[level].offset == texture.levels[level].offset);
+    REQUIRE(view.levels[level].size == texture.levels[level].size);
+    REQUIRE(view.levels[level].width == texture.levels[level].width);
+  }
+  REQUIRE(view.dataSize == texture.data.size());
+  REQUIRE(std::equal(texture.data.begin(), texture.data.end(), view.data));
+
+  textureCache.close();
+  writeText(source, "jpg");
+  std::filesystem::last_write_time(
+      source,
+      std::filesystem::last_write_time(source) + std::chrono::seconds(5));
+  REQUIRE_FALSE(textureCache.open(cache, source));
+}
+
+TEST_CASE("Block-compressed textures stay close to their source",
+          "[texture]") {
+  // A diagonal ramp with a little noise, in a size that leaves partial
+  // blocks on two sides.
+  constexpr uint32_t width = 37;
+  constexpr uint32_t height = 21;
+  std::mt19937 random(7);
+  std::uniform_int_distribution<int> noise(-2, 2);
+  std::vector<uint8_t> pixels(width * height * 4);
+  for (uint32_t y{0}; y < height; ++y) {
+    for (uint32_t x{0}; x < width; ++x) {
+      uint8_t* texel = pixels.data() + (y * width + x) * 4;
+      const auto t = static_cast<int>(x + y);
+      const int values[4]{t * 4, 40 + t * 3, 200 - t * 2, 255 - t};
+      for (size_t c{0}; c < 4; ++c) {
+        texel[c] =
+            static_cast<uint8_t>(std::clamp(values[c] + noise(random), 0, 255));
+      }
+    }
+  }
+
+  // Largest tolerated RMS error per channel.
+  const std::tuple<VkFormat, double, bool> formats[]{
+      {VK_FORMAT_BC1_RGB_SRGB_BLOCK, 3.0, false},
+      {VK_FORMAT_BC3_SRGB_BLOCK, 3.0, true},
+      {VK_FORMAT_BC7_SRGB_BLOCK, 1.6, true}};
+  for (const auto& [format, tolerance, hasAlpha] : formats) {
+    REQUIRE(isBlockCompressed(format));
+    const size_t blockBytes = format == VK_FORMAT_BC1_RGB_SRGB_BLOCK ? 8 : 16;
+    REQUIRE(textureLevelSize(format, width, height) == 10 * 6 * blockBytes);
+    REQUIRE(textureLevelSize(format, 1, 1) == blockBytes);
+
+    std::vector<uint8_t> blocks(textureLevelSize(format, width, height));
+    compressBlocks(format, pixels.data(), width, height, blocks.data());
+    std::vector<uint8_t> decoded(pixels.size());
+    REQUIRE(decompressBlocks(format, blocks.data(), width, height,
+                             decoded.data()));
+    const size_t channels = hasAlpha ? 4 : 3;
+    double squaredError{0.0};
+    for (size_t i{0}; i < pixels.size(); ++i) {
+      if (i % 4 < channels) {
+        const int difference = pixels[i] - decoded[i];
+        squaredError += difference * difference;
+      }
+    }
+    const double rms =
+        std::sqrt(squaredError / (double{width} * height * channels));
+    INFO("format " << format << " RMS error " << rms);
+    REQUIRE(rms < tolerance);
+
+    // Every level is compressed and the cache accepts the block sizes.
+    const CookedTexture cooked = cookTexture(pixels.data(), width, height);
+    const CookedTexture compressed = compressTexture(cooked.view(), format);
+    REQUIRE(compressed.format == format);
+    REQUIRE(compressed.levels.size() == cooked.levels.size());
+    for (const TextureLevel& level : compressed.levels) {
+      REQUIRE(level.offset % TEXTURE_CACHE_ALIGNMENT == 0);
+      REQUIRE(level.size ==
+              textureLevelSize(format, level.width, level.height));
+    }
+    REQUIRE(std::equal(blocks.begin(), blocks.end(), compressed.data.begin()));
+    const std::string source = tempPath("texturecache_compressed.png");
+    writeText(source, "png");
+    REQUIRE(TextureCache::write(source + ".texturecache", source,
+                                compressed.view()));
+    TextureCache cache;
+    REQUIRE(cache.open(source + ".texturecache", source));
+    REQUIRE(cache.view().format == format);
+    REQUIRE(cache.view().levelCount == compressed.levels.size());
+  }
+}
+
+TEST_CASE("Texture batches are grouped into arrays by format and size",
+          "[texture]") {
+  const auto texture = [](VkFormat format, uint32_t width, uint32_t height) {
+    TextureView view;
+    view.format = format;
+    view.width = width;
+    view.height = height;
+    view.levelCount = mipLevelCount(width, height);
+    return view;
+  };
+  const std::vector<TextureView> batch{
+      texture(VK_FORMAT_BC7_SRGB_BLOCK, 64, 64),
+      texture(VK_FORMAT_BC7_SRGB_BLOCK, 32, 64),
+      texture(VK_FORMAT_BC7_SRGB_BLOCK, 64, 64),
+      texture(VK_FORMAT_R8G8B8A8_SRGB, 64, 64),
+      texture(VK_FORMAT_BC7_SRGB_BLOCK, 64, 64),
+      texture(VK_FORMAT_BC7_SRGB_BLOCK, 32, 64)};
+
+  const std::vector<TextureArrayLayout> arrays = groupTextureLayers(batch, 8);
+  REQUIRE(arrays.size() == 3);
+  REQUIRE(arrays[0].textures == std::vector<uint32_t>{0, 2, 4});
+  REQUIRE(arrays[1].textures == std::vector<uint32_t>{1, 5});
+  REQUIRE(arrays[2].textures == std::vector<uint32_t>{3});
+  for (const TextureArrayLayout& array : arrays) {
+    for (uint32_t index : array.textures) {
+      REQUIRE(batch[index].format == array.format);
+      REQUIRE(batch[index].width == array.width);
+      REQUIRE(batch[index].height == array.height);
+      REQUIRE(batch[index].levelCount == array.levelCount);
+    }
+  }
+
+  // A full array starts another one of the same kind.
+  const std::vector<TextureArrayLayout> limited = groupTextureLayers(batch, 2);
+  REQUIRE(limited.size() == 4);
+  REQUIRE(limited[0].textures == std::vector<uint32_t>{0, 2});
+  REQUIRE(limited[1].textures == std::vector<uint32_t>{1, 5});
+  REQUIRE(limited[2].textures == std::vector<uint32_t>{3});
+  REQUIRE(limited[3].textures == std::vector<uint32_t>{4});
+}
+
+TEST_CASE("Texture mips are streamed smallest first within a budget",
+          "[texture]") {
+  const auto array = [](VkFormat format, uint32_t width, uint32_t height,
+                        size_t layers) {
+    TextureArrayLayout layout;
+    layout.format = format;
+    layout.width = width;
+    layout.height = height;
+    layout.levelCount = mipLevelCount(width, height);
+    layout.textures.resize(layers);
+    return layout;
+  };
+  const std::vector<TextureArrayLayout> arrays{
+      array(VK_FORMAT_BC7_SRGB_BLOCK, 1024, 512, 2),
+      array(VK_FORMAT_R8G8B8A8_SRGB, 256, 256, 1),
+      array(VK_FORMAT_R8G8B8A8_SRGB, 64, 64, 1)};
+
+  std::vector<uint32_t> resident;
+  for (const TextureArrayLayout& layout : arrays) {
+    resident.push_back(mipTailLevel(layout));
+  }
+  REQUIRE(resident == std::vector<uint32_t>{3, 1, 0});
+  REQUIRE(arrayLevelSize(arrays[0], 2) == 2 * 64 * 32 * 16);
+  REQUIRE(arrayLevelSize(arrays[1], 0) == 256 * 256 * 4);
+
+  // Ties go to the first array; the next level would overrun the budget.
+  std::vector<MipUpload> uploads = planMipUploads(
+      arrays, resident, arrayLevelSize(arrays[0], 2) * 5);
+  REQUIRE(uploads.size() == 2);
+  REQUIRE(uploads[0].array == 0);
+  REQUIRE(uploads[0].level == 2);
+  REQUIRE(uploads[1].array == 0);
+  REQUIRE(uploads[1].level == 1);
+  REQUIRE(resident == std::vector<uint32_t>{1, 1, 0});
+
+  // One level always goes, even over budget.
+  uploads = planMipUploads(arrays, resident, 0);
+  REQUIRE(uploads.size() == 1);
+  REQUIRE(uploads[0].array == 1);
+  REQUIRE(uploads[0].level == 0);
+  uploads = planMipUploads(arrays, resident, 0);
+  REQUIRE(uploads.size() == 1);
+  REQUIRE(uploads[0].array == 0);
+  REQUIRE(uploads[0].level == 0);
+  REQUIRE(resident == std::vector<uint32_t>{0, 0, 0});
+  REQUIRE(planMipUploads(arrays, resident, 0).empty());
+}
+
+TEST_CASE("Small textures are packed into an atlas with gutters",
+          "[texture]") {
+  // A 3x2 image whose texels are all different.
+  std::vector<uint8_t> pixels(3 * 2 * 4);
+  std::iota(pixels.begin(), pixels.end(), uint8_t{1});
+  const CookedTexture tile = cookAtlasTile(pixels.data(), 3, 2);
+  REQUIRE(tile.width == ATLAS_ALIGNMENT);
+  REQUIRE(tile.height == ATLAS_ALIGNMENT);
+  REQUIRE(tile.contentWidth == 3);
+  REQUIRE(tile.contentHeight == 2);
+  REQUIRE(tile.levels.size() >= ATLAS_LEVEL_COUNT);
+  const auto texel = [&](uint32_t x, uint32_t y) {
+    const uint8_t* p = tile.data.data() + (size_t{y} * tile.width + x) * 4;
+    return std::vector<uint8_t>(p, p + 4);
+  };
+  const auto source = [&](uint32_t x, uint32_t y) {
+    const uint8_t* p = pixels.data() + (size_t{y} * 3 + x) * 4;
+    return std::vector<uint8_t>(p, p + 4);
+  };
+  REQUIRE(texel(ATLAS_GUTTER + 1, ATLAS_GUTTER + 1) == source(1, 1));
+  // The gutter repeats the nearest edge texel, out to the tile border.
+  REQUIRE(texel(0, 0) == source(0, 0));
+  REQUIRE(texel(tile.width - 1, 0) == source(2, 0));
+  REQUIRE(texel(ATLAS_GUTTER + 1, tile.height - 1) == source(1, 1));
+  REQUIRE(texel(tile.width - 1, tile.height - 1) == source(2, 1));
+
+  // The content extent survives the cache.
+  const std::string path = tempPath("atlas_tile.jpg");
+  writeText(path, "jpg");
+  REQUIRE(TextureCache::write(path + ".atlastile", path, tile.view()));
+  TextureCache cache;
+  REQUIRE(cache.open(path + ".atlastile", path));
+  REQUIRE(cache.view().contentWidth == 3);
+  REQUIRE(cache.view().contentHeight == 2);
+
+  const auto view = [](uint32_t width, uint32_t height) {
+    TextureView texture;
+    texture.width = width;
+    texture.height = height;
+    texture.contentWidth = width - 2 * ATLAS_GUTTER;
+    texture.contentHeight = height - 2 * ATLAS_GUTTER;
+    return texture;
+  };
+  const std::vector<TextureView> tiles{view(320, 256), view(64, 64),
+                                       view(576, 576), view(128, 320),
+                                       view(64, 128),  view(192, 64)};
+  const AtlasLayout atlas = packAtlas(tiles, 16384);
+  REQUIRE(atlas.width == 1024);
+  REQUIRE(atlas.height <= atlas.width);
+  REQUIRE(atlas.rects.size() == tiles.size());
+  for (size_t i{0}; i < tiles.size(); ++i) {
+    const AtlasRect& rect = atlas.rects[i];
+    REQUIRE(rect.width == tiles[i].width);
+    REQUIRE(rect.height == tiles[i].height);
+    REQUIRE(rect.x % ATLAS_ALIGNMENT == 0);
+    REQUIRE(rect.y % ATLAS_ALIGNMENT == 0);
+    REQUIRE(rect.x + rect.width <= atlas.width);
+    REQUIRE(rect.y + rect.height <= atlas.height);
+    for (size_t j{0}; j < i; ++j) {
+      const AtlasRect& other = atlas.rects[j];
+      REQUIRE((rect.x + rect.width <= other.x ||
+               other.x + other.width <= rect.x ||
+               rect.y + rect.height <= other.y ||
+               other.y + other.height <= rect.y));
+    }
+  }
+  // The tallest tile goes first, into the corner.
+  REQUIRE(atlas.rects[2].x == 0);
+  REQUIRE(atlas.rects[2].y == 0);
+
+  // UV (0, 0) and (1, 1) land on the corners of the content.
+  const std::array<float, 4> transform =
+      atlasTexCoordTransform(atlas, 0, tiles[0]);
+  const AtlasRect& rect = atlas.rects[0];
+  REQUIRE(transform[2] * atlas.width == Approx(rect.x + ATLAS_GUTTER));
+  REQUIRE(transform[3] * atlas.height == Approx(rect.y + ATLAS_GUTTER));
+  REQUIRE((transform[0] + transform[2]) * atlas.width ==
+          Approx(rect.x + rect.width - ATLAS_GUTTER));
+  REQUIRE((transform[1] + transform[3]) * atlas.height ==
+          Approx(rect.y + rect.height - ATLAS_GUTTER));
+
+  REQUIRE(packAtlas(tiles, 512).width == 0);
+}
+
+TEST_CASE("Atlas tiles are chosen by extent", "[texture]") {
+  REQUIRE(isAtlasCandidate(278, 181));
+  REQUIRE(isAtlasCandidate(ATLAS_MAX_TILE_EXTENT, ATLAS_MAX_TILE_EXTENT));
+  REQUIRE_FALSE(isAtlasCandidate(ATLAS_MAX_TILE_EXTENT + 1, 16));
+  REQUIRE_FALSE(isAtlasCandidate(1024, 1024));
+
+  const auto view = [](uint32_t width, uint32_t height) {
+    TextureView texture;
+    texture.format = VK_FORMAT_R8G8B8A8_SRGB;
+    texture.width = width;
+    texture.height = height;
+    texture.levelCount = ATLAS_LEVEL_COUNT;
+    texture.contentWidth = width - 2 * ATLAS_GUTTER;
+    texture.contentHeight = height - 2 * ATLAS_GUTTER;
+    return texture;
+  };
+  std::vector<TextureView> textures{view(576, 576), view(64, 64),
+                                    view(128, 320), view(576, 576)};
+  // Not tiles: a plain texture, and tiles missing levels or of another
+  // format than the first.
+  textures.emplace_back();
+  textures.back().width = 1024;
+  textures.back().height = 1024;
+  textures.back().levelCount = 11;
+  textures.push_back(view(64, 64));
+  textures.back().levelCount = ATLAS_LEVEL_COUNT - 1;
+  textures.push_back(view(64, 64));
+  textures.back().format = VK_FORMAT_BC7_SRGB_BLOCK;
+  REQUIRE(chooseAtlasTiles(textures, 2048) ==
+          std::vector<uint32_t>{0, 1, 2, 3});
+  // Too small for all of them: the largest are left out first.
+  REQUIRE(chooseAtlasTiles(textures, 1024) == std::vector<uint32_t>{1, 2, 3});
+  REQUIRE(chooseAtlasTiles(textures, 256) == std::vector<uint32_t>{1});
+  REQUIRE(chooseAtlasTiles(textures, 32).empty());
+
+  // A tile on its own maps UV (0, 0) and (1, 1) onto its content.
+  const TextureView& tile = textures[2];
+  const std::array<float, 4> transform = tileTexCoordTransform(tile);
+  REQUIRE(transform[2] * tile.width == Approx(ATLAS_GUTTER));
+  REQUIRE(transform[3] * tile.height == Approx(ATLAS_GUTTER));
+  REQUIRE((transform[0] + transform[2]) * tile.width ==
+          Approx(tile.width - ATLAS_GUTTER));
+  REQUIRE((transform[1] + transform[3]) * tile.height ==
+          Approx(tile.height - ATLAS_GUTTER));
+}
+
+TEST_CASE("Only textures in arrays upload a mip tail", "[texture]") {
+  std::vector<uint8_t> pixels(3 * 2 * 4, 255);
+  const CookedTexture tile = cookAtlasTile(pixels.data(), 3, 2);
+  const CookedTexture texture = allocateTexture(1024, 1024);
+
+  // All tiles, as with --virtual-texture: no arrays, nothing to upload.
+  const std::vector<TextureView> tiles{tile.view(), tile.view()};
+  REQUIRE(chooseAtlasTiles(tiles, ATLAS_MAX_EXTENT).size() == tiles.size());
+  std::vector<uint64_t> offsets = mipTailOffsets(tiles, {});
+  REQUIRE(offsets == std::vector<uint64_t>{tile.view().dataSize,
+                                           tile.view().dataSize});
+
+  // The tail of a texture in an array starts at the array's tail level.
+  const std::vector<TextureView> batch{tile.view(), texture.view()};
+  std::vector<TextureArrayLayout> arrays = groupTextureLayers({batch[1]}, 8);
+  arrays[0].textures = {1};
+  offsets = mipTailOffsets(batch, arrays);
+  REQUIRE(offsets[0] == batch[0].dataSize);
+  REQUIRE(offsets[1] == texture.levels[mipTailLevel(arrays[0])].offset);
+  REQUIRE(offsets[1] < batch[1].dataSize);
+}
+
+TEST_CASE("Virtual textures are tiled into pages with borders",
+          "[virtualtexture]") {
+  constexpr uint32_t width = 300;
+  constexpr uint32_t height = 200;
+  std::vector<uint8_t> pixels(width * height * 4);
+  for (uint32_t y{0}; y < height; ++y) {
+    for (uint32_t x{0}; x < width; ++x) {
+      uint8_t* texel = pixels.data() + (y * width + x) * 4;
+      texel[0] = static_cast<uint8_t>(x);
+      texel[1] = static_cast<uint8_t>(y);
+      texel[2] = static_cast<uint8_t>(x >> 8);
+      texel[3] = 255;
+    }
+  }
+  const std::string source = tempPath("virtual_texture.png");
+  const std::string path = source + ".vtpages";
+  writeText(source, "png");
+  REQUIRE(VirtualTextureFile::write(path, source, pixels.data(), width,
+                                    height, VK_FORMAT_R8G8B8A8_SRGB));
+
+  VirtualTextureFile file;
+  REQUIRE(file.open(path, source));
+  const std::vector<VirtualLevel> levels = file.levels();
+  REQUIRE(levels.size() == 3);
+  REQUIRE(levels[0].pagesX == 3);
+  REQUIRE(levels[0].pagesY == 2);
+  REQUIRE(levels[1].width == 150);
+  REQUIRE(levels[1].firstPage == 6);
+  REQUIRE(levels[2].width == 75);
+  REQUIRE(levels[2].firstPage == 8);
+  REQUIRE(file.pageCount() == 9);
+
+  // Stride texel (x, y) of a page, and the level-0 texel it should hold.
+  const auto pageTexel = [&file](uint32_t page, uint32_t x, uint32_t y) {
+    return file.page(page) + (y * VIRTUAL_PAGE_STRIDE + x) * 4;
+  };
+  const auto sourceTexel = [&pixels](uint32_t x, uint32_t y) {
+    return pixels.data() + (y * width + x) * 4;
+  };
+  REQUIRE(std::equal(pageTexel(1, VIRTUAL_PAGE_BORDER, VIRTUAL_PAGE_BORDER),
+                     pageTexel(1, VIRTUAL_PAGE_BORDER, VIRTUAL_PAGE_BORDER) +
+                         4,
+                     sourceTexel(128, 0)));
+  // Borders come from the neighbours, or repeat the edge of the level.
+  REQUIRE(std::equal(pageTexel(1, 0, VIRTUAL_PAGE_BORDER),
+                     pageTexel(1, 0, VIRTUAL_PAGE_BORDER) + 4,
+                     sourceTexel(124, 0)));
+  REQUIRE(std::equal(pageTexel(1, 0, 0), pageTexel(1, 0, 0) + 4,
+                     sourceTexel(124, 0)));
+  REQUIRE(std::equal(pageTexel(5, VIRTUAL_PAGE_STRIDE - 1,
+                               VIRTUAL_PAGE_STRIDE - 1),
+                     pageTexel(5, VIRTUAL_PAGE_STRIDE - 1,
+                               VIRTUAL_PAGE_STRIDE - 1) +
+                         4,
+                     sourceTexel(width - 1, height - 1)));
+  // Coarser levels are the mip filter's.
+  std::vector<uint8_t> level1(150 * 100 * 4);
+  downsampleSrgba(pixels.data(), width, height, level1.data());
+  REQUIRE(std::equal(pageTexel(7, VIRTUAL_PAGE_BORDER, VIRTUAL_PAGE_BORDER),
+                     pageTexel(7, VIRTUAL_PAGE_BORDER, VIRTUAL_PAGE_BORDER) +
+                         4,
+                     level1.data() + 128 * 4));
+
+  // The loader hands pages out in request order, up to its limit at a time.
+  {
+    PageLoader loader(file, 2);
+    loader.request({8, 1, 5});
+    std::vector<LoadedPage> loaded;
+    for (int attempt{0}; attempt < 1000 && loaded.size() < 3; ++attempt) {
+      std::vector<LoadedPage> pages = loader.takeLoaded(2);
+      REQUIRE(pages.size() <= 2);
+      std::move(pages.begin(), pages.end(), std::back_inserter(loaded));
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(loaded.size() == 3);
+    const uint32_t expected[]{8, 1, 5};
+    for (size_t i{0}; i < loaded.size(); ++i) {
+      REQUIRE(loaded[i].page == expected[i]);
+      REQUIRE(loaded[i].data.size() == file.pageBytes());
+      REQUIRE(std::equal(loaded[i].data.begin(), loaded[i].data.end(),
+                         file.page(expected[i])));
+    }
+  }
+
+  file.close();
+  REQUIRE(VirtualTextureFile::write(path, source, pixels.data(), width,
+                                    height, VK_FORMAT_BC7_SRGB_BLOCK));
+  REQUIRE(file.open(path, source));
+  REQUIRE(file.format() == VK_FORMAT_BC7_SRGB_BLOCK);
+  REQUIRE(file.pageBytes() ==
+          (VIRTUAL_PAGE_STRIDE / 4) * (VIRTUAL_PAGE_STRIDE / 4) * 16);
+
+  file.close();
+  writeText(source, "jpg");
+  std::filesystem::last_write_time(
+      source,
+      std::filesystem::last_write_time(source) + std::chrono::seconds(5));
+  REQUIRE_FALSE(file.open(path, source));
+}
+
+TEST_CASE("Page cache maps requested pages and falls back to ancestors",
+          "[virtualtexture]") {
+  // Pages 0-5 are level 0 (3x2), 6-7 level 1 (2x1) and 8 the root.
+  PageCache cache(virtualLevels(300, 200), 3);
+  REQUIRE(cache.pageCount() == 9);
+  REQUIRE(cache.rootPage() == 8);
+  REQUIRE(cache.slot(8) == 0);
+  const uint32_t root = 0 | 2u << 16;
+  REQUIRE(cache.table() == std::vector<uint32_t>(9, root));
+
+  // Missing ancestors are loaded first, and nothing is requested twice.
+  REQUIRE(cache.request({4}, 1) == std::vector<uint32_t>{6, 4});
+  REQUIRE(cache.request({4}, 1).empty());
+  REQUIRE(cache.request({3, 4}, 2) == std::vector<uint32_t>{3});
+
+  REQUIRE(cache.map(6, 2) == 1);
+  REQUIRE(cache.map(4, 2) == 2);
+  std::vector<uint32_t> table = cache.table();
+  REQUIRE(table[4] == 2);
+  REQUIRE(table[0] == (1 | 1u << 16));
+  REQUIRE(table[3] == (1 | 1u << 16));
+  REQUIRE(table[5] == root);
+  REQUIRE(table[7] == root);
+
+  // Every slot was used by frame 2, so page 3 has to wait.
+  REQUIRE(cache.map(3, 2) == NO_PAGE_SLOT);
+
+  // Frame 3 only uses page 0, via page 6; page 4 is the oldest and goes.
+  REQUIRE(cache.request({0}, 3) == std::vector<uint32_t>{0});
+  REQUIRE(cache.map(0, 3) == 2);
+  REQUIRE(cache.slot(4) == NO_PAGE_SLOT);
+  table = cache.table();
+  REQUIRE(table[0] == 2);
+  REQUIRE(table[4] == (1 | 1u << 16));
+  REQUIRE(cache.request({3}, 4) == std::vector<uint32_t>{3});
+}
+
+TEST_CASE("Small meshes keep their vertices with 16-bit indices",
+          "[indices]") {
+  auto vertices = quadVertices();
+  const auto original = vertices;
+  const std::vector<uint32_t> indices{0, 1, 2, 2, 3, 0};
+  std::vector<uint16_t> indices16;
+  std::vector<MeshRange> ranges;
+  splitForUint16(vertices, indices, indices16, ranges);
+  REQUIRE(vertices == original);
+  REQUIRE(indices16 == std::vector<uint16_t>{0, 1, 2, 2, 3, 0});
+  REQUIRE(ranges.size() == 1);
+  REQUIRE(ranges[0].indexCount == 6);
+}
+
+TEST_CASE("16-bit ranges start at the requested indices", "[indices]") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  shuffledGrid(8, vertices, indices);
+  const std::vector<uint32_t> rangeStarts{0, 30, 99};
+
+  for (size_t maxVertices : {size_t{100}, size_t{40}}) {
+    auto split = vertices;
+    std::vector<uint16_t> indices16;
+    std::vector<MeshRange> ranges;
+    splitForUint16(split, indices, indices16, ranges, maxVertices,
+                   rangeStarts);
+    REQUIRE(ranges.size() >= rangeStarts.size());
+    for (uint32_t start : rangeStarts) {
+      REQUIRE(std::any_of(ranges.begin(), ranges.end(),
+                          [start](const MeshRange& range) {
+                            return range.firstIndex == start;
+                          }));
+    }
+  }
+}
+
+TEST_CASE("Large meshes are split into 16-bit ranges", "[indices]") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  shuffledGrid(32, vertices, indices);
+  const auto expected = canonicalTriangles(vertices, indices);
+
+  constexpr size_t maxVertices = 100;
+  std::vector<uint16_t> indices16;
+  std::vector<MeshRange> ranges;
+  splitForUint16(vertices, indices, indices16, ranges, maxVertices);
+  REQUIRE(ranges.size() > 1);
+  REQUIRE(indices16.size() == indices.size());
+
+  // Resolve every range back to global indices into the new vertices.
+  std::vector<uint32_t> resolved;
+  uint32_t nextIndex{0};
+  for (const MeshRange& range : ranges) {
+    REQUIRE(range.firstIndex == nextIndex);
+    nextIndex += range.indexCount;
+    uint16_t maxLocal{0};
+    for (uint32_t i{range.firstIndex}; i < nextIndex; ++i) {
+      maxLocal = std::max(maxLocal, indices16[i]);
+      resolved.push_back(static_cast<uint32_t>(range.vertexOffset) +
+                         indices16[i]);
+    }
+    REQUIRE(maxLocal < maxVertices);
+  }
+  REQUIRE(nextIndex == indices16.size());
+  REQUIRE(canonicalTriangles(vertices, resolved) == expected);
+}
+
+TEST_CASE("Meshlets cover the mesh within limits and cull conservatively",
+          "[meshlet]") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  weldVertices(parseObj(std::string(MODELS_DIR) + "/viking_room.obj"),
+               vertices, indices);
+  optimizeMesh(vertices, indices);
+  std::vector<uint16_t> indices16;
+  std::vector<MeshRange> ranges;
+  splitForUint16(vertices, indices, indices16, ranges);
+  const std::vector<uint16_t> unordered = indices16;
+
+  const auto meshlets = buildMeshlets(vertices, indices16, ranges);
+  const auto resolve = [&](const std::vector<uint16_t>& local) {
+    std::vector<uint32_t> resolved;
+    for (const MeshRange& range : ranges) {
+      const uint32_t end = range.firstIndex + range.indexCount;
+      for (uint32_t i{range.firstIndex}; i < end; ++i) {
+        resolved.push_back(static_cast<uint32_t>(range.vertexOffset) +
+                           local[i]);
+      }
+    }
+    return resolved;
+  };
+  REQUIRE(canonicalTriangles(vertices, resolve(indices16)) ==
+          canonicalTriangles(vertices, resolve(unordered)));
+
+  const std::vector<glm::vec3> viewers{{3.0f, 0.0f, 0.0f},
+                                       {-3.0f, 0.5f, 0.2f},
+                                       {0.0f, 0.0f, 3.0f},
+                                       {0.3f, -2.0f, -2.0f}};
+  uint32_t nextIndex{0};
+  size_t culled{0};
+  for (const Meshlet& meshlet : meshlets) {
+    REQUIRE(meshlet.firstIndex == nextIndex);
+    nextIndex += meshlet.indexCount;
+    REQUIRE(meshlet.indexCount / 3 <= MESHLET_MAX_TRIANGLES);
+
+    std::vector<glm::vec3> positions;
+    for (uint32_t i{meshlet.firstIndex}; i < nextIndex; ++i) {
+      positions.push_back(
+          vertices[static_cast<uint32_t>(meshlet.vertexOffset) + indices16[i]]
+              .pos);
+    }
+    auto unique = positions;
+    std::sort(unique.begin(), unique.end(),
+              [](const glm::vec3& a, const glm::vec3& b) {
+                return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z);
+              });
+    unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+    REQUIRE(unique.size() <= MESHLET_MAX_VERTICES);
+
+    const glm::vec3 center(meshlet.sphere.x, meshlet.sphere.y,
+                           meshlet.sphere.z);
+    for (const glm::vec3& position : positions) {
+      REQUIRE(glm::length(position - center) <= meshlet.sphere.w * 1.0001f);
+    }
+
+    // Whenever the cone culls, every triangle must face away.
+    const glm::vec3 apex(meshlet.coneApex.x, meshlet.coneApex.y,
+                         meshlet.coneApex.z);
+    const glm::vec3 axis(meshlet.coneAxis.x, meshlet.coneAxis.y,
+                         meshlet.coneAxis.z);
+    for (const glm::vec3& viewer : viewers) {
+      if (glm::dot(glm::normalize(apex - viewer), axis) < meshlet.coneAxis.w) {
+        continue;
+      }
+      ++culled;
+      for (size_t t{0}; t < positions.size(); t += 3) {
+        const glm::vec3 normal = glm::cross(positions[t + 1] - positions[t],
+                                            positions[t + 2] - positions[t]);
+        REQUIRE(glm::dot(normal, positions[t] - viewer) >= -1e-6f);
+      }
+    }
+  }
+  REQUIRE(nextIndex == indices16.size());
+  REQUIRE(culled > 0);
+}
+
+TEST_CASE("Simplification keeps a flat grid flat and its outline intact",
+          "[simplify]") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  shuffledGrid(16, vertices, indices);
+
+  float error{-1.0f};
+  const auto simplified =
+      simplifyMesh(vertices, indices, indices.size() / 4, &error);
+  REQUIRE(simplified.size() % 3 == 0);
+  REQUIRE(simplified.size() <= indices.size() / 4);
+  REQUIRE(error < 1e-3f);
+
+  float area{0.0f};
+  for (size_t t{0}; t < simplified.size(); t += 3) {
+    const glm::vec3& p0 = vertices[simplified[t]].pos;
+    const glm::vec3 normal =
+        glm::cross(vertices[simplified[t + 1]].pos - p0,
+                   vertices[simplified[t + 2]].pos - p0);
+    REQUIRE(normal.z > 0.0f);
+    area += normal.z * 0.5f;
+  }
+  REQUIRE(area == Approx(16.0f * 16.0f));
+}
+
+TEST_CASE("Levels of detail shrink with growing error", "[simplify]") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  weldVertices(parseObj(std::string(MODELS_DIR) + "/viking_room.obj"),
+               vertices, indices);
+  optimizeMesh(vertices, indices);
+
+  const auto chain = buildLodChain(vertices, indices);
+  REQUIRE(chain.size() >= 3);
+  REQUIRE(chain.size() <= MAX_MESH_LODS);
+  REQUIRE(chain[0].indices == indices);
+  REQUIRE(chain[0].error == 0.0f);
+  for (size_t lod{1}; lod < chain.size(); ++lod) {
+    REQUIRE(chain[lod].indices.size() <
+            chain[lod - 1].indices.size() * MIN_LOD_REDUCTION);
+    REQUIRE(chain[lod].error >= chain[lod - 1].error);
+    for (uint32_t index : chain[lod].indices) {
+      REQUIRE(index < vertices.size());
+    }
+  }
+
+  std::vector<MeshLod> lods(chain.size());
+  for (size_t lod{0}; lod < chain.size(); ++lod) {
+    lods[lod].error = chain[lod].error;
+  }
+  const auto count = static_cast<uint32_t>(lods.size());
+  REQUIRE(selectLod(lods.data(), count, 1.0f, 1e6f) == 0);
+  REQUIRE(selectLod(lods.data(), count, 1e6f, 1.0f) == count - 1);
+  const float between = (lods[1].error + lods[2].error) * 0.5f;
+  REQUIRE(selectLod(lods.data(), count, 1.0f, 1.0f / between) == 1);
+}
+
+TEST_CASE("Scene parts share buffers and keep their transforms", "[scene]") {
+  std::vector<Vertex> gridVertices;
+  std::vector<uint32_t> gridIndices;
+  shuffledGrid(8, gridVertices, gridIndices);
+  std::vector<ImportedPart> imported(2);
+  for (uint32_t index : gridIndices) {
+    imported[0].corners.push_back(gridVertices[index]);
+  }
+  imported[1].corners = imported[0].corners;
+  imported[1].transform[3] = glm::vec4(20.0f, 0.0f, 0.0f, 1.0f);
+  imported[1].material = 2;
+
+  SceneGeometry scene = buildScene(imported);
+  REQUIRE(scene.parts.size() == 2);
+  REQUIRE(scene.parts[1].transform == imported[1].transform);
+  REQUIRE(scene.parts[1].material == 2);
+  REQUIRE(scene.bounds.max.x == 8.0f);
+  REQUIRE(scene.sceneBounds.max.x == 28.0f);
+
+  // The finest level draws exactly the input, moved into place by the parts.
+  std::vector<Vertex> expected;
+  for (const ImportedPart& part : imported) {
+    for (Vertex corner : part.corners) {
+      corner.pos = glm::vec3(part.transform * glm::vec4(corner.pos, 1.0f));
+      expected.push_back(corner);
+    }
+  }
+  const MeshView mesh = scene.view();
+  const MeshLod finest = mesh.lod(0);
+  std::vector<Vertex> drawn;
+  for (uint32_t r{finest.firstRange}; r < finest.firstRange + finest.rangeCount;
+       ++r) {
+    const MeshRange& range = mesh.ranges[r];
+    REQUIRE(range.part < 2);
+    for (uint32_t i{range.firstIndex}; i < range.firstIndex + range.indexCount;
+         ++i) {
+      Vertex corner = mesh.vertices[static_cast<uint32_t>(range.vertexOffset) +
+                                    mesh.index(i)];
+      corner.pos = glm::vec3(mesh.parts[range.part].transform *
+                             glm::vec4(corner.pos, 1.0f));
+      drawn.push_back(corner);
+    }
+  }
+  std::vector<uint32_t> identity(expected.size());
+  std::iota(identity.begin(), identity.end(), 0u);
+  REQUIRE(drawn.size() == expected.size());
+  REQUIRE(canonicalTriangles(drawn, identity) ==
+          canonicalTriangles(expected, identity));
+
+  for (uint32_t lod{0}; lod < mesh.lodCount; ++lod) {
+    std::array<bool, 2> hasPart{};
+    for (uint32_t r{0}; r < mesh.lods[lod].rangeCount; ++r) {
+      hasPart[mesh.ranges[mesh.lods[lod].firstRange + r].part] = true;
+    }
+    REQUIRE(hasPart[0]);
+    REQUIRE(hasPart[1]);
+  }
+  for (const Meshlet& meshlet : scene.meshlets) {
+    // Culling data is in scene space.
+    REQUIRE((meshlet.sphere.x > 10.0f) == (meshlet.part == 1));
+  }
+
+  // Drawing needs neither the vertices nor the indices once uploaded.
+  scene.releaseGeometry();
+  REQUIRE(scene.vertices.capacity() == 0);
+  REQUIRE(scene.indices.capacity() == 0);
+  REQUIRE(scene.meshlets.capacity() == 0);
+  REQUIRE(scene.lods.size() == mesh.lodCount);
+  REQUIRE(scene.ranges.size() == mesh.rangeCount);
+}
+
+TEST_CASE("Tasks run after their dependencies", "[tasks]") {
+  TaskGraph tasks;
+  std::atomic<int> step{0};
+  std::array<int, 4> order{};
+  const auto record = [&](size_t task) {
+    return [&order, &step, task]() { order[task] = ++step; };
+  };
+  const auto a = tasks.add("a", record(0));
+  const auto b = tasks.add("b", record(1));
+  const auto c = tasks.add("c", record(2), {a, b});
+  const std::thread::id caller = std::this_thread::get_id();
+  std::thread::id ranOn;
+  const auto d = tasks.add(
+      "d",
+      [&]() {
+        record(3)();
+        ranOn = std::this_thread::get_id();
+      },
+      {c}, true);
+  REQUIRE_THROWS(tasks.add("e", []() {}, {d + 1}));
+
+  tasks.run(4);
+  REQUIRE(order[2] > order[0]);
+  REQUIRE(order[2] > order[1]);
+  REQUIRE(order[3] == 4);
+  REQUIRE(ranOn == caller);
+  REQUIRE(tasks.timing(d).start >= tasks.timing(c).end);
+
+  const auto path = tasks.criticalPath();
+  REQUIRE(path.size() == 3);
+  REQUIRE((path[0] == a || path[0] == b));
+  REQUIRE(path[1] == c);
+  REQUIRE(path[2] == d);
+}
+
+TEST_CASE("A failing task stops its dependents", "[tasks]") {
+  TaskGraph tasks;
+  bool dependentRan{false};
+  const auto failing =
+      tasks.add("failing", []() { throw std::runtime_error("failed!"); });
+  tasks.add("dependent", [&]() { dependentRan = true; }, {failing});
+  REQUIRE_THROWS_AS(tasks.run(2), std::runtime_error);
+  REQUIRE_FALSE(dependentRan);
+}
+
+TEST_CASE("Written and replaced files are reported once", "[reload]") {
+  const auto directory =
+      std::filesystem::temp_directory_path() / "filewatcher_test";
+  std::filesystem::create_directories(directory);
+  const std::string watched = (directory / "watched.obj").string();
+  const std::string other = (directory / "other.obj").string();
+  writeText(watched, "v 0 0 0\n");
+  writeText(other, "v 0 0 0\n");
+
+  FileWatcher watcher;
+  REQUIRE(watcher.add(watched));
+  REQUIRE(watcher.poll().empty());
+
+  // The explicit mtime keeps the polling fallback independent of the file
+  // system's timestamp resolution.
+  const auto touch = [](const std::string& path) {
+    std::filesystem::last_write_time(
+        path, std::filesystem::last_write_time(path) +
+                  std::chrono::seconds(5));
+  };
+  writeText(watched, "v 1 0 0\n");
+  writeText(watched, "v 2 0 0\n");
+  touch(watched);
+  writeText(other, "v 1 0 0\n");
+  touch(other);
+  REQUIRE(watcher.poll() == std::vector<std::string>{watched});
+  REQUIRE(watcher.poll().empty());
+
+  // Editors that save atomically rename a new file over the old one.
+  const std::string saved = (directory / "watched.obj.new").string();
+  writeText(saved, "v 3 0 0 0\n");
+  std::filesystem::rename(saved, watched);
+  touch(watched);
+  REQUIRE(watcher.poll() == std::vector<std::string>{watched});
+}
+
+TEST_CASE("Retired objects outlive the frames that used them", "[reload]") {
+  ReleaseQueue queue;
+  std::vector<int> released;
+  queue.retire(3, [&]() { released.push_back(1); });
+  queue.retire(3, [&]() { released.push_back(2); });
+  queue.retire(5, [&]() {
+    released.push_back(3);
+    queue.retire(9, [&]() { released.push_back(4); });
+  });
+
+  queue.collect(2);
+  REQUIRE(released.empty());
+  queue.collect(3);
+  REQUIRE(released == std::vector<int>{1, 2});
+  queue.collect(6);
+  REQUIRE(released == std::vector<int>{1, 2, 3});
+  REQUIRE(queue.size() == 1);
+  queue.releaseAll();
+  REQUIRE(released == std::vector<int>{1, 2, 3, 4});
+  REQUIRE(queue.size() == 0);
+}
+
+TEST_CASE("Resident set size is reported", "[memory]") {
+  const MemoryUsage usage = queryMemoryUsage();
+  REQUIRE(usage.resident > 0);
+  REQUIRE(usage.peakResident > 0);
+}
+
+TEST_CASE("Asset pack entries are found by name", "[assetpack]") {
+  const std::string source = tempPath("assetpack_model.obj");
+  const std::string cache = source + ".meshcache";
+  const std::string pack = tempPath("assetpack_test.pack");
+  writeText(source, "v 0 0 0\n");
+  const auto vertices = quadVertices();
+  const std::vector<uint16_t> indices{0, 1, 2, 2, 3, 0};
+  MeshView mesh{};
+  mesh.vertices = vertices.data();
+  mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+  mesh.indices = indices.data();
+  mesh.indexCount = static_cast<uint32_t>(indices.size());
+  mesh.indexSize = sizeof(uint16_t);
+  REQUIRE(MeshCache::write(cache, source, mesh));
+
+  std::vector<AssetSource> sources(3);
+  sources[0].name = "models/model.obj.meshcache";
+  MappedFile cooked;
+  REQUIRE(cooked.open(cache));
+  sources[0].data.assign(cooked.data(), cooked.data() + cooked.size());
+  sources[1].name = "shaders/repetitive.spv";
+  sources[1].data.assign(100000, 7);
+  sources[1].compression = AssetCompression::Zstd;
+  sources[2].name = "empty.txt";
+  REQUIRE(AssetPack::write(pack, sources));
+  REQUIRE(std::filesystem::file_size(pack) < 4 * ASSET_PACK_ALIGNMENT);
+
+  AssetPack assets;
+  REQUIRE(assets.open(pack));
+  REQUIRE(assets.find("missing.spv") == nullptr);
+  std::vector<uint8_t> data;
+  REQUIRE_FALSE(assets.read("missing.spv", data));
+
+  // Uncompressed entries are used in place, page aligned.
+  const AssetData model = assets.view(sources[0].name);
+  REQUIRE(model.size == sources[0].data.size());
+  REQUIRE(reinterpret_cast<uintptr_t>(model.data) % ASSET_PACK_ALIGNMENT == 0);
+  MeshCache meshCache;
+  REQUIRE(meshCache.open(model.data, model.size));
+  REQUIRE(meshCache.view().vertexCount == vertices.size());
+  REQUIRE(meshCache.view().index(5) == 0);
+  meshCache.close();
+
+  REQUIRE(assets.view(sources[1].name).data == nullptr);
+  REQUIRE(assets.read(sources[1].name, data));
+  REQUIRE(data == sources[1].data);
+  REQUIRE(assets.read(sources[2].name, data));
+  REQUIRE(data.empty());
+  assets.close();
+
+  SECTION("a truncated pack is rejected") {
+    std::filesystem::resize_file(pack, ASSET_PACK_ALIGNMENT + 100);
+    REQUIRE_FALSE(assets.open(pack));
+  }
+  SECTION("names must not collide") {
+    sources[2].name = sources[1].name;
+    REQUIRE_FALSE(AssetPack::write(pack, sources));
+  }
+}